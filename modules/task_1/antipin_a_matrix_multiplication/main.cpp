@@ -255,6 +255,64 @@ TEST(Matrix_multiplication, can_multiply_same_as_usial_matrix) {
     EXPECT_NEAR(mat3.getElem(94, 4), mat_3[94 * 100 + 4], 0.000001);
 }
 
+TEST(Matrix_multiplication, dense_and_sparse_accumulators_are_bit_identical) {
+    const uint16_t coeffs[] = { 6, 20, 200 };
+    for (const uint16_t coeff : coeffs) {
+        SparseMatrix<CCS> mat1(60, coeff);
+        SparseMatrix<CCS> mat2(60, coeff);
+        SparseMatrix<CCS> dense, sparse, hybrid;
+        getSequentialMatrixMultiplication(mat1, mat2, &dense, 0.0);
+        getSequentialMatrixMultiplication(mat1, mat2, &sparse, 100.0);
+        getSequentialMatrixMultiplication(mat1, mat2, &hybrid);
+        ASSERT_EQ(dense.getRealSize(), sparse.getRealSize());
+        ASSERT_EQ(dense.getRealSize(), hybrid.getRealSize());
+        for (size_t i = 0; i < 60; ++i) {
+            for (size_t j = 0; j < 60; ++j) {
+                EXPECT_EQ(dense.getElem(i, j), sparse.getElem(i, j));
+                EXPECT_EQ(dense.getElem(i, j), hybrid.getElem(i, j));
+            }
+        }
+    }
+}
+
+TEST(Matrix_multiplication, can_multiply_same_as_usial_matrix_with_any_accumulator) {
+    std::vector<double> A = { 8.0, 5.0, 2.0, 4.0, 9.0, 1.0, 3.0 };
+    std::vector<size_t> LI = { 5, 2, 0, 5, 3, 3, 4 };
+    std::vector<size_t> LJ = { 0, 1, 2, 3, 4, 5, 7 };
+    SparseMatrix<CCS> mat;
+    mat.setMatrix(A, LI, LJ, 6);
+    std::vector<double> mat_1;
+    std::vector<double> mat_2;
+    constructMatrix(mat, &mat_1);
+    matrixMultiplication(mat_1, 6, mat_1, &mat_2);
+
+    const double fills[] = { 0.0, 0.2, 0.5, 10.0 };
+    for (const double fill : fills) {
+        SparseMatrix<CCS> res;
+        getSequentialMatrixMultiplication(mat, mat, &res, fill);
+        std::vector<double> res_1;
+        constructMatrix(res, &res_1);
+        EXPECT_EQ(mat_2, res_1);
+    }
+}
+
+/*TEST(Matrix_multiplication, can_find_dense_accumulator_threshold) {
+    const size_t n = 3000;
+    const uint16_t coeffs[] = { 1000, 550, 300, 170, 100, 55, 30 };
+    for (const uint16_t coeff : coeffs) {
+        SparseMatrix<CCS> mat(n, coeff);
+        SparseMatrix<CCS> res;
+        double fill = static_cast<double>(mat.getRealSize()) * mat.getRealSize() / n / n / n;
+        clock_t time = clock();
+        getSequentialMatrixMultiplication(mat, mat, &res, 0.0);
+        double dense = static_cast<double>(clock() - time) / CLOCKS_PER_SEC;
+        time = clock();
+        getSequentialMatrixMultiplication(mat, mat, &res, n + 1.0);
+        double sparse = static_cast<double>(clock() - time) / CLOCKS_PER_SEC;
+        printf("products per column / n = %f: dense %f sparse %f\n", fill, dense, sparse);
+    }
+}*/
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
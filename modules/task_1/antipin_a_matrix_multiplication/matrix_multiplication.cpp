@@ -101,45 +101,61 @@ void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B) {
     }
 }
 
-void getSequentialMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C) {
+void getSequentialMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const double denseFill) {
     if (A.getMatrixSize() != B.getMatrixSize()) {
         throw("Matrices have a different range");
     }
-
-    SparseMatrix<CRS> tmp;
-    convertMatrix(A, &tmp);
-
-    C->A.resize(A.getMatrixSize() * B.getMatrixSize());
-    C->LI.resize(A.getMatrixSize() * B.getMatrixSize());
-    C->LJ.resize(A.getMatrixSize() + 1);
-
-    size_t iterator = 0;
-    size_t lj = 0;
-    for (size_t n = 0; n < A.getMatrixSize(); ++n) {
-        size_t li = 0;
-        for (size_t i = 0; i < tmp.getMatrixSize(); ++i) {
-            double elem = 0.0;
-            bool isRow = (tmp.LI[i + 1] - tmp.LI[i]) < (B.LJ[lj + 1] - B.LJ[lj]) ? true : false;
-            if (!isRow) {
-                for (size_t j = B.LJ[lj]; j < B.LJ[lj + 1]; ++j) {
-                    elem += isZero(tmp.getElem(i, B.LI[j]) * B.A[j]);
+    const size_t n = A.getMatrixSize();
+    C->n = n;
+    C->A.clear();
+    C->LI.clear();
+    C->LJ.assign(n + 1, 0);
+
+    std::vector<double> acc(n, 0.0);
+    std::vector<size_t> mark(n, n);
+    std::vector<size_t> touched;
+    for (size_t j = 0; j < n; ++j) {
+        size_t products = 0;
+        for (size_t t = B.LJ[j]; t < B.LJ[j + 1]; ++t) {
+            products += A.LJ[B.LI[t] + 1] - A.LJ[B.LI[t]];
+        }
+        if (products >= denseFill * n) {
+            for (size_t t = B.LJ[j]; t < B.LJ[j + 1]; ++t) {
+                const size_t k = B.LI[t];
+                for (size_t u = A.LJ[k]; u < A.LJ[k + 1]; ++u) {
+                    acc[A.LI[u]] += isZero(A.A[u] * B.A[t]);
                 }
-            } else {
-                for (size_t j = tmp.LI[i]; j < tmp.LI[i + 1]; ++j) {
-                    elem += isZero(tmp.A[j] * B.getElem(tmp.LJ[j], n));
+            }
+            for (size_t i = 0; i < n; ++i) {
+                if (acc[i] != 0.0) {
+                    C->A.push_back(acc[i]);
+                    C->LI.push_back(i);
+                    acc[i] = 0.0;
                 }
             }
-            if (elem != 0.0) {
-                C->A[iterator] = elem;
-                C->LI[iterator] = li;
-                ++iterator;
+        } else {
+            touched.clear();
+            for (size_t t = B.LJ[j]; t < B.LJ[j + 1]; ++t) {
+                const size_t k = B.LI[t];
+                for (size_t u = A.LJ[k]; u < A.LJ[k + 1]; ++u) {
+                    const size_t i = A.LI[u];
+                    if (mark[i] != j) {
+                        mark[i] = j;
+                        touched.push_back(i);
+                    }
+                    acc[i] += isZero(A.A[u] * B.A[t]);
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            for (const size_t i : touched) {
+                if (acc[i] != 0.0) {
+                    C->A.push_back(acc[i]);
+                    C->LI.push_back(i);
+                }
+                acc[i] = 0.0;
             }
-            ++li;
         }
-        C->LJ[n + 1] = iterator;
-        ++lj;
+        C->LJ[j + 1] = C->A.size();
     }
-
-    C->A.resize(iterator);
-    C->LI.resize(iterator);
 }
@@ -29,7 +29,7 @@ class SparseMatrix {
     friend void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B);
     friend void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B);
     friend void getSequentialMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B,
-        SparseMatrix<CCS>* C);
+        SparseMatrix<CCS>* C, const double denseFill);
  private:
     std::vector<double> A;
     std::vector<size_t> LI;
@@ -258,6 +258,17 @@ void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B);
 
 void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B);
 
-void getSequentialMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C);
+// Every column of C is accumulated from the columns of A picked by the
+// column of B. A column that is expected to get at least denseFill * n
+// products goes to a dense accumulator that is scanned whole; sparser
+// columns keep a list of the touched rows and sort it. Both accumulators
+// add the same products in the same order, so the threshold only changes
+// the speed: 0 makes every column dense, a value above the size of A makes
+// every column sparse. The default is measured by the commented out
+// can_find_dense_accumulator_threshold test.
+const double kDenseFill = 0.08;
+
+void getSequentialMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const double denseFill = kDenseFill);
 
 #endif  // MODULES_TASK_1_ANTIPIN_A_MATRIX_MULTIPLICATION_MATRIX_MULTIPLICATION_H_
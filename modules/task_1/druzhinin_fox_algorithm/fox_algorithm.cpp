@@ -22,39 +22,3 @@ bool comparisonMatrixes(const double* a, const double* b, const int size) {  //
     }
     return true;
 }
-
-void defaultMatrixMult(const double* a, const double* b, const int size, double* res) {  // default multiplication
-    double tmp;
-    for (int i = 0; i < size; i++) {
-        for (int j = 0; j < size; j++) {
-            tmp = 0;
-            for (int k = 0; k < size; k++) {
-                tmp += a[i * size + k] * b[k * size + j];
-            }
-            res[i * size + j] = tmp;
-        }
-    }
-}
-
-
-void blockMatrixMult(const double* a, const double* b, const int size, double* res) {  // blocked matrix multiplication
-    int block_size = std::sqrt(size);
-    for (int i = 0; i < size * size; i++)
-        res[i] = 0;
-    double tmp;
-    for (int i = 0; i < size; i += block_size) {  // ijk cycle by blocks
-        for (int j = 0; j < size; j += block_size) {
-            for (int k = 0; k < size; k += block_size) {
-                for (int ii = i; ii < std::min(size, i + block_size); ii++) {  // ijk cycle by elements
-                    for (int jj = j; jj < std::min(size, j + block_size); jj++) {
-                        tmp = 0;
-                        for (int kk = k; kk < std::min(size, k + block_size); kk++) {
-                            tmp += a[ii * size + kk] * b[kk * size + jj];
-                        }
-                        res[ii * size + jj] += tmp;
-                    }
-                }
-            }
-        }
-    }
-}
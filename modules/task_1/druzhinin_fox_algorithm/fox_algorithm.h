@@ -2,10 +2,90 @@
 #ifndef MODULES_TASK_1_DRUZHININ_FOX_ALGORITHM_FOX_ALGORITHM_H_
 #define MODULES_TASK_1_DRUZHININ_FOX_ALGORITHM_FOX_ALGORITHM_H_
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 void fillMatrix(double*, const int);
 bool comparisonMatrixes(const double*, const double*, const int);
-void defaultMatrixMult(const double*, const double*, const int, double*);
-void blockMatrixMult(const double*, const double*, const int, double*);
 
+// Accumulation modes of the multipliers: Plain sums products as they come,
+// Compensated keeps a Kahan correction term for every element of the result
+enum class Summation { Plain, Compensated };
+
+// The multipliers are templated on the element type T and the accumulator
+// type Acc, so float matrices can be summed in float (twice the SIMD lanes
+// of double) or in double (float storage, double accuracy)
+
+template <typename Acc>
+inline void accumulate(Acc* sum, Acc* err, const Acc value, const Summation mode) {
+    if (mode == Summation::Plain) {
+        *sum += value;
+        return;
+    }
+    Acc y = value - *err;
+    Acc t = *sum + y;
+    *err = (t - *sum) - y;
+    *sum = t;
+}
+
+template <typename T, typename Acc = T>
+void defaultMatrixMult(const T* a, const T* b, const int size, T* res,
+                       const Summation mode = Summation::Plain) {  // default multiplication
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            Acc tmp = 0, err = 0;
+            for (int k = 0; k < size; k++) {
+                accumulate<Acc>(&tmp, &err, static_cast<Acc>(a[i * size + k]) * static_cast<Acc>(b[k * size + j]),
+                                mode);
+            }
+            res[i * size + j] = static_cast<T>(tmp);
+        }
+    }
+}
+
+template <typename T, typename Acc = T>
+void blockMatrixMult(const T* a, const T* b, const int size, T* res,
+                     const Summation mode = Summation::Plain) {  // blocked matrix multiplication
+    int block_size = std::max(1, static_cast<int>(std::sqrt(size)));
+    std::vector<Acc> sum(size * size, 0);
+    std::vector<Acc> err(mode == Summation::Compensated ? size * size : 0, 0);
+    for (int i = 0; i < size; i += block_size) {  // ikj cycle by blocks
+        for (int k = 0; k < size; k += block_size) {
+            for (int j = 0; j < size; j += block_size) {
+                int j_end = std::min(size, j + block_size);
+                for (int ii = i; ii < std::min(size, i + block_size); ii++) {  // ikj cycle by elements
+                    Acc* sum_row = &sum[ii * size];
+                    for (int kk = k; kk < std::min(size, k + block_size); kk++) {
+                        const Acc aik = static_cast<Acc>(a[ii * size + kk]);
+                        const T* b_row = b + kk * size;
+                        if (mode == Summation::Plain) {  // unit stride, vectorized
+                            for (int jj = j; jj < j_end; jj++)
+                                sum_row[jj] += aik * static_cast<Acc>(b_row[jj]);
+                        } else {
+                            Acc* err_row = &err[ii * size];
+                            for (int jj = j; jj < j_end; jj++)
+                                accumulate<Acc>(&sum_row[jj], &err_row[jj], aik * static_cast<Acc>(b_row[jj]), mode);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    for (int i = 0; i < size * size; i++)
+        res[i] = static_cast<T>(sum[i]);
+}
+
+// Largest elementwise error of res against a double reference, relative to
+// the largest magnitude in the reference
+template <typename T>
+double relativeError(const T* res, const double* reference, const int size) {
+    double max_diff = 0, max_ref = 0;
+    for (int i = 0; i < size * size; i++) {
+        max_diff = std::max(max_diff, std::fabs(static_cast<double>(res[i]) - reference[i]));
+        max_ref = std::max(max_ref, std::fabs(reference[i]));
+    }
+    return max_ref > 0 ? max_diff / max_ref : max_diff;
+}
 
 #endif  // MODULES_TASK_1_DRUZHININ_FOX_ALGORITHM_FOX_ALGORITHM_H_
@@ -1,6 +1,10 @@
 // Copyright 2020 Druzhinin Alexei
 
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <ctime>
+#include <iostream>
+#include <vector>
 #include "../../../modules/task_1/druzhinin_fox_algorithm/fox_algorithm.h"
 
 TEST(Fox_Algorithm, Comparison_Equal_Matrixes_Correct) {
@@ -95,6 +99,97 @@ TEST(Fox_Algorithm, Blocked_and_Default_Matrix_Multiplication_Give_Identical_Res
     ASSERT_EQ(result, true);
 }
 
+TEST(Fox_Algorithm, Float_Blocked_Matrix_Multiplication_Close_To_Double) {
+    // Arrange
+    const int size = 64;
+    std::vector<double> a(size * size), b(size * size), res(size * size);
+    std::vector<float> af(size * size), bf(size * size), resf(size * size);
+
+    // Act
+    fillMatrix(a.data(), size);
+    fillMatrix(b.data(), size);
+    std::copy(a.begin(), a.end(), af.begin());
+    std::copy(b.begin(), b.end(), bf.begin());
+    blockMatrixMult(a.data(), b.data(), size, res.data());
+    blockMatrixMult(af.data(), bf.data(), size, resf.data());
+
+    // Assert
+    ASSERT_LT(relativeError(resf.data(), res.data(), size), 1e-5);
+}
+
+TEST(Fox_Algorithm, Double_Accumulator_Improves_Float_Result) {
+    // Arrange
+    const int size = 128;
+    std::vector<double> a(size * size), b(size * size), reference(size * size);
+    std::vector<float> af(size * size), bf(size * size);
+    std::vector<float> res_float(size * size), res_mixed(size * size);
+
+    // Act
+    fillMatrix(a.data(), size);
+    fillMatrix(b.data(), size);
+    std::copy(a.begin(), a.end(), af.begin());
+    std::copy(b.begin(), b.end(), bf.begin());
+    std::copy(af.begin(), af.end(), a.begin());  // reference sees the same rounded inputs
+    std::copy(bf.begin(), bf.end(), b.begin());
+    defaultMatrixMult(a.data(), b.data(), size, reference.data());
+    blockMatrixMult(af.data(), bf.data(), size, res_float.data());
+    blockMatrixMult<float, double>(af.data(), bf.data(), size, res_mixed.data());
+
+    // Assert
+    double float_error = relativeError(res_float.data(), reference.data(), size);
+    double mixed_error = relativeError(res_mixed.data(), reference.data(), size);
+    ASSERT_LE(mixed_error, float_error);
+    ASSERT_LT(mixed_error, 1e-7);
+}
+
+TEST(Fox_Algorithm, Compensated_Multiplication_Keeps_Small_Terms) {
+    // Arrange
+    const int size = 200;
+    std::vector<double> a(size * size, 0.0), b(size * size, 0.0);
+    std::vector<double> plain(size * size), def_res(size * size), block_res(size * size);
+    for (int k = 0; k < size; k++) {
+        a[k] = 1.0;
+        b[k * size] = k == 0 ? 1.0 : 1e-16;
+    }
+    const double expected = 1.0 + (size - 1) * 1e-16;
+
+    // Act
+    blockMatrixMult(a.data(), b.data(), size, plain.data());
+    defaultMatrixMult(a.data(), b.data(), size, def_res.data(), Summation::Compensated);
+    blockMatrixMult(a.data(), b.data(), size, block_res.data(), Summation::Compensated);
+
+    // Assert
+    ASSERT_EQ(plain[0], 1.0);
+    ASSERT_NEAR(def_res[0], expected, 1e-16);
+    ASSERT_NEAR(block_res[0], expected, 1e-16);
+}
+
+template <typename T, typename Acc>
+void printModeStats(const char* name, const std::vector<double>& a, const std::vector<double>& b,
+                    const std::vector<double>& reference, const int size, const Summation mode) {
+    std::vector<T> at(a.begin(), a.end()), bt(b.begin(), b.end()), res(size * size);
+    clock_t start = clock();
+    blockMatrixMult<T, Acc>(at.data(), bt.data(), size, res.data(), mode);
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    std::cout << name << ": " << seconds << " s, error "
+              << relativeError(res.data(), reference.data(), size) << std::endl;
+}
+
+TEST(Fox_Algorithm, DISABLED_Precision_Modes_512) {
+    const int size = 512;
+    std::vector<double> a(size * size), b(size * size);
+    std::vector<double> reference(size * size);
+    fillMatrix(a.data(), size);
+    fillMatrix(b.data(), size);
+    defaultMatrixMult<double, long double>(a.data(), b.data(), size, reference.data(), Summation::Compensated);
+
+    printModeStats<double, double>("double", a, b, reference, size, Summation::Plain);
+    printModeStats<double, double>("double compensated", a, b, reference, size, Summation::Compensated);
+    printModeStats<float, float>("float", a, b, reference, size, Summation::Plain);
+    printModeStats<float, double>("float, double accumulator", a, b, reference, size, Summation::Plain);
+    printModeStats<float, float>("float compensated", a, b, reference, size, Summation::Compensated);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -3,6 +3,9 @@
 #include <string>
 #include <ctime>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <utility>
 #include "../../../modules/task_1/gaydaychuk_bitwise_oddeven_sort/bitwise_oddeven_sort.h"
 
 bool checkAscending(std::vector<int> vec) {
@@ -40,7 +43,87 @@ void sortByDigit(std::vector<int> *vec, int digit) {
 }
 
 void bitwiseSort(std::vector<int> *vec) {
-    int max = getMax(vec);
-    for (int digit = 1; max / digit > 0; digit *= 10)
-        sortByDigit(vec, digit);
+    bitwiseSortBits(vec, getDigitBits(vec->size()));
+}
+
+int getDigitBits(int size) {
+    if (size < (1 << 16)) {
+        return 8;
+    }
+    return size < (1 << 23) ? 11 : 16;
+}
+
+// Large inputs are scattered through a buffer of one cache line per bucket
+// that is flushed to the output a whole line at a time
+const int kLineKeys = 16;
+const int kLineMinSize = 1 << 20;
+
+static void scatterByDigit(const uint32_t* src, uint32_t* dst, int n, int shift, int digitBits,
+                           std::vector<int> *offset, std::vector<uint32_t> *lines) {
+    const uint32_t mask = (1u << digitBits) - 1;
+    int* pos = offset->data();
+    if (lines->empty()) {
+        for (int i = 0; i < n; i++) {
+            dst[pos[(src[i] >> shift) & mask]++] = src[i];
+        }
+        return;
+    }
+    uint32_t* line = lines->data();
+    std::vector<int> fill(mask + 1, 0);
+    for (int i = 0; i < n; i++) {
+        uint32_t digit = (src[i] >> shift) & mask;
+        line[digit * kLineKeys + fill[digit]++] = src[i];
+        if (fill[digit] == kLineKeys) {
+            memcpy(dst + pos[digit], line + digit * kLineKeys, sizeof(uint32_t) * kLineKeys);
+            pos[digit] += kLineKeys;
+            fill[digit] = 0;
+        }
+    }
+    for (uint32_t digit = 0; digit <= mask; digit++) {
+        memcpy(dst + pos[digit], line + digit * kLineKeys, sizeof(uint32_t) * fill[digit]);
+    }
+}
+
+void bitwiseSortBits(std::vector<int> *vec, int digitBits) {
+    if (digitBits != 8 && digitBits != 11 && digitBits != 16) {
+        throw - 1;
+    }
+    int n = vec->size();
+    int* data = vec->data();
+    int passes = (32 + digitBits - 1) / digitBits;
+    int buckets = 1 << digitBits;
+    const uint32_t mask = buckets - 1;
+
+    // The sign bit is flipped so the keys are ordered as unsigned numbers;
+    // the counters of all digits are filled in one pass
+    std::vector<uint32_t> keys(n), tmp(n);
+    std::vector<int> count(passes * buckets, 0);
+    for (int i = 0; i < n; i++) {
+        uint32_t key = static_cast<uint32_t>(data[i]) ^ 0x80000000u;
+        keys[i] = key;
+        for (int p = 0; p < passes; p++) {
+            count[p * buckets + ((key >> (p * digitBits)) & mask)]++;
+        }
+    }
+
+    uint32_t* src = keys.data();
+    uint32_t* dst = tmp.data();
+    std::vector<int> offset(buckets);
+    std::vector<uint32_t> lines(n >= kLineMinSize && digitBits <= 11 ? buckets * kLineKeys : 0);
+    for (int p = 0; p < passes; p++) {
+        const int* digitCount = &count[p * buckets];
+        if (n == 0 || digitCount[(src[0] >> (p * digitBits)) & mask] == n) {
+            continue;  // the digit is the same for all keys
+        }
+        int sum = 0;
+        for (int b = 0; b < buckets; b++) {
+            offset[b] = sum;
+            sum += digitCount[b];
+        }
+        scatterByDigit(src, dst, n, p * digitBits, digitBits, &offset, &lines);
+        std::swap(src, dst);
+    }
+    for (int i = 0; i < n; i++) {
+        data[i] = static_cast<int>(src[i] ^ 0x80000000u);
+    }
 }
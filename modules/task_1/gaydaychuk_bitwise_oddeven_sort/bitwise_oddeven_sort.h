@@ -6,7 +6,14 @@
 
 bool checkAscending(std::vector<int> vec);
 int getMax(std::vector<int> *vec);
+// One stable pass by the decimal digit
 void sortByDigit(std::vector<int> *vec, int exp);
+// LSD radix sort by binary digits of getDigitBits(vec->size()) bits
 void bitwiseSort(std::vector<int> *vec);
+// Digit width for the input size: 8 bits while the counters stay in L1,
+// 11 bits (3 passes) for medium inputs, 16 bits (2 passes) for large ones
+int getDigitBits(int size);
+// digitBits is 8, 11 or 16; negative numbers are sorted as well
+void bitwiseSortBits(std::vector<int> *vec, int digitBits);
 
 #endif  // MODULES_TASK_1_GAYDAYCHUK_BITWISE_ODDEVEN_SORT_BITWISE_ODDEVEN_SORT_H_
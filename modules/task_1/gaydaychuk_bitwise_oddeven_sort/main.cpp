@@ -1,6 +1,8 @@
 // Copyright 2020 Gaydaychuk Yury
 #include <gtest/gtest.h>
 #include <vector>
+#include <algorithm>
+#include <random>
 #include "./bitwise_oddeven_sort.h"
 
 TEST(Sequential, Test_Sorted) {
@@ -31,6 +33,29 @@ TEST(Sequential, Test_ThirdSort) {
     ASSERT_EQ(true, checkAscending(vec));
 }
 
+TEST(Sequential, Test_NegativeSort) {
+    std::vector<int> vec = {-5, 3, 0, -2147483647 - 1, 2147483647, -1, 3};
+    bitwiseSort(&vec);
+    ASSERT_EQ(true, checkAscending(vec));
+}
+
+TEST(Sequential, Test_SortBits) {
+    std::mt19937 gen(3);
+    std::vector<int> vec((1 << 20) + 7);
+    for (size_t i = 0; i < vec.size(); i++) {
+        vec[i] = static_cast<int>(gen());
+    }
+    std::vector<int> expected = vec;
+    std::sort(expected.begin(), expected.end());
+    const int widths[] = {8, 11, 16};
+    for (int bits : widths) {
+        std::vector<int> res = vec;
+        bitwiseSortBits(&res, bits);
+        ASSERT_EQ(expected, res);
+    }
+    ASSERT_ANY_THROW(bitwiseSortBits(&vec, 4));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -48,7 +48,6 @@ Matrix foxMult(const Matrix& A, const Matrix& B, const int &blockSize) {
   return C;
 }
 
-
 Matrix randMatrix(const int& size) {
   if (size <= 0) {
     throw "Wrong size matrix";
@@ -64,3 +63,62 @@ Matrix randMatrix(const int& size) {
   }
   return matr;
 }
+
+DenseMatrix::DenseMatrix(const Matrix& M) : DenseMatrix(M.size(), M.empty() ? 0 : M[0].size()) {
+  for (size_t i = 0; i < rows_; i++) {
+    if (M[i].size() != cols_)
+      throw "Rows have different size";
+    std::copy(M[i].begin(), M[i].end(), row(i));
+  }
+}
+
+Matrix DenseMatrix::toMatrix() const {
+  Matrix M(rows_);
+  for (size_t i = 0; i < rows_; i++)
+    M[i].assign(row(i), row(i) + cols_);
+  return M;
+}
+
+DenseMatrix simpleMult(const DenseMatrix& A, const DenseMatrix& B) {
+  if (A.cols() != B.rows())
+    throw "Different size";
+  DenseMatrix C(A.rows(), B.cols());
+  for (size_t i = 0; i < A.rows(); i++) {
+    double* c = C.row(i);
+    for (size_t t = 0; t < A.cols(); t++) {
+      const double a = A(i, t);
+      const double* b = B.row(t);
+      for (size_t j = 0; j < B.cols(); j++)
+        c[j] += a * b[j];
+    }
+  }
+  return C;
+}
+
+// Same blocking as the Matrix version: for each block of C columns and
+// block of the inner dimension, every row of A walks one contiguous
+// slice of B's rows, so the slice stays in cache across rows
+DenseMatrix foxMult(const DenseMatrix& A, const DenseMatrix& B, const int &blockSize) {
+  if (A.cols() != B.rows() || A.rows() != A.cols() || B.rows() != B.cols())
+    throw "Different size";
+  int n = A.rows();
+  if (blockSize <= 0 || blockSize > n)
+    throw "block size is larger than matrix size";
+  DenseMatrix C(n, n);
+  for (int a = 0; a < n; a += blockSize) {
+    int endA = std::min(a + blockSize, n);
+    for (int b = 0; b < n; b += blockSize) {
+      int endB = std::min(b + blockSize, n);
+      for (int i = 0; i < n; i++) {
+        double* c = C.row(i);
+        for (int k = b; k < endB; k++) {
+          const double aik = A(i, k);
+          const double* bk = B.row(k);
+          for (int j = a; j < endA; j++)
+            c[j] += aik * bk[j];
+        }
+      }
+    }
+  }
+  return C;
+}
@@ -2,6 +2,7 @@
 #ifndef MODULES_TASK_1_GOLUBEVA_A_FOX_MULT_FOX_H_
 #define MODULES_TASK_1_GOLUBEVA_A_FOX_MULT_FOX_H_
 
+#include <cstddef>
 #include <vector>
 
 using Matrix = std::vector<std::vector<double>>;
@@ -10,4 +11,28 @@ Matrix simpleMult(const Matrix& A, const Matrix& B);
 Matrix foxMult(const Matrix& A, const Matrix& B, const int &blockSize);
 Matrix randMatrix(const int& n);
 
+// Row-major matrix in one allocation, element (i, j) is at i * cols + j
+class DenseMatrix {
+ public:
+  DenseMatrix(size_t rows, size_t cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0) {}
+  explicit DenseMatrix(const Matrix& M);
+
+  size_t rows() const { return rows_; }
+  size_t cols() const { return cols_; }
+  double* row(size_t i) { return data_.data() + i * cols_; }
+  const double* row(size_t i) const { return data_.data() + i * cols_; }
+  double& operator()(size_t i, size_t j) { return data_[i * cols_ + j]; }
+  const double& operator()(size_t i, size_t j) const { return data_[i * cols_ + j]; }
+
+  Matrix toMatrix() const;
+
+ private:
+  size_t rows_;
+  size_t cols_;
+  std::vector<double> data_;
+};
+
+DenseMatrix simpleMult(const DenseMatrix& A, const DenseMatrix& B);
+DenseMatrix foxMult(const DenseMatrix& A, const DenseMatrix& B, const int &blockSize);
+
 #endif  // MODULES_TASK_1_GOLUBEVA_A_FOX_MULT_FOX_H_
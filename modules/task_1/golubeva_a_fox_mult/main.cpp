@@ -1,6 +1,7 @@
 // Copyright 2020 Golubeva Anna
 
 #include <gtest/gtest.h>
+#include <cmath>
 #include <iostream>
 #include "../../../modules/task_1/golubeva_a_fox_mult/fox.h"
 
@@ -57,3 +58,43 @@ TEST(Fox_Mult, cant_do_fox_mult_with_different_size) {
 
 ASSERT_ANY_THROW(foxMult(A, B, 3));
 }
+
+TEST(Fox_Mult, dense_matrix_round_trip) {
+  Matrix A = randMatrix(5);
+
+  ASSERT_EQ(A, DenseMatrix(A).toMatrix());
+}
+
+TEST(Fox_Mult, dense_simple_and_fox_mult_match_matrix_version) {
+  Matrix A = randMatrix(11);
+  Matrix B = randMatrix(11);
+  Matrix C = simpleMult(A, B);
+
+  Matrix simple = simpleMult(DenseMatrix(A), DenseMatrix(B)).toMatrix();
+  Matrix fox = foxMult(DenseMatrix(A), DenseMatrix(B), 4).toMatrix();
+
+  for (int i = 0; i < 11; i++) {
+    for (int j = 0; j < 11; j++) {
+      EXPECT_NEAR(C[i][j], simple[i][j], 1e-6 * std::abs(C[i][j]));
+      EXPECT_NEAR(C[i][j], fox[i][j], 1e-6 * std::abs(C[i][j]));
+    }
+  }
+}
+
+TEST(Fox_Mult, dense_simple_mult_of_non_square_matrices) {
+  Matrix A = { {1, 2, 3},
+               {4, 5, 6} };
+  Matrix B = { {1},
+               {2},
+               {3} };
+  Matrix C = { {14},
+               {32} };
+
+  ASSERT_EQ(C, simpleMult(DenseMatrix(A), DenseMatrix(B)).toMatrix());
+}
+
+TEST(Fox_Mult, cant_do_dense_fox_mult_with_different_size) {
+  DenseMatrix A(7, 7), B(9, 9);
+
+  ASSERT_ANY_THROW(foxMult(A, B, 3));
+}
@@ -2,6 +2,8 @@
 #include <gtest/gtest.h>
 #include <vector>
 #include <algorithm>
+#include <climits>
+#include <random>
 #include "./radix_sort_w_batcher.h"
 
 TEST(Radix_Sort_W_Batcher, Test_CorrectSort) {
@@ -39,6 +41,41 @@ TEST(Radix_Sort_W_Batcher, Test_Batcher) {
     ASSERT_EQ(stl_mege, res);
 }
 
+TEST(Radix_Sort_W_Batcher, Test_SortNegativeAndExtremes) {
+    std::vector<int> vec = { 5, -3, INT_MAX, 0, INT_MIN, -1, 7, INT_MIN + 1, -3 };
+    std::vector<int> expected = vec;
+    std::sort(expected.begin(), expected.end());
+    radixSort(&vec);
+    ASSERT_EQ(expected, vec);
+}
+
+TEST(Radix_Sort_W_Batcher, Test_AllDigitWidths) {
+    std::mt19937 gen(5);
+    const int sizes[] = { 0, 1, 100, 5000, (1 << 20) + 3 };
+    const int widths[] = { 8, 11, 16 };
+    for (int size : sizes) {
+        std::vector<int> vec(size);
+        for (int& x : vec) {
+            x = static_cast<int>(gen());
+        }
+        std::vector<int> expected = vec;
+        std::sort(expected.begin(), expected.end());
+        for (int bits : widths) {
+            std::vector<int> res = vec;
+            radixSortBits(&res, bits);
+            ASSERT_EQ(expected, res);
+        }
+    }
+}
+
+TEST(Radix_Sort_W_Batcher, Test_DigitBitsBySize) {
+    ASSERT_EQ(8, getDigitBits(1000));
+    ASSERT_EQ(11, getDigitBits(1 << 20));
+    ASSERT_EQ(16, getDigitBits(1 << 24));
+    std::vector<int> vec = { 2, 1 };
+    ASSERT_ANY_THROW(radixSortBits(&vec, 10));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -5,6 +5,8 @@
 #include <ctime>
 #include <utility>
 #include <random>
+#include <cstdint>
+#include <cstring>
 #include "../../../modules/task_1/guseva_e_radix_sort_w_batcher/radix_sort_w_batcher.h"
 
 bool checkSort(std::vector<int> arr) {
@@ -12,9 +14,90 @@ bool checkSort(std::vector<int> arr) {
 }
 
 void radixSort(std::vector<int> *vec) {
-    int max = getMax(vec);
-    for (int exp = 1; max / exp > 0; exp *= 10) {
-        countSort(vec, exp);
+    radixSortBits(vec, getDigitBits(vec->size()));
+}
+
+int getDigitBits(int size) {
+    if (size < (1 << 16)) {
+        return 8;
+    }
+    return size < (1 << 23) ? 11 : 16;
+}
+
+// For large inputs the keys go to a buffer of one cache line per bucket and
+// are copied to the output a line at a time, so the scatter writes whole
+// lines instead of touching a line per key. Smaller inputs and 16-bit
+// digits (whose buffers would not fit in cache) scatter directly.
+const int kLineKeys = 16;
+const int kLineMinSize = 1 << 20;
+
+static void scatterByDigit(const uint32_t* src, uint32_t* dst, int size, int shift, int digitBits,
+                           std::vector<int> *offset, std::vector<uint32_t> *lines) {
+    const uint32_t mask = (1u << digitBits) - 1;
+    int* pos = offset->data();
+    if (lines->empty()) {
+        for (int i = 0; i < size; i++) {
+            dst[pos[(src[i] >> shift) & mask]++] = src[i];
+        }
+        return;
+    }
+    uint32_t* line = lines->data();
+    std::vector<int> fill(mask + 1, 0);
+    for (int i = 0; i < size; i++) {
+        uint32_t digit = (src[i] >> shift) & mask;
+        line[digit * kLineKeys + fill[digit]++] = src[i];
+        if (fill[digit] == kLineKeys) {
+            memcpy(dst + pos[digit], line + digit * kLineKeys, sizeof(uint32_t) * kLineKeys);
+            pos[digit] += kLineKeys;
+            fill[digit] = 0;
+        }
+    }
+    for (uint32_t digit = 0; digit <= mask; digit++) {
+        memcpy(dst + pos[digit], line + digit * kLineKeys, sizeof(uint32_t) * fill[digit]);
+    }
+}
+
+void radixSortBits(std::vector<int> *vec, int digitBits) {
+    if (digitBits != 8 && digitBits != 11 && digitBits != 16) {
+        throw - 1;
+    }
+    int size = vec->size();
+    int* data = vec->data();
+    int passes = (32 + digitBits - 1) / digitBits;
+    int buckets = 1 << digitBits;
+    const uint32_t mask = buckets - 1;
+
+    // Flipping the sign bit orders the keys as unsigned; the counters of
+    // all digits are filled in the same pass
+    std::vector<uint32_t> keys(size), tmp(size);
+    std::vector<int> count(passes * buckets, 0);
+    for (int i = 0; i < size; i++) {
+        uint32_t key = static_cast<uint32_t>(data[i]) ^ 0x80000000u;
+        keys[i] = key;
+        for (int p = 0; p < passes; p++) {
+            count[p * buckets + ((key >> (p * digitBits)) & mask)]++;
+        }
+    }
+
+    uint32_t* src = keys.data();
+    uint32_t* dst = tmp.data();
+    std::vector<int> offset(buckets);
+    std::vector<uint32_t> lines(size >= kLineMinSize && digitBits <= 11 ? buckets * kLineKeys : 0);
+    for (int p = 0; p < passes; p++) {
+        const int* digitCount = &count[p * buckets];
+        if (size == 0 || digitCount[(src[0] >> (p * digitBits)) & mask] == size) {
+            continue;  // all keys have the same digit
+        }
+        int sum = 0;
+        for (int b = 0; b < buckets; b++) {
+            offset[b] = sum;
+            sum += digitCount[b];
+        }
+        scatterByDigit(src, dst, size, p * digitBits, digitBits, &offset, &lines);
+        std::swap(src, dst);
+    }
+    for (int i = 0; i < size; i++) {
+        data[i] = static_cast<int>(src[i] ^ 0x80000000u);
     }
 }
 
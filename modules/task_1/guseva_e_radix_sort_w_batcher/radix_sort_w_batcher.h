@@ -4,7 +4,13 @@
 #include <vector>
 
 bool checkSort(std::vector<int> arr);
+// LSD radix sort of any ints by binary digits of getDigitBits(size) bits
 void radixSort(std::vector<int> *vec);
+// Digits of 8, 11 or 16 bits: small inputs need counters and write buffers
+// that stay in L1, large ones are worth the bigger tables for fewer passes
+int getDigitBits(int size);
+void radixSortBits(std::vector<int> *vec, int digitBits);
+// One stable pass by the decimal digit exp (1, 10, 100, ...), non-negative values
 void countSort(std::vector<int> *vec, int exp);
 int getMax(std::vector<int> *vec);
 std::vector<int> EvenOddBatch(std::vector<int> vec1, std::vector<int> vec2);
@@ -1,9 +1,28 @@
 // Copyright 2020 Isaev Ilya
 
 #include <gtest/gtest.h>
+#include <ctime>
 #include <iostream>
+#include <vector>
 #include "../../../modules/task_1/isaev_matrix_mult/matrix_mult.h"
 
+// Textbook triple loop, the reference for the gemm-based multiplications
+Matrix referenceMultiplication(const Matrix& mat1, const Matrix& mat2) {
+    Matrix res(mat1.size(), std::vector<double>(mat2[0].size(), 0));
+    for (size_t i = 0; i < mat1.size(); ++i)
+        for (size_t k = 0; k < mat2.size(); ++k)
+            for (size_t j = 0; j < mat2[0].size(); ++j)
+                res[i][j] += mat1[i][k] * mat2[k][j];
+    return res;
+}
+
+void expectNearReference(const Matrix& res, const Matrix& expected) {
+    ASSERT_EQ(res.size(), expected.size());
+    for (size_t i = 0; i < expected.size(); ++i)
+        for (size_t j = 0; j < expected[0].size(); ++j)
+            ASSERT_NEAR(res[i][j], expected[i][j], expected[i][j] * 1e-12);
+}
+
 TEST(Matrix_Mult, Matrix_Gen_Throws_On_Negative_Size) {
     ASSERT_ANY_THROW(getRandomMatrix(-1));
 }
@@ -47,5 +66,93 @@ TEST(Matrix_Mult, Block_Multiplication_Is_Correct_Size_3x3) {
 TEST(Matrix_Mult, Block_And_Naive_Have_The_Same_Answer) {
     auto mat1 = getRandomMatrix(5);
     auto mat2 = getRandomMatrix(5);
-    ASSERT_EQ(matrixComparison(naiveMultiplication(mat1, mat2), blockMultiplication(mat1, mat2)), true);
+    expectNearReference(naiveMultiplication(mat1, mat2), referenceMultiplication(mat1, mat2));
+    expectNearReference(blockMultiplication(mat1, mat2), referenceMultiplication(mat1, mat2));
+}
+
+TEST(Matrix_Mult, Block_Multiplication_Uneven_Blocks) {
+    auto mat1 = getRandomMatrix(47);
+    auto mat2 = getRandomMatrix(47);
+    expectNearReference(blockMultiplication(mat1, mat2), referenceMultiplication(mat1, mat2));
+}
+
+TEST(Matrix_Mult, Gemm_Multiplication_Is_Correct_Size_3x3) {
+    Matrix mat1 = {{1.5, 1.5, 1.5},
+                   {2.7, 2.7, 2.7},
+                   {3.6, 3.6, 3.6}};
+    Matrix mat2 = {{3.5, 3.5, 3.5},
+                   {5.7, 5.7, 5.7},
+                   {9.6, 9.6, 9.6}};
+    Matrix answer = {{28.2, 28.2, 28.2},
+                    {50.76, 50.76, 50.76},
+                    {67.68, 67.68, 67.68}};
+    auto res = gemmMultiplication(mat1, mat2);
+
+    for (size_t i = 0; i < answer.size(); ++i)
+        for (size_t j = 0; j < answer.size(); ++j)
+            ASSERT_NEAR(res[i][j], answer[i][j], 1e-12);
+}
+
+TEST(Matrix_Mult, Gemm_Scalar_And_Simd_Kernels_Across_Blocks) {
+    auto mat1 = getRandomMatrix(301);
+    auto mat2 = getRandomMatrix(301);
+    auto expected = referenceMultiplication(mat1, mat2);
+
+    ASSERT_FALSE(setGemmSimd(false));
+    expectNearReference(gemmMultiplication(mat1, mat2), expected);
+    ASSERT_EQ(setGemmSimd(true), gemmSimdAvailable());
+    expectNearReference(gemmMultiplication(mat1, mat2), expected);
+    if (!gemmSimdAvailable())
+        std::cout << "AVX2/FMA is not available, only the scalar kernel was tested" << std::endl;
+}
+
+class GemmKernel : public ::testing::TestWithParam<bool> {
+ protected:
+    void SetUp() override { setGemmSimd(GetParam()); }
+    void TearDown() override { setGemmSimd(true); }
+};
+
+TEST_P(GemmKernel, Gemm_Works_On_Strided_Sub_Blocks) {
+    const int ld = 11;
+    std::vector<double> a(ld * ld), b(ld * ld), c(ld * ld, 1.0);
+    for (int i = 0; i < ld * ld; ++i) {
+        a[i] = i % 7;
+        b[i] = i % 5 - 2;
+    }
+    // c[2.., 3..] (5 x 6) += a[1.., 0..] (5 x 9) * b[0.., 4..] (9 x 6)
+    gemm(5, 6, 9, &a[1 * ld], ld, &b[4], ld, &c[2 * ld + 3], ld);
+
+    for (int i = 0; i < ld; ++i) {
+        for (int j = 0; j < ld; ++j) {
+            double expected = 1.0;
+            if (i >= 2 && i < 7 && j >= 3 && j < 9) {
+                for (int p = 0; p < 9; ++p)
+                    expected += a[(i - 1) * ld + p] * b[p * ld + j + 1];
+            }
+            ASSERT_DOUBLE_EQ(c[i * ld + j], expected);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(Matrix_Mult, GemmKernel, ::testing::Bool());
+
+TEST(Matrix_Mult, DISABLED_Gemm_Time) {
+    const int n = 1024;
+    auto mat1 = getRandomMatrix(n);
+    auto mat2 = getRandomMatrix(n);
+
+    clock_t start = clock();
+    auto expected = blockMultiplication(mat1, mat2);
+    double blockTime = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    start = clock();
+    auto res = gemmMultiplication(mat1, mat2);
+    double gemmTime = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+
+    std::cout << "Block: " << blockTime << std::endl
+              << "Gemm: " << gemmTime << " (" << 2.0 * n * n * n / gemmTime * 1e-9 << " GFLOP/s)" << std::endl;
+
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < n; ++j)
+            ASSERT_NEAR(res[i][j], expected[i][j], expected[i][j] * 1e-12);
 }
@@ -4,9 +4,181 @@
 #include <iostream>
 #include <limits>
 #include <algorithm>
+#include <cmath>
 #include <exception>
 #include <vector>
 #include "../../../modules/task_1/isaev_matrix_mult/matrix_mult.h"
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+// The AVX2 kernel is compiled for that target whatever the build flags are
+// and used only if the CPU reports AVX2 and FMA
+#define ISAEV_GEMM_AVX2 __attribute__((target("avx2,fma")))
+#define ISAEV_GEMM_RUNTIME_CHECK
+#elif defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#define ISAEV_GEMM_AVX2
+#endif
+
+namespace {
+// Micro-tile held in registers and cache blocks: a kMC x kKC panel of A stays in L2,
+// a kKC x kNR sliver of B in L1
+const int kMR = 4;
+const int kNR = 8;
+const int kMC = 96;
+const int kKC = 256;
+const int kNC = 2048;
+
+void packA(int mc, int kc, const double* a, int lda, double* packed) {
+    for (int i = 0; i < mc; i += kMR) {
+        for (int p = 0; p < kc; ++p) {
+            for (int ii = 0; ii < kMR; ++ii) {
+                *packed++ = (i + ii < mc) ? a[(i + ii) * lda + p] : 0.0;
+            }
+        }
+    }
+}
+
+void packB(int kc, int nc, const double* b, int ldb, double* packed) {
+    for (int j = 0; j < nc; j += kNR) {
+        for (int p = 0; p < kc; ++p) {
+            for (int jj = 0; jj < kNR; ++jj) {
+                *packed++ = (j + jj < nc) ? b[p * ldb + j + jj] : 0.0;
+            }
+        }
+    }
+}
+
+void storeTile(const double* tile, double* c, int ldc, int mr, int nr) {
+    for (int i = 0; i < mr; ++i) {
+        for (int j = 0; j < nr; ++j) {
+            c[i * ldc + j] += tile[i * kNR + j];
+        }
+    }
+}
+
+void microKernelScalar(int kc, const double* a, const double* b, double* c, int ldc, int mr, int nr) {
+    double tile[kMR * kNR];
+    std::fill(tile, tile + kMR * kNR, 0.0);
+    for (int p = 0; p < kc; ++p, a += kMR, b += kNR) {
+        for (int i = 0; i < kMR; ++i) {
+            for (int j = 0; j < kNR; ++j) {
+                tile[i * kNR + j] += a[i] * b[j];
+            }
+        }
+    }
+    storeTile(tile, c, ldc, mr, nr);
+}
+
+#ifdef ISAEV_GEMM_AVX2
+ISAEV_GEMM_AVX2
+void microKernelAvx2(int kc, const double* a, const double* b, double* c, int ldc, int mr, int nr) {
+    double tile[kMR * kNR];
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+    for (int p = 0; p < kc; ++p, a += kMR, b += kNR) {
+        __m256d b0 = _mm256_loadu_pd(b);
+        __m256d b1 = _mm256_loadu_pd(b + 4);
+        __m256d ai = _mm256_broadcast_sd(a);
+        c00 = _mm256_fmadd_pd(ai, b0, c00);
+        c01 = _mm256_fmadd_pd(ai, b1, c01);
+        ai = _mm256_broadcast_sd(a + 1);
+        c10 = _mm256_fmadd_pd(ai, b0, c10);
+        c11 = _mm256_fmadd_pd(ai, b1, c11);
+        ai = _mm256_broadcast_sd(a + 2);
+        c20 = _mm256_fmadd_pd(ai, b0, c20);
+        c21 = _mm256_fmadd_pd(ai, b1, c21);
+        ai = _mm256_broadcast_sd(a + 3);
+        c30 = _mm256_fmadd_pd(ai, b0, c30);
+        c31 = _mm256_fmadd_pd(ai, b1, c31);
+    }
+    _mm256_storeu_pd(tile, c00);
+    _mm256_storeu_pd(tile + 4, c01);
+    _mm256_storeu_pd(tile + 8, c10);
+    _mm256_storeu_pd(tile + 12, c11);
+    _mm256_storeu_pd(tile + 16, c20);
+    _mm256_storeu_pd(tile + 20, c21);
+    _mm256_storeu_pd(tile + 24, c30);
+    _mm256_storeu_pd(tile + 28, c31);
+    storeTile(tile, c, ldc, mr, nr);
+}
+#endif
+
+bool cpuHasAvx2() {
+#if defined(ISAEV_GEMM_RUNTIME_CHECK)
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#elif defined(ISAEV_GEMM_AVX2)
+    return true;
+#else
+    return false;
+#endif
+}
+
+typedef void (*MicroKernel)(int, const double*, const double*, double*, int, int, int);
+
+MicroKernel chooseMicroKernel(bool simd) {
+#ifdef ISAEV_GEMM_AVX2
+    if (simd && cpuHasAvx2())
+        return microKernelAvx2;
+#endif
+    return microKernelScalar;
+}
+
+MicroKernel microKernel = chooseMicroKernel(true);
+
+std::vector<double> toRowMajor(const Matrix& mat) {
+    std::vector<double> flat(mat.size() * mat[0].size());
+    for (size_t i = 0; i < mat.size(); ++i)
+        std::copy(mat[i].begin(), mat[i].end(), flat.begin() + i * mat[0].size());
+    return flat;
+}
+
+Matrix fromRowMajor(const std::vector<double>& flat, int rows, int cols) {
+    Matrix res(rows, std::vector<double>(cols));
+    for (int i = 0; i < rows; ++i)
+        std::copy(flat.begin() + i * cols, flat.begin() + (i + 1) * cols, res[i].begin());
+    return res;
+}
+}  // namespace
+
+bool gemmSimdAvailable() {
+    return cpuHasAvx2();
+}
+
+bool setGemmSimd(bool enabled) {
+    microKernel = chooseMicroKernel(enabled);
+    return microKernel != microKernelScalar;
+}
+
+void gemm(int m, int n, int k, const double* a, int lda, const double* b, int ldb, double* c, int ldc) {
+    if (m < 0 || n < 0 || k < 0)
+        throw std::exception();
+    int panelM = (std::min(kMC, m) + kMR - 1) / kMR * kMR;
+    int panelN = (std::min(kNC, n) + kNR - 1) / kNR * kNR;
+    std::vector<double> packedA(panelM * std::min(kKC, k));
+    std::vector<double> packedB(std::min(kKC, k) * panelN);
+
+    for (int jc = 0; jc < n; jc += kNC) {
+        int nc = std::min(kNC, n - jc);
+        for (int pc = 0; pc < k; pc += kKC) {
+            int kc = std::min(kKC, k - pc);
+            packB(kc, nc, b + pc * ldb + jc, ldb, packedB.data());
+            for (int ic = 0; ic < m; ic += kMC) {
+                int mc = std::min(kMC, m - ic);
+                packA(mc, kc, a + ic * lda + pc, lda, packedA.data());
+                for (int jr = 0; jr < nc; jr += kNR) {
+                    for (int ir = 0; ir < mc; ir += kMR) {
+                        microKernel(kc, packedA.data() + ir * kc, packedB.data() + jr * kc,
+                                    c + (ic + ir) * ldc + jc + jr, ldc,
+                                    std::min(kMR, mc - ir), std::min(kNR, nc - jr));
+                    }
+                }
+            }
+        }
+    }
+}
 
 Matrix getRandomMatrix(const int& n) {
     if (n <= 0) {
@@ -26,44 +198,38 @@ Matrix getRandomMatrix(const int& n) {
 }
 
 Matrix naiveMultiplication(const Matrix& mat1, const Matrix& mat2) {
+    return gemmMultiplication(mat1, mat2);
+}
+
+Matrix blockMultiplication(const Matrix& mat1, const Matrix& mat2) {
     if (mat1[0].size() != mat2.size())
         throw std::exception();
+    int n = mat1.size();
+    int m = mat2[0].size();
+    int k = mat2.size();
+    int q = std::max(1, static_cast<int>(std::sqrt(k)));
+    int block_size = (k + q - 1) / q;
+    std::vector<double> a = toRowMajor(mat1), b = toRowMajor(mat2), c(n * m, 0);
 
-    size_t n = mat1.size();
-    size_t m = mat2[0].size();
-    Matrix res(n, std::vector<double>(n, 0));
-
-    for (size_t i = 0; i < n; ++i) {
-        for (size_t j = 0; j < m; ++j) {
-            for (size_t k = 0; k < mat2.size(); ++k) {
-                res[i][j] += mat1[i][k]*mat2[k][j];
-            }
+    // every block product is a gemm call on strided sub-blocks
+    for (int jj = 0; jj < m; jj += block_size) {
+        for (int kk = 0; kk < k; kk += block_size) {
+            gemm(n, std::min(block_size, m - jj), std::min(block_size, k - kk),
+                 a.data() + kk, k, b.data() + kk * m + jj, m, c.data() + jj, m);
         }
     }
-    return res;
+    return fromRowMajor(c, n, m);
 }
 
-Matrix blockMultiplication(const Matrix& mat1, const Matrix& mat2) {
+Matrix gemmMultiplication(const Matrix& mat1, const Matrix& mat2) {
     if (mat1[0].size() != mat2.size())
         throw std::exception();
-    size_t n = mat1.size();
-    size_t q = n / std::sqrt(n);
-    size_t block_size = n / q;
-    Matrix res(n, std::vector<double>(n, 0));
-
-    for (size_t jj = 0; jj < n; jj+=block_size) {
-        for (size_t kk = 0; kk < n; kk+=block_size) {
-            for (size_t i = 0; i < n; ++i) {
-                for (size_t j = jj; j < std::min(jj+block_size, n); ++j) {
-                    for (size_t k = kk; k < std::min(kk+block_size, n); ++k) {
-                        res[i][j] += mat1[i][k] * mat2[k][j];
-                    }
-                }
-            }
-        }
-    }
-
-    return res;
+    int n = mat1.size();
+    int m = mat2[0].size();
+    int k = mat2.size();
+    std::vector<double> a = toRowMajor(mat1), b = toRowMajor(mat2), c(n * m, 0);
+    gemm(n, m, k, a.data(), k, b.data(), m, c.data(), m);
+    return fromRowMajor(c, n, m);
 }
 
 bool matrixComparison(const Matrix& mat1, const Matrix& mat2) {
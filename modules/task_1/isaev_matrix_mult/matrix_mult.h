@@ -7,10 +7,23 @@
 using Matrix = std::vector<std::vector<double>>;
 
 Matrix getRandomMatrix(const int& n);
+// Both run on gemm: the whole product at once, or one gemm call per
+// sqrt(n)-sized block of the classical block algorithm
 Matrix naiveMultiplication(const Matrix& mat1, const Matrix& mat2);
 Matrix blockMultiplication(const Matrix& mat1, const Matrix& mat2);
+Matrix gemmMultiplication(const Matrix& mat1, const Matrix& mat2);
 bool isSquared(const Matrix& mat);
 bool matrixComparison(const Matrix& mat1, const Matrix& mat2);
 bool doubleComparison(const double& a, const double& b);
 
+// Packed, cache-blocked kernel on row-major storage: c[m x n] += a[m x k] * b[k x n].
+// lda, ldb and ldc are row strides, so sub-blocks of a bigger matrix can be passed
+// directly. Uses an AVX2/FMA register-tiled micro-kernel when the CPU has it (with
+// GCC and Clang it is built whatever the flags are) and a scalar one otherwise.
+void gemm(int m, int n, int k, const double* a, int lda, const double* b, int ldb, double* c, int ldc);
+bool gemmSimdAvailable();
+// Selects the AVX2 micro-kernel (if available) or the scalar one, returns
+// whether the AVX2 one is now in use
+bool setGemmSimd(bool enabled);
+
 #endif  // MODULES_TASK_1_ISAEV_MATRIX_MULT_MATRIX_MULT_H_
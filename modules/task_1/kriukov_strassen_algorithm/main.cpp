@@ -1,6 +1,9 @@
 // Copyright 2020 Kriukov Dmitry
 #include <gtest/gtest.h>
 #include <../../../modules/task_1/kriukov_strassen_algorithm/strassen_algorithm.h>
+#include <cstdio>
+#include <random>
+#include <string>
 #include <vector>
 
 #define EXPECT_CONTAINER_DOUBLE_EQ(TYPE, ref_, target_)\
@@ -152,6 +155,61 @@ TEST(SequentialStrassen, Test_Strassen_Mult_size_3) {
     EXPECT_CONTAINER_DOUBLE_EQ(std::vector<double>, res_regular, res_strassen);
 }
 
+TEST(SequentialStrassen, Test_Winograd_Mult_Odd_Sizes) {
+  setWinogradCrossover(4);
+  for (unsigned int sz : {1u, 2u, 5u, 9u, 17u, 33u, 59u}) {
+    std::vector<double> a = getRandomMatrix(sz);
+    std::vector<double> b = getRandomMatrix(sz);
+    EXPECT_CONTAINER_DOUBLE_EQ(std::vector<double>, regularMultiplication(a, b, sz),
+                               winogradMultiplication(a, b, sz));
+  }
+  setWinogradCrossover(64);
+}
+
+TEST(SequentialStrassen, Test_Winograd_Mult_size_129) {
+  unsigned int sz = 129;
+  std::vector<double> a = getRandomMatrix(sz);
+  std::vector<double> b = getRandomMatrix(sz);
+  EXPECT_CONTAINER_DOUBLE_EQ(std::vector<double>, regularMultiplication(a, b, sz), winogradMultiplication(a, b, sz));
+}
+
+TEST(SequentialStrassen, Test_Winograd_Wrong_Crossover) {
+  ASSERT_ANY_THROW(setWinogradCrossover(0));
+}
+
+class TempFile {
+ public:
+  TempFile() {
+    std::random_device rd;
+    path_ = ::testing::TempDir() + "kriukov_winograd_" + std::to_string(rd()) + ".txt";
+  }
+  TempFile(const TempFile&) = delete;
+  TempFile& operator=(const TempFile&) = delete;
+  ~TempFile() { std::remove(path_.c_str()); }
+
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+TEST(SequentialStrassen, Test_Winograd_Tune_Stores_Crossover) {
+  TempFile cache;
+
+  unsigned int tuned = tuneWinogradCrossover(cache.path(), 64);
+  EXPECT_EQ(getWinogradCrossover(), tuned);
+
+  setWinogradCrossover(7);
+  EXPECT_EQ(tuneWinogradCrossover(cache.path(), 64), tuned);
+  EXPECT_EQ(getWinogradCrossover(), tuned);
+
+  setWinogradCrossover(64);
+}
+
+TEST(SequentialStrassen, Test_Winograd_Cache_Path) {
+  EXPECT_NE(std::string::npos, winogradCachePath().find("kriukov_winograd_crossover.txt"));
+}
+
 #define STRASSEN_ALGORITHM_TIME_TEST_OFF
 
 #ifdef STRASSEN_ALGORITHM_TIME_TEST_ON
@@ -289,4 +347,24 @@ TEST(SequentialStrassen, Time_Test_Strassen_Mult_size_4096) {
   std::cout << "Strassen : " << seconds_s << std::endl;
 }
 
+TEST(SequentialStrassen, Time_Test_Winograd_Mult_size_1025) {
+  unsigned int sz = 1025;
+  std::vector<double> a = getRandomMatrix(sz);
+  std::vector<double> b = getRandomMatrix(sz);
+  clock_t start_s = clock();
+  std::vector<double> res_strassen = strassenMultiplication(a, b, sz);
+  clock_t end_s = clock();
+  clock_t start_w = clock();
+  std::vector<double> res_winograd = winogradMultiplication(a, b, sz);
+  clock_t end_w = clock();
+
+  double seconds_s = static_cast<double>(end_s - start_s) / CLOCKS_PER_SEC;
+  std::cout << "Strassen : " << seconds_s << std::endl;
+
+  double seconds_w = static_cast<double>(end_w - start_w) / CLOCKS_PER_SEC;
+  std::cout << "Winograd : " << seconds_w << std::endl;
+
+  EXPECT_CONTAINER_DOUBLE_EQ(std::vector<double>, res_strassen, res_winograd);
+}
+
 #endif  // STRASSEN_ALGORITHM_TIME_TEST_ON
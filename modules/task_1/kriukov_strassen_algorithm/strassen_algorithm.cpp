@@ -1,8 +1,15 @@
 // Copyright 2020 Kriukov Dmitry
 
 #include <../../../modules/task_1/kriukov_strassen_algorithm/strassen_algorithm.h>
-#include <random>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 std::vector<double> getRandomMatrix(int sz) {
@@ -181,3 +188,199 @@ std::vector<double> strassenMultiplication_NoCastToPowerOfTwo(const std::vector<
 
   return res;
 }
+
+namespace {
+
+const unsigned int kDefaultCrossover = 64;
+unsigned int winograd_crossover = 0;  // 0 until it is set or tuned
+
+// Row-major block: element (i, j) is ptr[i * ld + j]
+struct Block {
+  double* ptr;
+  unsigned ld;
+};
+
+struct ConstBlock {
+  const double* ptr;
+  unsigned ld;
+
+  ConstBlock(const double* p, unsigned l) : ptr(p), ld(l) {}
+  ConstBlock(const Block& b) : ptr(b.ptr), ld(b.ld) {}  // NOLINT(runtime/explicit)
+};
+
+ConstBlock sub(ConstBlock x, unsigned i, unsigned j) { return ConstBlock(x.ptr + i * x.ld + j, x.ld); }
+Block sub(Block x, unsigned i, unsigned j) { return {x.ptr + i * x.ld + j, x.ld}; }
+
+// c = a (m x k) * b (k x n), classical loops blocked for cache
+void blockedMultiplication(unsigned m, unsigned k, unsigned n, ConstBlock a, ConstBlock b, Block c) {
+  const unsigned block = 64;
+  for (unsigned i = 0; i < m; i++)
+    std::fill(c.ptr + i * c.ld, c.ptr + i * c.ld + n, 0.0);
+  for (unsigned kk = 0; kk < k; kk += block) {
+    unsigned k_end = std::min(kk + block, k);
+    for (unsigned jj = 0; jj < n; jj += block) {
+      unsigned j_end = std::min(jj + block, n);
+      for (unsigned i = 0; i < m; i++) {
+        double* c_row = c.ptr + i * c.ld;
+        for (unsigned p = kk; p < k_end; p++) {
+          double a_ip = a.ptr[i * a.ld + p];
+          const double* b_row = b.ptr + p * b.ld;
+          for (unsigned j = jj; j < j_end; j++)
+            c_row[j] += a_ip * b_row[j];
+        }
+      }
+    }
+  }
+}
+
+// res = x + sign * y, all rows x cols
+void combine(unsigned rows, unsigned cols, ConstBlock x, ConstBlock y, double sign, Block res) {
+  for (unsigned i = 0; i < rows; i++)
+    for (unsigned j = 0; j < cols; j++)
+      res.ptr[i * res.ld + j] = x.ptr[i * x.ld + j] + sign * y.ptr[i * y.ld + j];
+}
+
+void winogradRecursive(unsigned m, unsigned k, unsigned n, ConstBlock a, ConstBlock b, Block c,
+                       unsigned crossover) {
+  if (std::min(m, std::min(k, n)) <= crossover || m < 2 || k < 2 || n < 2) {
+    blockedMultiplication(m, k, n, a, b, c);
+    return;
+  }
+
+  // Even core handled by Winograd, the odd row / column / inner index is peeled
+  unsigned me = m & ~1u, ke = k & ~1u, ne = n & ~1u;
+  unsigned m2 = me / 2, k2 = ke / 2, n2 = ne / 2;
+
+  std::vector<double> s_buf(4 * m2 * k2), t_buf(4 * k2 * n2), p_buf(3 * m2 * n2);
+  Block s1 = {&s_buf[0], k2}, s2 = {&s_buf[m2 * k2], k2};
+  Block s3 = {&s_buf[2 * m2 * k2], k2}, s4 = {&s_buf[3 * m2 * k2], k2};
+  Block t1 = {&t_buf[0], n2}, t2 = {&t_buf[k2 * n2], n2};
+  Block t3 = {&t_buf[2 * k2 * n2], n2}, t4 = {&t_buf[3 * k2 * n2], n2};
+  Block p1 = {&p_buf[0], n2}, p2 = {&p_buf[m2 * n2], n2}, tmp = {&p_buf[2 * m2 * n2], n2};
+
+  ConstBlock a11 = sub(a, 0, 0), a12 = sub(a, 0, k2), a21 = sub(a, m2, 0), a22 = sub(a, m2, k2);
+  ConstBlock b11 = sub(b, 0, 0), b12 = sub(b, 0, n2), b21 = sub(b, k2, 0), b22 = sub(b, k2, n2);
+  Block c11 = sub(c, 0, 0), c12 = sub(c, 0, n2), c21 = sub(c, m2, 0), c22 = sub(c, m2, n2);
+
+  // 8 pre-additions
+  combine(m2, k2, a21, a22, 1.0, s1);
+  combine(m2, k2, s1, a11, -1.0, s2);
+  combine(m2, k2, a11, a21, -1.0, s3);
+  combine(m2, k2, a12, s2, -1.0, s4);
+  combine(k2, n2, b12, b11, -1.0, t1);
+  combine(k2, n2, b22, t1, -1.0, t2);
+  combine(k2, n2, b22, b12, -1.0, t3);
+  combine(k2, n2, t2, b21, -1.0, t4);
+
+  // 7 products and 7 post-additions
+  winogradRecursive(m2, k2, n2, a11, b11, p1, crossover);    // P1
+  winogradRecursive(m2, k2, n2, a12, b21, p2, crossover);    // P2
+  combine(m2, n2, p1, p2, 1.0, c11);                         // U1 = P1 + P2
+  winogradRecursive(m2, k2, n2, s2, t2, p2, crossover);      // P6
+  combine(m2, n2, p1, p2, 1.0, p1);                          // U2 = P1 + P6
+  winogradRecursive(m2, k2, n2, s3, t3, p2, crossover);      // P7
+  combine(m2, n2, p1, p2, 1.0, tmp);                         // U3 = U2 + P7
+  winogradRecursive(m2, k2, n2, s1, t1, p2, crossover);      // P5
+  combine(m2, n2, p1, p2, 1.0, p1);                          // U4 = U2 + P5
+  combine(m2, n2, tmp, p2, 1.0, c22);                        // U7 = U3 + P5
+  winogradRecursive(m2, k2, n2, s4, b22, p2, crossover);     // P3
+  combine(m2, n2, p1, p2, 1.0, c12);                         // U5 = U4 + P3
+  winogradRecursive(m2, k2, n2, a22, t4, p2, crossover);     // P4
+  combine(m2, n2, tmp, p2, -1.0, c21);                       // U6 = U3 - P4
+
+  // Dynamic peeling
+  if (k != ke) {
+    // C[0:me, 0:ne] += a[:, k-1] * b[k-1, :]
+    for (unsigned i = 0; i < me; i++) {
+      double a_ik = a.ptr[i * a.ld + ke];
+      for (unsigned j = 0; j < ne; j++)
+        c.ptr[i * c.ld + j] += a_ik * b.ptr[ke * b.ld + j];
+    }
+  }
+  if (n != ne) {
+    // Last column of C for the first me rows
+    for (unsigned i = 0; i < me; i++) {
+      double value = 0.0;
+      for (unsigned p = 0; p < k; p++)
+        value += a.ptr[i * a.ld + p] * b.ptr[p * b.ld + ne];
+      c.ptr[i * c.ld + ne] = value;
+    }
+  }
+  if (m != me) {
+    // Last row of C
+    double* c_row = c.ptr + me * c.ld;
+    std::fill(c_row, c_row + n, 0.0);
+    for (unsigned p = 0; p < k; p++) {
+      double a_mp = a.ptr[me * a.ld + p];
+      for (unsigned j = 0; j < n; j++)
+        c_row[j] += a_mp * b.ptr[p * b.ld + j];
+    }
+  }
+}
+
+std::vector<double> winogradWithCrossover(const std::vector<double>& a, const std::vector<double>& b,
+                                          unsigned int sz, unsigned int crossover) {
+  if (a.size() != sz * sz || b.size() != sz * sz)
+    throw std::invalid_argument("Matrix size does not match sz");
+  std::vector<double> res(sz * sz);
+  if (sz > 0)
+    winogradRecursive(sz, sz, sz, ConstBlock(a.data(), sz), ConstBlock(b.data(), sz), {res.data(), sz},
+                      crossover);
+  return res;
+}
+
+}  // namespace
+
+std::vector<double> winogradMultiplication(const std::vector<double>& a, const std::vector<double>& b,
+                                           unsigned int sz) {
+  return winogradWithCrossover(a, b, sz, getWinogradCrossover());
+}
+
+std::string winogradCachePath() {
+  if (const char* path = std::getenv("WINOGRAD_CROSSOVER_CACHE"))
+    return path;
+  const char* dir = std::getenv("TMPDIR");
+  if (!dir) dir = std::getenv("TEMP");
+  if (!dir) dir = std::getenv("TMP");
+  return std::string(dir ? dir : ".") + "/kriukov_winograd_crossover.txt";
+}
+
+unsigned int getWinogradCrossover() {
+  if (winograd_crossover == 0)
+    tuneWinogradCrossover(winogradCachePath());
+  return winograd_crossover;
+}
+
+void setWinogradCrossover(unsigned int crossover) {
+  if (crossover == 0)
+    throw std::invalid_argument("Crossover must be > 0");
+  winograd_crossover = crossover;
+}
+
+unsigned int tuneWinogradCrossover(const std::string& cache_path, unsigned int probe_sz) {
+  std::ifstream cache(cache_path);
+  unsigned int stored = 0;
+  if (cache >> stored && stored > 0) {
+    winograd_crossover = stored;
+    return stored;
+  }
+
+  std::vector<double> a = getRandomMatrix(probe_sz);
+  std::vector<double> b = getRandomMatrix(probe_sz);
+  double best_time = std::numeric_limits<double>::max();
+  unsigned int best = winograd_crossover > 0 ? winograd_crossover : kDefaultCrossover;
+  for (unsigned int candidate = 16; candidate <= 256 && candidate < probe_sz; candidate *= 2) {
+    clock_t start = clock();
+    winogradWithCrossover(a, b, probe_sz, candidate);
+    double seconds = static_cast<double>(clock() - start) / CLOCKS_PER_SEC;
+    if (seconds < best_time) {
+      best_time = seconds;
+      best = candidate;
+    }
+  }
+
+  std::ofstream out(cache_path);
+  out << best << std::endl;
+  winograd_crossover = best;
+  return best;
+}
@@ -2,6 +2,7 @@
 #ifndef MODULES_TASK_1_KRIUKOV_STRASSEN_ALGORITHM_STRASSEN_ALGORITHM_H_
 #define MODULES_TASK_1_KRIUKOV_STRASSEN_ALGORITHM_STRASSEN_ALGORITHM_H_
 
+#include <string>
 #include <vector>
 
 std::vector<double> getRandomMatrix(int  sz);
@@ -20,4 +21,21 @@ std::vector<double> toPowerOfTwoSize(const std::vector<double>& mtx, unsigned* p
 std::vector<double> toPowerOfTwoSize(const std::vector<double>& mtx, unsigned int sz);
 std::vector<double> matrixReduce(const std::vector<double>& mtx, unsigned int sz);
 
+// Strassen-Winograd (7 multiplications, 15 additions) for any size: odd rows or
+// columns are peeled off and handled by rank-1 / matrix-vector fix-ups instead of
+// padding to a power of two. Blocks whose smallest dimension does not exceed the
+// crossover are multiplied by a blocked classical kernel.
+std::vector<double> winogradMultiplication(const std::vector<double>& a, const std::vector<double>& b,
+                                           unsigned int sz);
+// The crossover is tuned on first use unless it was set before: the first
+// winogradMultiplication or getWinogradCrossover call of a run loads it from
+// winogradCachePath(), and only the first run on a machine measures it.
+unsigned int getWinogradCrossover();
+void setWinogradCrossover(unsigned int crossover);
+// $WINOGRAD_CROSSOVER_CACHE, or kriukov_winograd_crossover.txt in the temp directory
+std::string winogradCachePath();
+// Loads the crossover stored in cache_path, or measures the candidates on a
+// probe_sz x probe_sz product, stores the fastest in cache_path and returns it.
+unsigned int tuneWinogradCrossover(const std::string& cache_path, unsigned int probe_sz = 512);
+
 #endif  // MODULES_TASK_1_KRIUKOV_STRASSEN_ALGORITHM_STRASSEN_ALGORITHM_H_
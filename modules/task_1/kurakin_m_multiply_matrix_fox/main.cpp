@@ -156,6 +156,43 @@ TEST(Multiply_Matrix_Fox, Fox_Alg_Matrix_Mult_Works_Properly) {
         }
     }
 }
+
+TEST(Multiply_Matrix_Fox, Dense_Matrix_Round_Trip) {
+    matrix a;
+    initMatrixRand(&a, 3, 5);
+
+    EXPECT_EQ(a, DenseMatrix(a).toMatrix());
+}
+
+TEST(Multiply_Matrix_Fox, Dense_Simple_And_Fox_Match_Matrix_Version) {
+    matrix a, b, res;
+    DenseMatrix simpleRes, foxRes;
+    uint size = 9;
+    initMatrixRand(&a, size, size);
+    initMatrixRand(&b, size, size);
+
+    simpleMaxtrixMultiply(a, b, &res);
+    EXPECT_TRUE(simpleMaxtrixMultiply(DenseMatrix(a), DenseMatrix(b), &simpleRes));
+    EXPECT_TRUE(algFoxMatrixMultiply(DenseMatrix(a), DenseMatrix(b), &foxRes));
+
+    for (uint i = 0; i < size; i++) {
+        for (uint j = 0; j < size; j++) {
+            EXPECT_NEAR(res[i][j], simpleRes(i, j), 1e-6);
+            EXPECT_NEAR(res[i][j], foxRes(i, j), 1e-6);
+        }
+    }
+}
+
+TEST(Multiply_Matrix_Fox, Dense_Simple_Multiplication_Of_Not_Square_Matrix) {
+    DenseMatrix a(matrix{{1, 2, 3}, {4, 5, 6}});
+    DenseMatrix b(matrix{{1}, {2}, {3}});
+    DenseMatrix res;
+
+    EXPECT_TRUE(simpleMaxtrixMultiply(a, b, &res));
+    EXPECT_EQ(res.toMatrix(), (matrix{{14}, {32}}));
+    EXPECT_FALSE(algFoxMatrixMultiply(a, b, &res));
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,6 +1,7 @@
 // Copyright 2020 Kurakin Mikhail
 #include "../../../modules/task_1/kurakin_m_multiply_matrix_fox/multiply_matrix_fox.h"
 #include <math.h>
+#include <algorithm>
 #include <random>
 #include <vector>
 bool canMultiplicate(const matrix &a, const matrix &b) {
@@ -90,3 +91,54 @@ bool algFoxMatrixMultiply(const matrix &a, const matrix &b, matrix *out) {
     }
     return true;
 }
+
+DenseMatrix::DenseMatrix(const matrix &a) : DenseMatrix(a.size(), a.empty() ? 0 : a[0].size()) {
+    for (uint i = 0; i < rows_; i++) {
+        std::copy(a[i].begin(), a[i].begin() + std::min<size_t>(a[i].size(), cols_), row(i));
+    }
+}
+
+matrix DenseMatrix::toMatrix() const {
+    matrix a(rows_);
+    for (uint i = 0; i < rows_; i++) {
+        a[i].assign(row(i), row(i) + cols_);
+    }
+    return a;
+}
+
+bool simpleMaxtrixMultiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix *out) {
+    if (a.rows() == 0 || b.rows() == 0 || a.cols() != b.rows()) return false;
+    *out = DenseMatrix(a.rows(), b.cols());
+    for (uint i = 0; i < a.rows(); i++) {
+        double *outRow = out->row(i);
+        for (uint j = 0; j < a.cols(); j++) {
+            const double aij = a(i, j);
+            const double *bRow = b.row(j);
+            for (uint k = 0; k < b.cols(); k++) {
+                outRow[k] += aij * bRow[k];
+            }
+        }
+    }
+    return true;
+}
+
+// Same steps as the matrix version on a 1x1 grid: at step i row j of the
+// result takes a[j][s] times row s of b, s = (i + j) % size. The row of b is
+// read in place instead of being copied into bBlock first
+bool algFoxMatrixMultiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix *out) {
+    uint size = a.rows();
+    if (size == 0 || a.cols() != size || b.rows() != size || b.cols() != size) return false;
+    *out = DenseMatrix(size, size);
+    for (uint i = 0; i < size; i++) {
+        for (uint j = 0; j < size; j++) {
+            uint s = (i + j) % size;
+            const double ajs = a(j, s);
+            const double *bRow = b.row(s);
+            double *outRow = out->row(j);
+            for (uint k = 0; k < size; k++) {
+                outRow[k] += ajs * bRow[k];
+            }
+        }
+    }
+    return true;
+}
@@ -13,4 +13,30 @@ bool simpleMaxtrixMultiply(const matrix &a, const matrix &b, matrix *out);
 bool canUseFoxAlg(const matrix &a, const matrix &b);
 bool algFoxMatrixMultiply(const matrix &a, const matrix &b, matrix *out);
 
+// Row-major matrix in one allocation, element (i, j) is at i * cols + j;
+// built from a matrix, rows shorter than the first one are zero-filled
+class DenseMatrix {
+ public:
+    DenseMatrix() : rows_(0), cols_(0) {}
+    DenseMatrix(uint rows, uint cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0) {}
+    explicit DenseMatrix(const matrix &a);
+
+    uint rows() const { return rows_; }
+    uint cols() const { return cols_; }
+    double* row(uint i) { return data_.data() + i * cols_; }
+    const double* row(uint i) const { return data_.data() + i * cols_; }
+    double& operator()(uint i, uint j) { return data_[i * cols_ + j]; }
+    const double& operator()(uint i, uint j) const { return data_[i * cols_ + j]; }
+
+    matrix toMatrix() const;
+
+ private:
+    uint rows_;
+    uint cols_;
+    std::vector<double> data_;
+};
+
+bool simpleMaxtrixMultiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix *out);
+bool algFoxMatrixMultiply(const DenseMatrix &a, const DenseMatrix &b, DenseMatrix *out);
+
 #endif  // MODULES_TASK_1_KURAKIN_M_MULTIPLY_MATRIX_FOX_MULTIPLY_MATRIX_FOX_H_
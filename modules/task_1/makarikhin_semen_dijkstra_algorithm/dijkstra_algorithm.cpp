@@ -1,9 +1,13 @@
 // Copyright 2020 Makarikhin Semen
+#include <limits.h>
 #include <random>
 #include <ctime>
 #include <vector>
 #include <iostream>
 #include <deque>
+#include <functional>
+#include <queue>
+#include <utility>
 #include "../../../modules/task_1/makarikhin_semen_dijkstra_algorithm/dijkstra_algorithm.h"
 
 Graph::Graph(int vertex_n) :vertex_num(vertex_n) {
@@ -75,3 +79,43 @@ std::vector<int> Dijkstra(const Graph& g, int selected_vertex) {
   return distance;
 }
 
+
+CsrGraph::CsrGraph(const Graph& g) :vertex_num(g.vertex_num) {
+  offset.resize(vertex_num + 1, 0);
+  for (int i = 0; i < vertex_num; i++) {
+    offset[i + 1] = offset[i];
+    for (int j = 0; j < vertex_num; j++)
+      if (g.weight_list[i][j] && i != j) {
+        neighbor.push_back(j);
+        weight.push_back(g.weight_list[i][j]);
+        offset[i + 1]++;
+      }
+  }
+}
+
+std::vector<int> Dijkstra(const CsrGraph& g, int selected_vertex) {
+  if (selected_vertex < 0 || selected_vertex > g.vertex_num-1) {
+    throw std::out_of_range("out of range selected vertex");
+  }
+
+  std::vector<int> distance(g.vertex_num, INT_MAX);
+  std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
+    std::greater<std::pair<int, int>>> queue;
+  distance[selected_vertex] = 0;
+  queue.push(std::make_pair(0, selected_vertex));
+
+  while (!queue.empty()) {
+    int cur_dist = queue.top().first;
+    int cur_vert = queue.top().second;
+    queue.pop();
+    if (cur_dist > distance[cur_vert])
+      continue;
+    for (int e = g.offset[cur_vert]; e < g.offset[cur_vert + 1]; e++)
+      if (cur_dist + g.weight[e] < distance[g.neighbor[e]]) {
+        distance[g.neighbor[e]] = cur_dist + g.weight[e];
+        queue.push(std::make_pair(distance[g.neighbor[e]], g.neighbor[e]));
+      }
+  }
+
+  return distance;
+}
@@ -10,7 +10,19 @@ struct Graph {
   explicit Graph(int vertex_n);
 };
 
+// Compressed sparse row storage of the same graph, only real edges are kept
+struct CsrGraph {
+  std::vector<int> offset;
+  std::vector<int> neighbor;
+  std::vector<int> weight;
+  int vertex_num;
+
+  explicit CsrGraph(const Graph& g);
+};
+
 Graph get_Random_Graph(const int& vertex_n, const int& edge_n);
 std::vector<int> Dijkstra(const Graph& g, int selected_vertex);
+// Unreachable vertices get INT_MAX, distances are not limited by INT8_MAX
+std::vector<int> Dijkstra(const CsrGraph& g, int selected_vertex);
 
 #endif  // MODULES_TASK_1_MAKARIKHIN_SEMEN_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
@@ -68,6 +68,59 @@ TEST(Dijkstra_Algorithm, Test_Out_Serch_Vertex) {
   ASSERT_ANY_THROW(Dijkstra(g, 14));
 }
 
+TEST(Dijkstra_Algorithm, Test_Csr_Graph_Conversion) {
+  Graph g(4);
+  g.weight_list = { {0, 19, 0, 7},
+                    {19, 0, 4, 32},
+                    {0, 4, 0, 1},
+                    {7, 32, 1, 0}};
+  CsrGraph csr(g);
+  std::vector<int> offset = { 0, 2, 5, 7, 10 };
+  std::vector<int> neighbor = { 1, 3, 0, 2, 3, 1, 3, 0, 1, 2 };
+  std::vector<int> weight = { 19, 7, 19, 4, 32, 4, 1, 7, 32, 1 };
+
+  ASSERT_EQ(csr.offset, offset);
+  ASSERT_EQ(csr.neighbor, neighbor);
+  ASSERT_EQ(csr.weight, weight);
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Const_Six_Vertex_Graph) {
+  int vertex = 6;
+  Graph g(vertex);
+  std::vector <int> res = { 0, 1, 4, 10, 2, 10 };
+  g.weight_list = {
+                    {0, 1, 4, 0, 2, 0},
+                    {1, 0, 0, 9, 0, 0},
+                    {4, 0, 0, 7, 0, 0},
+                    {0, 9, 7, 0, 0, 2},
+                    {2, 0, 0, 0, 0, 8},
+                    {0, 0, 0, 2, 8, 0} };
+
+  ASSERT_EQ(Dijkstra(CsrGraph(g), 0), res);
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Equals_Dense_On_Random_Graph) {
+  int vertex = 60;
+  int edge = 300;
+  Graph g = get_Random_Graph(vertex, edge);
+  std::vector<int> dense = Dijkstra(g, 0);
+  std::vector<int> csr = Dijkstra(CsrGraph(g), 0);
+
+  for (int i = 0; i < vertex; i++) {
+    if (dense[i] != INT8_MAX) {
+      ASSERT_EQ(dense[i], csr[i]);
+    } else {
+      ASSERT_GE(csr[i], INT8_MAX);
+    }
+  }
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Out_Of_Range_Vertex) {
+  Graph g(3);
+
+  ASSERT_ANY_THROW(Dijkstra(CsrGraph(g), 3));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
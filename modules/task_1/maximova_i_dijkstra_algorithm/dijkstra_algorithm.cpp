@@ -2,6 +2,8 @@
 #include "../../../modules/task_1/maximova_i_dijkstra_algorithm/dijkstra_algorithm.h"
 #include <limits.h>
 #include <ctime>
+#include <functional>
+#include <queue>
 #include <random>
 #include <stdexcept>
 #include <utility>
@@ -85,3 +87,89 @@ std::vector<int> SeqDijkstraAlg(const Graph& graph, int sourceVertex) {
 
   return dist;
 }
+
+CsrGraph::CsrGraph(const Graph& graph) {
+  std::vector<std::vector<int>> linkedList = graph.getLinkedList();
+  numVertex = linkedList.size();
+
+  std::vector<Edge> edges;
+  for (int i = 0; i < numVertex; ++i)
+    for (int j = i + 1; j < numVertex; ++j)
+      if (linkedList[i][j] != INT8_MAX) edges.push_back({i, j, linkedList[i][j]});
+  build(edges);
+}
+
+CsrGraph::CsrGraph(int _numVertex, const std::vector<Edge>& edges) {
+  if (_numVertex <= 0)
+    throw std::runtime_error("The number of vertex must be > 0");
+  numVertex = _numVertex;
+  for (const Edge& edge : edges)
+    if (edge.a < 0 || edge.a >= numVertex || edge.b < 0 || edge.b >= numVertex)
+      throw std::runtime_error("Wrong edge vertex");
+  build(edges);
+}
+
+void CsrGraph::build(const std::vector<Edge>& edges) {
+  offset.assign(numVertex + 1, 0);
+  for (const Edge& edge : edges) {
+    ++offset[edge.a + 1];
+    ++offset[edge.b + 1];
+  }
+  for (int v = 0; v < numVertex; ++v) offset[v + 1] += offset[v];
+
+  neighbor.resize(offset[numVertex]);
+  weight.resize(offset[numVertex]);
+  std::vector<int> pos(offset.begin(), offset.end() - 1);
+  for (const Edge& edge : edges) {
+    neighbor[pos[edge.a]] = edge.b;
+    weight[pos[edge.a]++] = edge.weight;
+    neighbor[pos[edge.b]] = edge.a;
+    weight[pos[edge.b]++] = edge.weight;
+  }
+}
+
+CsrGraph createRandCsrGraph(int numVertex, int numEdges) {
+  if (numVertex <= 1 || numEdges < 0)
+    throw std::runtime_error("Wrong graph size");
+
+  std::mt19937 gen;
+  gen.seed(static_cast<unsigned int>(time(0)));
+  std::vector<Edge> edges(numEdges);
+  for (Edge& edge : edges) {
+    edge.a = gen() % numVertex;
+    edge.b = (edge.a + 1 + gen() % (numVertex - 1)) % numVertex;
+    edge.weight = gen() % 100 + 1;
+  }
+
+  return CsrGraph(numVertex, edges);
+}
+
+std::vector<int> SeqDijkstraAlg(const CsrGraph& graph, int sourceVertex) {
+  int numVertex = graph.getNumVertex();
+  if (sourceVertex < 0 || sourceVertex >= numVertex)
+    throw std::runtime_error("Wrong source vertex");
+  const std::vector<int>& offset = graph.getOffset();
+  const std::vector<int>& neighbor = graph.getNeighbor();
+  const std::vector<int>& weight = graph.getWeight();
+
+  std::vector<int> dist(numVertex, INT_MAX);
+  std::priority_queue<std::pair<int, int>, std::vector<std::pair<int, int>>,
+                      std::greater<std::pair<int, int>>> queue;
+  dist[sourceVertex] = 0;
+  queue.push(std::make_pair(0, sourceVertex));
+
+  while (!queue.empty()) {
+    int vertex = queue.top().second;
+    int vertexDist = queue.top().first;
+    queue.pop();
+    if (vertexDist > dist[vertex]) continue;
+
+    for (int e = offset[vertex]; e < offset[vertex + 1]; ++e)
+      if (vertexDist + weight[e] < dist[neighbor[e]]) {
+        dist[neighbor[e]] = vertexDist + weight[e];
+        queue.push(std::make_pair(dist[neighbor[e]], neighbor[e]));
+      }
+  }
+
+  return dist;
+}
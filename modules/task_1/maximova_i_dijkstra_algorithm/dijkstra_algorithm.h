@@ -2,6 +2,7 @@
 #ifndef MODULES_TASK_1_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
 #define MODULES_TASK_1_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
 
+#include <utility>
 #include <vector>
 
 class Graph {
@@ -17,6 +18,38 @@ class Graph {
   std::vector<std::vector<int>> getLinkedList() const;
 };
 
+struct Edge {
+  int a;
+  int b;
+  int weight;
+};
+
+// Compressed sparse row graph: the neighbors of vertex v are
+// neighbor[offset[v]] .. neighbor[offset[v + 1] - 1]
+class CsrGraph {
+ private:
+  std::vector<int> offset;
+  std::vector<int> neighbor;
+  std::vector<int> weight;
+  int numVertex;
+
+  void build(const std::vector<Edge>& edges);
+
+ public:
+  explicit CsrGraph(const Graph& graph);
+  CsrGraph(int _numVertex, const std::vector<Edge>& edges);
+  int getNumVertex() const { return numVertex; }
+  int getNumEdges() const { return static_cast<int>(neighbor.size()) / 2; }
+  const std::vector<int>& getOffset() const { return offset; }
+  const std::vector<int>& getNeighbor() const { return neighbor; }
+  const std::vector<int>& getWeight() const { return weight; }
+};
+
+CsrGraph createRandCsrGraph(int numVertex, int numEdges);
+
   std::vector<int> SeqDijkstraAlg(const Graph& graph, int sourceVertex);
+// Heap-based Dijkstra over real edges only. Distances are not limited by
+// INT8_MAX, unreachable vertices get INT_MAX
+std::vector<int> SeqDijkstraAlg(const CsrGraph& graph, int sourceVertex);
 
 #endif  // MODULES_TASK_1_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
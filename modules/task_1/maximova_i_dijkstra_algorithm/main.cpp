@@ -1,5 +1,6 @@
 // Copyright 2020 Maximova Irina
 #include <gtest/gtest.h>
+#include <limits.h>
 #include <vector>
 #include "./dijkstra_algorithm.h"
 
@@ -94,6 +95,75 @@ TEST(Dijkstra_Algorithm, Test_Right_Execute_Seq_Dijkstra_Alg_Unlinked_Graph) {
   ASSERT_EQ(algRes, currentRes);
 }
 
+TEST(Dijkstra_Algorithm, Test_Csr_Graph_From_Graph) {
+  Graph graph(4, 3);
+  graph.putEdge(0, 1, 3);
+  graph.putEdge(1, 2, 5);
+  graph.putEdge(3, 1, 2);
+  CsrGraph csrGraph(graph);
+
+  std::vector<int> offset = {0, 1, 4, 5, 6};
+  std::vector<int> neighbor = {1, 0, 2, 3, 1, 1};
+  std::vector<int> weight = {3, 3, 5, 2, 5, 2};
+  ASSERT_EQ(csrGraph.getNumEdges(), 3);
+  ASSERT_EQ(csrGraph.getOffset(), offset);
+  ASSERT_EQ(csrGraph.getNeighbor(), neighbor);
+  ASSERT_EQ(csrGraph.getWeight(), weight);
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Graph_Error_Wrong_Edge) {
+  std::vector<Edge> edges = {{0, 1, 3}, {1, 5, 2}};
+
+  ASSERT_ANY_THROW(CsrGraph csrGraph(5, edges));
+}
+
+TEST(Dijkstra_Algorithm, Test_Right_Execute_Csr_Dijkstra_Alg_Unlinked_Graph) {
+  std::vector<Edge> edges = {{4, 1, 2}, {4, 2, 1}, {4, 3, 1}, {3, 2, 4}};
+  CsrGraph csrGraph(5, edges);
+  std::vector<int> algRes = SeqDijkstraAlg(csrGraph, 1);
+  std::vector<int> currentRes = {INT_MAX, 0, 3, 3, 2};
+
+  ASSERT_EQ(algRes, currentRes);
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Dijkstra_Alg_Equals_Dense) {
+  int numVertex = 100;
+  int numEdges = 400;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> denseRes = SeqDijkstraAlg(graph, sourceVertex);
+  std::vector<int> csrRes = SeqDijkstraAlg(CsrGraph(graph), sourceVertex);
+
+  for (int v = 0; v < numVertex; ++v) {
+    if (denseRes[v] != INT8_MAX) {
+      ASSERT_EQ(denseRes[v], csrRes[v]);
+    } else {
+      ASSERT_GE(csrRes[v], INT8_MAX);
+    }
+  }
+}
+
+TEST(Dijkstra_Algorithm, Test_Csr_Dijkstra_Alg_Large_Sparse_Graph) {
+  int numVertex = 100000;
+  int numEdges = 400000;
+  CsrGraph csrGraph = createRandCsrGraph(numVertex, numEdges);
+
+  std::vector<int> dist = SeqDijkstraAlg(csrGraph, 0);
+  const std::vector<int>& offset = csrGraph.getOffset();
+  const std::vector<int>& neighbor = csrGraph.getNeighbor();
+  const std::vector<int>& weight = csrGraph.getWeight();
+
+  ASSERT_EQ(dist[0], 0);
+  for (int v = 0; v < numVertex; ++v) {
+    if (dist[v] == INT_MAX) continue;
+    for (int e = offset[v]; e < offset[v + 1]; ++e) {
+      ASSERT_LE(dist[neighbor[e]], dist[v] + weight[e]);
+    }
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
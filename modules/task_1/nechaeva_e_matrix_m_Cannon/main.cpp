@@ -67,3 +67,36 @@ TEST(Matrix_Cannon, the_same_results_of_the_mult) {
 
     ASSERT_TRUE(CompareMatrix(NaiveMulti(A, B), BlockMulti(A, B, 2)));
 }
+
+TEST(Matrix_Cannon, dense_matrix_round_trip) {
+    matrix A = RandomMatrix(5);
+
+    ASSERT_EQ(A, DenseMatrix(A).toMatrix());
+}
+
+TEST(Matrix_Cannon, dense_naive_and_block_mult_match_matrix_version) {
+    matrix A = RandomMatrix(10);
+    matrix B = RandomMatrix(10);
+    matrix rez = NaiveMulti(A, B);
+
+    ASSERT_TRUE(CompareMatrix(rez, NaiveMulti(DenseMatrix(A), DenseMatrix(B)).toMatrix()));
+    ASSERT_TRUE(CompareMatrix(rez, BlockMulti(DenseMatrix(A), DenseMatrix(B), 3).toMatrix()));
+}
+
+TEST(Matrix_Cannon, dense_naive_mult_of_non_square_matrices) {
+    matrix A = {{1.5, 1.7, 2.5},
+                {3.7, 37.8, 2.5}};
+    matrix B = {{1.0},
+                {2.0},
+                {3.0}};
+    matrix rez = {{12.4},
+                  {86.8}};
+
+    ASSERT_TRUE(CompareMatrix(rez, NaiveMulti(DenseMatrix(A), DenseMatrix(B)).toMatrix()));
+}
+
+TEST(Matrix_Cannon, throw_when_dense_block_mult_with_different_size) {
+    DenseMatrix A(3, 3), B(5, 5);
+
+    ASSERT_ANY_THROW(BlockMulti(A, B, 2));
+}
@@ -91,3 +91,63 @@ matrix BlockMulti(const matrix &A, const matrix &B, const int &blockSize) {
 
     return rez;
 }
+
+DenseMatrix::DenseMatrix(const matrix &M) : DenseMatrix(M.size(), M.empty() ? 0 : M[0].size()) {
+    for (size_t i = 0; i < rows_; i++) {
+        if (M[i].size() != cols_)
+            throw std::invalid_argument("Rows have different size");
+        std::copy(M[i].begin(), M[i].end(), row(i));
+    }
+}
+
+matrix DenseMatrix::toMatrix() const {
+    matrix rez(rows_);
+    for (size_t i = 0; i < rows_; i++)
+        rez[i].assign(row(i), row(i) + cols_);
+    return rez;
+}
+
+DenseMatrix NaiveMulti(const DenseMatrix &A, const DenseMatrix &B) {
+    if (A.cols() != B.rows())
+        throw std::invalid_argument("Different values for col and row");
+
+    DenseMatrix rez(A.rows(), B.cols());
+    for (size_t i = 0; i < A.rows(); i++) {
+        double* r = rez.row(i);
+        for (size_t k = 0; k < A.cols(); k++) {
+            const double a = A(i, k);
+            const double* b = B.row(k);
+            for (size_t j = 0; j < B.cols(); j++)
+                r[j] += a * b[j];
+        }
+    }
+
+    return rez;
+}
+
+DenseMatrix BlockMulti(const DenseMatrix &A, const DenseMatrix &B, const int &blockSize) {
+    if (A.cols() != B.rows() || A.rows() != A.cols() || B.rows() != B.cols())
+        throw std::invalid_argument("Different values for col and row");
+    int n = A.rows();
+    if (blockSize <= 0 || blockSize > n)
+        throw std::invalid_argument("Wrong blockSize");
+
+    DenseMatrix rez(n, n);
+    for (int jj = 0; jj < n; jj += blockSize) {
+        int jjMin = std::min(jj + blockSize, n);
+        for (int kk = 0; kk < n; kk += blockSize) {
+            int kkMin = std::min(kk + blockSize, n);
+            for (int i = 0; i < n; i++) {
+                double* r = rez.row(i);
+                for (int k = kk; k < kkMin; k++) {
+                    const double a = A(i, k);
+                    const double* b = B.row(k);
+                    for (int j = jj; j < jjMin; j++)
+                        r[j] += a * b[j];
+                }
+            }
+        }
+    }
+
+    return rez;
+}
@@ -2,6 +2,7 @@
 #ifndef MODULES_TASK_1_NECHAEVA_E_MATRIX_M_CANNON_MATRIX_M_CANNON_H_
 #define MODULES_TASK_1_NECHAEVA_E_MATRIX_M_CANNON_MATRIX_M_CANNON_H_
 
+#include <cstddef>
 #include <vector>
 #include <complex>
 #include <iostream>
@@ -17,4 +18,28 @@ matrix BlockMulti(const matrix &A, const matrix &B, const int &blockSize);
 bool CompareMatrix(const matrix &A, const matrix &B);
 bool CompareValues(const double &a, const double &b);
 
+// Row-major matrix in one allocation, element (i, j) is at i * cols + j
+class DenseMatrix {
+ public:
+    DenseMatrix(size_t rows, size_t cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0) {}
+    explicit DenseMatrix(const matrix &M);
+
+    size_t rows() const { return rows_; }
+    size_t cols() const { return cols_; }
+    double* row(size_t i) { return data_.data() + i * cols_; }
+    const double* row(size_t i) const { return data_.data() + i * cols_; }
+    double& operator()(size_t i, size_t j) { return data_[i * cols_ + j]; }
+    const double& operator()(size_t i, size_t j) const { return data_[i * cols_ + j]; }
+
+    matrix toMatrix() const;
+
+ private:
+    size_t rows_;
+    size_t cols_;
+    std::vector<double> data_;
+};
+
+DenseMatrix NaiveMulti(const DenseMatrix &A, const DenseMatrix &B);
+DenseMatrix BlockMulti(const DenseMatrix &A, const DenseMatrix &B, const int &blockSize);
+
 #endif  // MODULES_TASK_1_NECHAEVA_E_MATRIX_M_CANNON_MATRIX_M_CANNON_H_
@@ -136,6 +136,80 @@ TEST(multi_matrix, TEST_EQUAL_NOT_RANDOM_CCS_MATRIX_EXAMPLE_2) {
 
 
 
+TEST(multi_matrix, TEST_PLAN_MULTIPLICATION_EQUAL_TO_MULTIPLY) {
+    std::vector<std::complex<double>> valueA {{4}, {3}, {5}, {3}, {7}};
+    std::vector<int> row_indexA {0, 1, 1, 0, 2};
+    std::vector<int> col_ptrA {0, 2, 3, 5};
+    SparseMatrixCCS A(3, 3, valueA, row_indexA, col_ptrA);
+
+    std::vector<std::complex<double>> valueB {{7}, {2}, {2}, {3}};
+    std::vector<int> row_indexB {0, 2, 1, 1};
+    std::vector<int> col_ptrB {0, 2, 3, 4};
+    SparseMatrixCCS B(3, 3, valueB, row_indexB, col_ptrB);
+
+    SparseMultiplyPlan plan = SparseMatrixCCS::PlanMultiply(A, B);
+    SparseMatrixCCS result = SparseMatrixCCS::MultiplySparseMatrix(plan, A, B);
+    EXPECT_TRUE(SparseMatrixCCS::MultiplySparseMatrix(A, B) == result);
+}
+
+mtxComplex patternMatrix(size_t m, size_t n, int seed) {
+    mtxComplex mt(m, std::vector<std::complex<double>>(n));
+    for (size_t i = 0; i < m; i++)
+        for (size_t j = 0; j < n; j++)
+            if ((i * 7 + j * 3) % 5 == 0)
+                mt[i][j] = {1 + 0.1 * ((i + j + seed) % 13),
+                            0.01 * ((i * j + seed) % 10)};
+    return mt;
+}
+
+TEST(multi_matrix, TEST_PLAN_REFRESH_WITH_NEW_VALUES) {
+    SparseMatrixCCS A(patternMatrix(20, 30, 0));
+    SparseMatrixCCS B(patternMatrix(30, 25, 0));
+    A = A.transpose();
+    B = B.transpose();
+    SparseMultiplyPlan plan = SparseMatrixCCS::PlanMultiply(A, B);
+
+    for (int seed = 1; seed <= 3; seed++) {
+        SparseMatrixCCS newA(patternMatrix(20, 30, seed));
+        SparseMatrixCCS newB(patternMatrix(30, 25, seed));
+        newA = newA.transpose();
+        newB = newB.transpose();
+        SparseMatrixCCS expect = SparseMatrixCCS::MultiplySparseMatrix(newA,
+                                                                       newB);
+        SparseMatrixCCS result = SparseMatrixCCS::MultiplySparseMatrix(plan,
+                                                                       newA,
+                                                                       newB);
+        EXPECT_TRUE(expect == result);
+    }
+}
+
+TEST(multi_matrix, TEST_PLAN_WRONG_MATRICES) {
+    SparseMatrixCCS A(patternMatrix(4, 3, 0));
+    SparseMatrixCCS B(patternMatrix(3, 5, 0));
+    A = A.transpose();
+    B = B.transpose();
+    EXPECT_ANY_THROW(SparseMatrixCCS::PlanMultiply(B, A));
+    SparseMultiplyPlan plan = SparseMatrixCCS::PlanMultiply(A, B);
+    EXPECT_ANY_THROW(SparseMatrixCCS::MultiplySparseMatrix(plan, A, A));
+}
+
+TEST(multi_matrix, TEST_PLAN_SAME_NONZERO_OTHER_PATTERN) {
+    mtxComplex diag(6, std::vector<std::complex<double>>(6));
+    mtxComplex antiDiag(6, std::vector<std::complex<double>>(6));
+    for (size_t i = 0; i < 6; i++) {
+        diag[i][i] = {1, 1};
+        antiDiag[i][5 - i] = {1, 1};
+    }
+    // as many nonzeros as diag, in other positions
+    SparseMatrixCCS A(diag), other(antiDiag);
+    SparseMatrixCCS B(patternMatrix(6, 6, 0));
+    SparseMultiplyPlan plan = SparseMatrixCCS::PlanMultiply(A, B);
+    SparseMultiplyPlan planB = SparseMatrixCCS::PlanMultiply(B, A);
+    EXPECT_ANY_THROW(SparseMatrixCCS::MultiplySparseMatrix(plan, other, B));
+    EXPECT_ANY_THROW(SparseMatrixCCS::MultiplySparseMatrix(planB, B, other));
+    EXPECT_NO_THROW(SparseMatrixCCS::MultiplySparseMatrix(plan, A, B));
+}
+
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
@@ -1,6 +1,7 @@
 // Copyright 2020 Shemetov Philipp
 
 
+#include <algorithm>
 #include <cmath>
 #include <random>
 #include <iostream>
@@ -161,6 +162,82 @@ SparseMatrixCCS SparseMatrixCCS::MultiplySparseMatrix(
 }
 
 
+SparseMultiplyPlan SparseMatrixCCS::PlanMultiply(
+        const SparseMatrixCCS &A, const SparseMatrixCCS &B) {
+    if (A.n != B.m) {
+        throw "Error(Size col matrix A not equal size row matrix B)";
+    }
+    SparseMultiplyPlan plan;
+    plan.m = A.m;
+    plan.n = B.n;
+    plan.row_index_A = A.row_index;
+    plan.col_offsets_A = A.col_offsets;
+    plan.row_index_B = B.row_index;
+    plan.col_offsets_B = B.col_offsets;
+    plan.col_offsets.push_back(0);
+    plan.term_offsets.push_back(0);
+    std::vector<int> marker(A.m, -1);
+    std::vector<int> position(A.m);
+    int tempRowA;
+
+    for (size_t j = 0; j < B.n; j++) {
+        size_t colStart = plan.row_index.size();
+        for (int k = B.col_offsets[j]; k < B.col_offsets[j + 1]; k++) {
+            tempRowA = B.row_index[k];
+            for (int i = A.col_offsets[tempRowA];
+                 i < A.col_offsets[tempRowA + 1]; i++) {
+                if (marker[A.row_index[i]] != static_cast<int>(j)) {
+                    marker[A.row_index[i]] = j;
+                    plan.row_index.push_back(A.row_index[i]);
+                }
+            }
+        }
+        std::sort(plan.row_index.begin() + colStart, plan.row_index.end());
+        for (size_t count = colStart; count < plan.row_index.size(); count++)
+            position[plan.row_index[count]] = count;
+        for (int k = B.col_offsets[j]; k < B.col_offsets[j + 1]; k++) {
+            tempRowA = B.row_index[k];
+            for (int i = A.col_offsets[tempRowA];
+                 i < A.col_offsets[tempRowA + 1]; i++) {
+                plan.term_pos.push_back(position[A.row_index[i]]);
+            }
+        }
+        plan.col_offsets.push_back(plan.row_index.size());
+        plan.term_offsets.push_back(plan.term_pos.size());
+    }
+    return plan;
+}
+
+SparseMatrixCCS SparseMatrixCCS::MultiplySparseMatrix(
+        const SparseMultiplyPlan &plan,
+        const SparseMatrixCCS &A, const SparseMatrixCCS &B) {
+    // Equal sizes are not enough: another pattern with as many nonzeros
+    // would send the products to wrong positions of term_pos
+    if (A.m != plan.m || A.n != B.m || B.n != plan.n ||
+        A.row_index != plan.row_index_A || A.col_offsets != plan.col_offsets_A ||
+        B.row_index != plan.row_index_B || B.col_offsets != plan.col_offsets_B ||
+        A.value.size() != A.row_index.size() || B.value.size() != B.row_index.size()) {
+        throw "Error(Matrices do not match the plan)";
+    }
+    SparseMatrixCCS resMatrix(plan.m, plan.n);
+    resMatrix.row_index = plan.row_index;
+    resMatrix.col_offsets = plan.col_offsets;
+    resMatrix.value.assign(plan.row_index.size(), {0, 0});
+    int tempRowA;
+    const int* pos = plan.term_pos.data();
+
+    for (size_t j = 0; j < B.n; j++) {
+        for (int k = B.col_offsets[j]; k < B.col_offsets[j + 1]; k++) {
+            tempRowA = B.row_index[k];
+            for (int i = A.col_offsets[tempRowA];
+                 i < A.col_offsets[tempRowA + 1]; i++) {
+                resMatrix.value[*pos++] += B.value[k] * A.value[i];
+            }
+        }
+    }
+    return resMatrix;
+}
+
 mtxComplex multiMatrix(const mtxComplex &mtxA, const mtxComplex &mtxB) {
     if (mtxA[0].size() != mtxB.size()) {
         throw "Error(Size col matrix A not equal size row matrix B)";
@@ -182,8 +259,8 @@ mtxComplex multiMatrix(const mtxComplex &mtxA, const mtxComplex &mtxB) {
 }
 
 bool SparseMatrixCCS::operator==(const SparseMatrixCCS &newMtx) const {
-    if ((value != newMtx.value) && (row_index != newMtx.row_index) &&
-        (col_offsets != newMtx.col_offsets) && (m != newMtx.m) &&
+    if ((value != newMtx.value) || (row_index != newMtx.row_index) ||
+        (col_offsets != newMtx.col_offsets) || (m != newMtx.m) ||
         (n != newMtx.n)) {
         return false;
     } else {
@@ -8,6 +8,21 @@
 
 typedef std::vector<std::vector<std::complex<double>>> mtxComplex;
 
+// Structure of the product A * B cached for operands whose sparsity
+// pattern stays fixed while their values change: the pattern of the
+// result and, for every partial product, the position it is added to.
+// Entries that cancel are kept as explicit zeros.
+struct SparseMultiplyPlan {
+    size_t m, n;
+    // patterns of A and B, term_pos is only valid for exactly these
+    std::vector<int> row_index_A, col_offsets_A;
+    std::vector<int> row_index_B, col_offsets_B;
+    std::vector<int> row_index;
+    std::vector<int> col_offsets;
+    std::vector<int> term_offsets;  // partial products before every column
+    std::vector<int> term_pos;
+};
+
 class SparseMatrixCCS {
  private :
     std::vector<std::complex<double>> value;
@@ -32,6 +47,14 @@ class SparseMatrixCCS {
     static SparseMatrixCCS MultiplySparseMatrix(const SparseMatrixCCS& A,
                                                 const SparseMatrixCCS& B);
 
+    static SparseMultiplyPlan PlanMultiply(const SparseMatrixCCS& A,
+                                           const SparseMatrixCCS& B);
+
+    // Numeric-only product with a plan made for operands of this pattern
+    static SparseMatrixCCS MultiplySparseMatrix(const SparseMultiplyPlan& plan,
+                                                const SparseMatrixCCS& A,
+                                                const SparseMatrixCCS& B);
+
     bool operator==(const SparseMatrixCCS &) const;
 
     // void PrintCCS();
@@ -1,5 +1,7 @@
 // Copyright 2020 Antipin Alexander
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <random>
 #include <vector>
 #include "./matrix_multiplication.h"
 
@@ -147,6 +149,49 @@ TEST(Matrix_base, can_convert_matrix_from_CRS_to_CCR_correct_2) {
 
 // ------||------Matrix multiplication------||------
 
+TEST(Matrix_base, can_convert_matrix_there_and_back_with_any_threads) {
+    SparseMatrix<CCS> mat(50, 8);
+    std::vector<double> dense;
+    constructMatrix(mat, &dense);
+
+    SparseMatrix<CRS> matCRS;
+    SparseMatrix<CCS> back;
+    for (int numTr : { 1, 3, 64 }) {
+        convertMatrix(mat, &matCRS, numTr);
+        convertMatrix(matCRS, &back, numTr);
+        ASSERT_EQ(mat.getRealSize(), matCRS.getRealSize());
+        ASSERT_EQ(mat.getRealSize(), back.getRealSize());
+        std::vector<double> denseBack;
+        constructMatrix(back, &denseBack);
+        EXPECT_EQ(dense, denseBack);
+        for (size_t i = 0; i < 50; ++i) {
+            for (size_t j = 0; j < 50; ++j) {
+                ASSERT_EQ(dense[i * 50 + j], matCRS.getElem(i, j));
+            }
+        }
+    }
+}
+
+TEST(Matrix_base, can_convert_empty_matrix) {
+    SparseMatrix<CCS> mat;
+    mat.setMatrix({}, {}, { 0, 0, 0, 0 }, 3);
+    SparseMatrix<CRS> matCRS;
+
+    ASSERT_NO_THROW(convertMatrix(mat, &matCRS, 4));
+    EXPECT_EQ(0u, matCRS.getRealSize());
+    EXPECT_EQ(0.0, matCRS.getElem(2, 1));
+}
+
+/*TEST(Matrix_base, can_convert_large_matrix_fast) {
+    SparseMatrix<CCS> mat(20000, 2000);
+    SparseMatrix<CRS> matCRS;
+    double time = omp_get_wtime();
+    for (int i = 0; i < 10; ++i) {
+        convertMatrix(mat, &matCRS);
+    }
+    printf("10 conversions: %f\n", omp_get_wtime() - time);
+}*/
+
 TEST(Matrix_multiplication, can_multiply_matrices) {
     std::vector<double> A = { 8.0, 5.0, 2.0, 4.0, 9.0, 1.0, 3.0 };
     std::vector<size_t> LI = { 5, 2, 0, 5, 3, 3, 4 };
@@ -252,6 +297,264 @@ TEST(Matrix_multiplication, can_multiply_same_as_usial_matrix) {
     EXPECT_NEAR(mat3.getElem(94, 4), mat_3[94 * 100 + 4], 0.000001);
 }
 
+TEST(Matrix_vector_multiplication, can_multiply_by_vector_correct) {
+    std::vector<double> A = { 8.0, 5.0, 2.0, 4.0, 9.0, 1.0, 3.0 };
+    std::vector<size_t> LI = { 5, 2, 0, 5, 3, 3, 4 };
+    std::vector<size_t> LJ = { 0, 1, 2, 3, 4, 5, 7 };
+    SparseMatrix<CCS> mat;
+    mat.setMatrix(A, LI, LJ, 6);
+    SparseMatrix<CRS> matCRS;
+    convertMatrix(mat, &matCRS, 2);
+    SellMatrix matSell(matCRS, 4);
+
+    std::vector<double> x = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0 };
+    std::vector<double> res = { 6.0, 0.0, 10.0, 51.0, 18.0, 24.0 };
+    std::vector<double> y, y1, y2;
+    getParallelOMPMatrixVectorMultiplication(mat, x, &y, 3);
+    getParallelOMPMatrixVectorMultiplication(matCRS, x, &y1, 3);
+    getParallelOMPMatrixVectorMultiplication(matSell, x, &y2, 3);
+
+    for (size_t i = 0; i < 6; ++i) {
+        EXPECT_NEAR(res[i], y[i], 0.000001);
+        EXPECT_NEAR(res[i], y1[i], 0.000001);
+        EXPECT_NEAR(res[i], y2[i], 0.000001);
+    }
+}
+
+TEST(Matrix_vector_multiplication, can_throw_if_vector_has_different_size) {
+    SparseMatrix<CCS> mat(10, 8);
+    SparseMatrix<CRS> matCRS;
+    convertMatrix(mat, &matCRS, 2);
+    std::vector<double> x(9, 1.0);
+    std::vector<double> y;
+
+    ASSERT_ANY_THROW(getParallelOMPMatrixVectorMultiplication(mat, x, &y));
+    ASSERT_ANY_THROW(getParallelOMPMatrixVectorMultiplication(matCRS, x, &y));
+    ASSERT_ANY_THROW(getParallelOMPMatrixVectorMultiplication(SellMatrix(matCRS), x, &y));
+    ASSERT_ANY_THROW(getParallelOMPMatrixDenseMultiplication(matCRS, x, 3, &y));
+}
+
+TEST(Matrix_vector_multiplication, can_multiply_by_dense_matrix_same_as_usial_matrix) {
+    const size_t n = 60, k = 4;
+    SparseMatrix<CCS> mat(n, 10);
+    SparseMatrix<CRS> matCRS;
+    convertMatrix(mat, &matCRS, 2);
+    SellMatrix matSell(matCRS, 16);
+
+    std::vector<double> dense;
+    constructMatrix(mat, &dense);
+    std::vector<double> X;
+    getRandomMatrix(&X, n * k);
+
+    std::vector<double> Y, Y1;
+    getParallelOMPMatrixDenseMultiplication(matCRS, X, k, &Y);
+    getParallelOMPMatrixDenseMultiplication(matSell, X, k, &Y1);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t v = 0; v < k; ++v) {
+            double elem = 0.0;
+            for (size_t j = 0; j < n; ++j) {
+                elem += dense[i * n + j] * X[j * k + v];
+            }
+            EXPECT_NEAR(elem, Y[i * k + v], 0.000001);
+            EXPECT_NEAR(elem, Y1[i * k + v], 0.000001);
+        }
+    }
+}
+
+TEST(Matrix_vector_multiplication, can_choose_sell_for_regular_rows) {
+    // 5 elements in every row
+    std::vector<double> A(40 * 5, 1.0);
+    std::vector<size_t> LI(41);
+    std::vector<size_t> LJ(40 * 5);
+    for (size_t i = 0; i <= 40; ++i) {
+        LI[i] = i * 5;
+    }
+    for (size_t j = 0; j < LJ.size(); ++j) {
+        LJ[j] = j % 5 * 8 + j / 5 % 8;
+    }
+    SparseMatrix<CRS> regular;
+    regular.setMatrix(A, LI, LJ, 40);
+
+    // a full first row and one element in the others
+    std::vector<double> A1(40 + 39, 1.0);
+    std::vector<size_t> LI1(41);
+    std::vector<size_t> LJ1(40 + 39);
+    for (size_t j = 0; j < 40; ++j) {
+        LJ1[j] = j;
+    }
+    for (size_t i = 1; i <= 40; ++i) {
+        LI1[i] = 39 + i;
+        if (i < 40) {
+            LJ1[39 + i] = i;
+        }
+    }
+    SparseMatrix<CRS> skewed;
+    skewed.setMatrix(A1, LI1, LJ1, 40);
+
+    EXPECT_TRUE(isSellPreferable(regular));
+    EXPECT_EQ(A.size(), SellMatrix(regular).getStoredSize());
+    EXPECT_FALSE(isSellPreferable(skewed));
+    EXPECT_EQ(8u * 40 + 4 * 8, SellMatrix(skewed).getStoredSize());
+}
+
+/*TEST(Matrix_vector_multiplication, can_multiply_by_vector_faster_in_sell) {
+    SparseMatrix<CCS> mat(5000, 200);
+    SparseMatrix<CRS> matCRS;
+    convertMatrix(mat, &matCRS, 4);
+    SellMatrix matSell(matCRS);
+    std::vector<double> x(5000, 1.0);
+    std::vector<double> y, y1;
+
+    double time = omp_get_wtime();
+    for (int i = 0; i < 100; ++i) {
+        getParallelOMPMatrixVectorMultiplication(matCRS, x, &y);
+    }
+    printf("CRS: %f\n", omp_get_wtime() - time);
+    time = omp_get_wtime();
+    for (int i = 0; i < 100; ++i) {
+        getParallelOMPMatrixVectorMultiplication(matSell, x, &y1);
+    }
+    printf("SELL: %f\n", omp_get_wtime() - time);
+    EXPECT_NEAR(y[10], y1[10], 0.000001);
+}*/
+
+// ------||------Multiplication strategies------||------
+
+// Elements with probability density inside nonzero tile x tile blocks,
+// which are taken with probability blocks; increasing rows, no repeats
+static SparseMatrix<CCS> getStructuredMatrix(const size_t n, const double blocks, const double density,
+    const size_t tile = 1, const unsigned seed = 1) {
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> dist(0, 1);
+    const size_t count = (n + tile - 1) / tile;
+    std::vector<char> used(count * count);
+    for (char& u : used) {
+        u = dist(gen) < blocks;
+    }
+    std::vector<double> A;
+    std::vector<size_t> LI, LJ(1, 0);
+    for (size_t j = 0; j < n; ++j) {
+        for (size_t i = 0; i < n; ++i) {
+            if (used[(j / tile) * count + i / tile] && dist(gen) < density) {
+                A.push_back(100 - (1 + dist(gen)) * 50);
+                LI.push_back(i);
+            }
+        }
+        LJ.push_back(A.size());
+    }
+    SparseMatrix<CCS> res;
+    res.setMatrix(A, LI, LJ, n);
+    return res;
+}
+
+TEST(Matrix_strategies, can_profile_matrix) {
+    // 0 0 1 0
+    // 2 0 0 0
+    // 3 4 0 5
+    // 0 0 0 0
+    SparseMatrix<CCS> mat;
+    mat.setMatrix({ 2.0, 3.0, 4.0, 1.0, 5.0 }, { 1, 2, 2, 0, 2 }, { 0, 2, 3, 4, 5 }, 4);
+    MatrixProfile p = getMatrixProfile(mat, 2);
+    EXPECT_EQ(5u, p.nonZeros);
+    EXPECT_DOUBLE_EQ(5.0 / 16, p.density);
+    EXPECT_EQ(std::vector<size_t>({ 1, 2, 1 }), p.rowHistogram);
+    EXPECT_EQ(3u, p.maxRowLength);
+    EXPECT_EQ(2u, p.maxColumnLength);
+    EXPECT_EQ(2u, p.bandwidth);
+    EXPECT_DOUBLE_EQ(5.0 / 16, p.blockDensity);
+    EXPECT_TRUE(p.sortedColumns);
+}
+
+TEST(Matrix_strategies, can_recommend_strategy) {
+    SparseMatrix<CCS> dense = getStructuredMatrix(200, 1.0, 0.6);
+    SparseMatrix<CCS> blocked = getStructuredMatrix(200, 0.05, 0.9, 8);
+    SparseMatrix<CCS> tiny = getStructuredMatrix(200, 1.0, 0.002);
+    SparseMatrix<CCS> usual = getStructuredMatrix(200, 1.0, 0.03);
+    EXPECT_EQ(DENSE, recommendStrategy(getMatrixProfile(dense), getMatrixProfile(dense)));
+    EXPECT_EQ(BLOCKED, recommendStrategy(getMatrixProfile(blocked), getMatrixProfile(blocked)));
+    EXPECT_EQ(COLUMN_MERGE, recommendStrategy(getMatrixProfile(usual), getMatrixProfile(tiny)));
+    EXPECT_EQ(GUSTAVSON, recommendStrategy(getMatrixProfile(usual), getMatrixProfile(usual)));
+}
+
+TEST(Matrix_strategies, can_throw_if_matrices_have_different_size) {
+    SparseMatrix<CCS> A = getStructuredMatrix(10, 1.0, 0.3);
+    SparseMatrix<CCS> B = getStructuredMatrix(11, 1.0, 0.3);
+    SparseMatrix<CCS> C;
+    ASSERT_ANY_THROW(getStrategyMatrixMultiplication(A, B, &C, GUSTAVSON));
+    ASSERT_ANY_THROW(getAutoMatrixMultiplication(A, B, &C));
+}
+
+TEST(Matrix_strategies, all_strategies_are_bit_identical_to_usial_matrix) {
+    const strategy strategies[] = { DENSE, GUSTAVSON, COLUMN_MERGE, BLOCKED };
+    const size_t sizes[] = { 1, 7, 37 };
+    const double densities[] = { 0.02, 0.2, 0.7 };
+    for (const size_t n : sizes) {
+        for (const double density : densities) {
+            SparseMatrix<CCS> A = getStructuredMatrix(n, 1.0, density, 1, 2);
+            SparseMatrix<CCS> B = getStructuredMatrix(n, 0.5, density, 3, 3);
+            std::vector<double> denseA, denseB, expected;
+            constructMatrix(A, &denseA);
+            constructMatrix(B, &denseB);
+            matrixMultiplication(denseA, n, denseB, &expected);
+            for (const strategy s : strategies) {
+                for (int numThreads = 1; numThreads <= 3; ++numThreads) {
+                    SparseMatrix<CCS> C;
+                    getStrategyMatrixMultiplication(A, B, &C, s, numThreads);
+                    std::vector<double> res;
+                    constructMatrix(C, &res);
+                    EXPECT_EQ(expected, res);
+                    EXPECT_EQ(static_cast<size_t>(std::count_if(expected.begin(), expected.end(),
+                        [](double x) { return x != 0.0; })), C.getRealSize());
+                }
+            }
+        }
+    }
+}
+
+TEST(Matrix_strategies, can_multiply_with_recommended_strategy) {
+    SparseMatrix<CCS> A = getStructuredMatrix(60, 0.2, 0.8, 8, 4);
+    SparseMatrix<CCS> B = getStructuredMatrix(60, 0.2, 0.8, 8, 5);
+    SparseMatrix<CCS> C, C1;
+    EXPECT_EQ(BLOCKED, getAutoMatrixMultiplication(A, B, &C));
+    getStrategyMatrixMultiplication(A, B, &C1, GUSTAVSON);
+    std::vector<double> res, res1;
+    constructMatrix(C, &res);
+    constructMatrix(C1, &res1);
+    EXPECT_EQ(res1, res);
+}
+
+/*TEST(Matrix_strategies, can_compare_multiplication_strategies) {
+    const char* names[] = { "dense", "gustavson", "merge", "blocked" };
+    const size_t n = 2000;
+    const double densities[] = { 0.0001, 0.0005, 0.001, 0.01, 0.1, 0.3, 0.4, 0.5, 0.7 };
+    for (const double density : densities) {
+        SparseMatrix<CCS> A = getStructuredMatrix(n, 1.0, density);
+        printf("density %.4f:", density);
+        for (int s = DENSE; s <= BLOCKED; ++s) {
+            if (s == COLUMN_MERGE && density > 0.01) {
+                continue;
+            }
+            SparseMatrix<CCS> C;
+            double time = omp_get_wtime();
+            getStrategyMatrixMultiplication(A, A, &C, static_cast<strategy>(s));
+            printf(" %s %f", names[s], omp_get_wtime() - time);
+        }
+        printf("\n");
+    }
+    const double fills[] = { 0.25, 0.5, 0.75, 1.0 };
+    for (const double fill : fills) {
+        SparseMatrix<CCS> A = getStructuredMatrix(n, 0.01, fill, 8);
+        printf("8 x 8 blocks filled by %.2f:", fill);
+        for (int s = GUSTAVSON; s <= BLOCKED; ++s) {
+            SparseMatrix<CCS> C;
+            double time = omp_get_wtime();
+            getStrategyMatrixMultiplication(A, A, &C, static_cast<strategy>(s));
+            printf(" %s %f", names[s], omp_get_wtime() - time);
+        }
+        printf("\n");
+    }
+}*/
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
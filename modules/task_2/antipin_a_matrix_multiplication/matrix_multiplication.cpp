@@ -4,6 +4,9 @@
 #include <random>
 #include <ctime>
 #include <algorithm>
+#include <numeric>
+#include <functional>
+#include <utility>
 #include "../../../modules/task_2/antipin_a_matrix_multiplication/matrix_multiplication.h"
 
 void constructMatrix(const SparseMatrix<CCS>& A, std::vector<double>* B) {
@@ -50,55 +53,81 @@ void getRandomMatrix(std::vector<double>* A, const size_t n) {
     }
 }
 
-void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B, const int numTr) {
-    B->A.resize(A.getRealSize());
-    B->LI.resize(A.getMatrixSize() + 1);
-    B->LJ.resize(A.getRealSize());
-    B->n = A.n;
+// Transposes compressed storage: ptr and idx describe n lines (columns of
+// CCS or rows of CRS), outPtr and outIdx get the m lines of the other
+// orientation. Every thread counts the elements of its own lines per target
+// line, the counts become per-thread write positions, and every thread
+// scatters its lines, so indices stay increasing within each target line.
+// The counters are kept per calling thread and reused between calls.
+template <typename V>
+static void transposeStorage(const size_t n, const size_t m, const std::vector<size_t>& ptr,
+    const std::vector<size_t>& idx, const std::vector<V>& val, std::vector<size_t>* outPtr,
+    std::vector<size_t>* outIdx, std::vector<V>* outVal, const int numTr) {
+    static thread_local std::vector<size_t> counts;
+    const int maxThreads = numTr > 0 ? numTr : 1;
+    const size_t nz = val.size();
+    outPtr->resize(m + 1);
+    outIdx->resize(nz);
+    outVal->resize(nz);
+    counts.assign(maxThreads * m, 0);
+    // the workers must see the counters of the calling thread
+    size_t* count = counts.data();
 
-    std::vector<size_t> cols(A.getRealSize());
-    for (int lj = 0; lj < static_cast<int>(A.getMatrixSize()); ++lj) {
-        for (size_t i = A.LJ[lj]; i < A.LJ[lj + 1]; ++i) {
-            cols[i] = lj;
+#pragma omp parallel num_threads(maxThreads)
+    {
+        const int tid = omp_get_thread_num();
+        const int numThreads = omp_get_num_threads();
+        const size_t first = n * tid / numThreads;
+        const size_t last = n * (tid + 1) / numThreads;
+        size_t* own = count + tid * m;
+        for (size_t i = first; i < last; ++i) {
+            for (size_t k = ptr[i]; k < ptr[i + 1]; ++k) {
+                ++own[idx[k]];
+            }
         }
-    }
-    size_t li = 0;
-    for (size_t n = 0; n < A.getMatrixSize(); ++n) {
-        for (size_t i = 0; i < A.getRealSize(); ++i) {
-            if (A.LI[i] == n) {
-                B->A[li] = A.A[i];
-                B->LJ[li] = cols[i];
-                ++li;
+#pragma omp barrier
+#pragma omp for schedule(static)
+        for (int j = 0; j < static_cast<int>(m); ++j) {
+            size_t total = 0;
+            for (int t = 0; t < numThreads; ++t) {
+                total += count[t * m + j];
+            }
+            (*outPtr)[j + 1] = total;
+        }
+#pragma omp single
+        {
+            (*outPtr)[0] = 0;
+            for (size_t j = 0; j < m; ++j) {
+                (*outPtr)[j + 1] += (*outPtr)[j];
+            }
+        }
+#pragma omp for schedule(static)
+        for (int j = 0; j < static_cast<int>(m); ++j) {
+            size_t pos = (*outPtr)[j];
+            for (int t = 0; t < numThreads; ++t) {
+                size_t lineCount = count[t * m + j];
+                count[t * m + j] = pos;
+                pos += lineCount;
+            }
+        }
+        for (size_t i = first; i < last; ++i) {
+            for (size_t k = ptr[i]; k < ptr[i + 1]; ++k) {
+                size_t pos = own[idx[k]]++;
+                (*outIdx)[pos] = i;
+                (*outVal)[pos] = val[k];
             }
         }
-        B->LI[n + 1] = li;
     }
 }
 
-void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B) {
-    B->A.resize(A.getRealSize());
-    B->LJ.resize(A.getMatrixSize() + 1);
-    B->LI.resize(A.getRealSize());
+void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B, const int numTr) {
     B->n = A.n;
+    transposeStorage(A.n, A.n, A.LJ, A.LI, A.A, &B->LI, &B->LJ, &B->A, numTr);
+}
 
-    std::vector<size_t> rows(A.getRealSize());
-    for (size_t li = 0; li < A.getMatrixSize(); ++li) {
-        for (size_t j = A.LI[li]; j < A.LI[li + 1]; ++j) {
-            rows[j] = li;
-        }
-    }
-
-    size_t lj = 0;
-    for (size_t n = 0; n < A.getMatrixSize(); ++n) {
-        for (size_t j = 0; j < A.getRealSize(); ++j) {
-            if (A.LJ[j] == n) {
-                B->A[lj] = A.A[j];
-                B->LI[lj] = rows[j];
-                ++lj;
-            }
-        }
-        B->LJ[n + 1] = lj;
-    }
+void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B, const int numTr) {
+    B->n = A.n;
+    transposeStorage(A.n, A.n, A.LI, A.LJ, A.A, &B->LJ, &B->LI, &B->A, numTr);
 }
 
 void getParallelOMPMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
@@ -168,3 +197,519 @@ void getParallelOMPMatrixMultiplication(const SparseMatrix<CCS>& A, const Sparse
         }
     }
 }
+
+void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads) {
+    if (x.size() != A.n) {
+        throw("Wrong vector size");
+    }
+    y->assign(A.n, 0.0);
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < static_cast<int>(A.n); ++i) {
+        double sum = 0.0;
+        for (size_t j = A.LI[i]; j < A.LI[i + 1]; ++j) {
+            sum += A.A[j] * x[A.LJ[j]];
+        }
+        (*y)[i] = sum;
+    }
+}
+
+void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CCS>& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads) {
+    if (x.size() != A.n) {
+        throw("Wrong vector size");
+    }
+    y->assign(A.n, 0.0);
+
+#pragma omp parallel num_threads(numThreads)
+    {
+        std::vector<double> part(A.n, 0.0);
+#pragma omp for schedule(static)
+        for (int j = 0; j < static_cast<int>(A.n); ++j) {
+            for (size_t i = A.LJ[j]; i < A.LJ[j + 1]; ++i) {
+                part[A.LI[i]] += A.A[i] * x[j];
+            }
+        }
+#pragma omp critical
+        for (size_t i = 0; i < A.n; ++i) {
+            (*y)[i] += part[i];
+        }
+    }
+}
+
+void getParallelOMPMatrixDenseMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& X,
+    const size_t k, std::vector<double>* Y, const int numThreads) {
+    if (k == 0 || X.size() != A.n * k) {
+        throw("Wrong matrix size");
+    }
+    Y->assign(A.n * k, 0.0);
+
+#pragma omp parallel for num_threads(numThreads) schedule(static)
+    for (int i = 0; i < static_cast<int>(A.n); ++i) {
+        double* y = &(*Y)[i * k];
+        for (size_t j = A.LI[i]; j < A.LI[i + 1]; ++j) {
+            const double a = A.A[j];
+            const double* x = &X[A.LJ[j] * k];
+            for (size_t v = 0; v < k; ++v) {
+                y[v] += a * x[v];
+            }
+        }
+    }
+}
+
+// Order of the rows sorted by length inside windows of sigma rows
+static std::vector<size_t> getSellOrder(const std::vector<size_t>& LI, const size_t n, const size_t sigma) {
+    std::vector<size_t> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (size_t s = 0; s < n; s += sigma) {
+        std::stable_sort(perm.begin() + s, perm.begin() + std::min(n, s + sigma), [&LI](size_t a, size_t b) {
+            return LI[a + 1] - LI[a] > LI[b + 1] - LI[b];
+        });
+    }
+    return perm;
+}
+
+static size_t getChunkLength(const std::vector<size_t>& LI, const std::vector<size_t>& perm, const size_t n,
+    const size_t c) {
+    size_t len = 0;
+    for (size_t i = c * SellMatrix::C; i < std::min(n, (c + 1) * SellMatrix::C); ++i) {
+        len = std::max(len, LI[perm[i] + 1] - LI[perm[i]]);
+    }
+    return len;
+}
+
+bool isSellPreferable(const SparseMatrix<CRS>& A, const size_t sigma) {
+    if (A.A.empty() || sigma == 0) {
+        return false;
+    }
+    std::vector<size_t> perm = getSellOrder(A.LI, A.n, sigma);
+    size_t padded = 0;
+    for (size_t c = 0; c * SellMatrix::C < A.n; ++c) {
+        padded += getChunkLength(A.LI, perm, A.n, c) * SellMatrix::C;
+    }
+    return padded * 4 <= A.A.size() * 5;
+}
+
+SellMatrix::SellMatrix(const SparseMatrix<CRS>& mat, const size_t sigma) {
+    if (sigma == 0) {
+        throw("Wrong sigma");
+    }
+    n = mat.n;
+    perm = getSellOrder(mat.LI, n, sigma);
+
+    size_t chunks = (n + C - 1) / C;
+    chunkPtr.assign(chunks + 1, 0);
+    chunkLen.resize(chunks);
+    for (size_t c = 0; c < chunks; ++c) {
+        chunkLen[c] = getChunkLength(mat.LI, perm, n, c);
+        chunkPtr[c + 1] = chunkPtr[c] + chunkLen[c] * C;
+    }
+
+    // padding is a zero in column 0
+    A.assign(chunkPtr[chunks], 0.0);
+    LJ.assign(chunkPtr[chunks], 0);
+    for (size_t i = 0; i < n; ++i) {
+        size_t pos = chunkPtr[i / C] + i % C;
+        for (size_t j = mat.LI[perm[i]]; j < mat.LI[perm[i] + 1]; ++j, pos += C) {
+            A[pos] = mat.A[j];
+            LJ[pos] = mat.LJ[j];
+        }
+    }
+}
+
+size_t SellMatrix::getMatrixSize() const {
+    return n;
+}
+
+size_t SellMatrix::getStoredSize() const {
+    return A.size();
+}
+
+void getParallelOMPMatrixVectorMultiplication(const SellMatrix& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads) {
+    if (x.size() != A.n) {
+        throw("Wrong vector size");
+    }
+    y->assign(A.n, 0.0);
+
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 16)
+    for (int c = 0; c < static_cast<int>(A.chunkLen.size()); ++c) {
+        double sum[SellMatrix::C] = {};
+        const double* a = A.A.data() + A.chunkPtr[c];
+        const size_t* lj = A.LJ.data() + A.chunkPtr[c];
+        for (size_t j = 0; j < A.chunkLen[c]; ++j) {
+            for (size_t r = 0; r < SellMatrix::C; ++r) {
+                sum[r] += a[j * SellMatrix::C + r] * x[lj[j * SellMatrix::C + r]];
+            }
+        }
+        for (size_t r = 0; r < SellMatrix::C && c * SellMatrix::C + r < A.n; ++r) {
+            (*y)[A.perm[c * SellMatrix::C + r]] = sum[r];
+        }
+    }
+}
+
+void getParallelOMPMatrixDenseMultiplication(const SellMatrix& A, const std::vector<double>& X,
+    const size_t k, std::vector<double>* Y, const int numThreads) {
+    if (k == 0 || X.size() != A.n * k) {
+        throw("Wrong matrix size");
+    }
+    Y->assign(A.n * k, 0.0);
+
+#pragma omp parallel for num_threads(numThreads) schedule(dynamic, 16)
+    for (int c = 0; c < static_cast<int>(A.chunkLen.size()); ++c) {
+        for (size_t r = 0; r < SellMatrix::C && c * SellMatrix::C + r < A.n; ++r) {
+            double* y = &(*Y)[A.perm[c * SellMatrix::C + r] * k];
+            for (size_t j = 0; j < A.chunkLen[c]; ++j) {
+                size_t pos = A.chunkPtr[c] + j * SellMatrix::C + r;
+                const double a = A.A[pos];
+                const double* x = &X[A.LJ[pos] * k];
+                for (size_t v = 0; v < k; ++v) {
+                    y[v] += a * x[v];
+                }
+            }
+        }
+    }
+}
+
+// Thresholds of recommendStrategy, measured with the commented out
+// can_compare_multiplication_strategies test (n = 2000, -O2): the dense
+// path overtakes Gustavson only between 40% and 50% density of A, the merge
+// wins up to one element per column of B, and 8 x 8 tiles win once the
+// nonempty blocks are half full
+static const double kDenseDensity = 0.45;
+static const size_t kDenseMaxSize = 4096;
+static const double kBlockDensity = 0.5;
+static const size_t kMergeColumnLength = 1;
+static const size_t kTile = 8;
+
+MatrixProfile getMatrixProfile(const SparseMatrix<CCS>& A, const size_t blockSize) {
+    if (blockSize == 0) {
+        throw("Wrong block size");
+    }
+    MatrixProfile p;
+    p.n = A.n;
+    p.nonZeros = A.A.size();
+    p.density = A.n == 0 ? 0.0 : static_cast<double>(p.nonZeros) / A.n / A.n;
+    p.maxColumnLength = 0;
+    p.bandwidth = 0;
+    p.blockSize = blockSize;
+    p.sortedColumns = true;
+
+    std::vector<size_t> rowLength(A.n, 0);
+    const size_t blocks = (A.n + blockSize - 1) / blockSize;
+    std::vector<size_t> lastBlockColumn(blocks, blocks);
+    size_t nonEmptyBlocks = 0;
+    for (size_t j = 0; j < A.n; ++j) {
+        p.maxColumnLength = std::max(p.maxColumnLength, A.LJ[j + 1] - A.LJ[j]);
+        for (size_t k = A.LJ[j]; k < A.LJ[j + 1]; ++k) {
+            const size_t i = A.LI[k];
+            ++rowLength[i];
+            p.bandwidth = std::max(p.bandwidth, i > j ? i - j : j - i);
+            if (k > A.LJ[j] && A.LI[k - 1] >= i) {
+                p.sortedColumns = false;
+            }
+            if (lastBlockColumn[i / blockSize] != j / blockSize) {
+                lastBlockColumn[i / blockSize] = j / blockSize;
+                ++nonEmptyBlocks;
+            }
+        }
+    }
+    p.blockDensity = nonEmptyBlocks == 0 ? 0.0 :
+        static_cast<double>(p.nonZeros) / (nonEmptyBlocks * blockSize * blockSize);
+
+    p.maxRowLength = 0;
+    for (const size_t len : rowLength) {
+        size_t bucket = 0;
+        while ((static_cast<size_t>(1) << bucket) <= len) {
+            ++bucket;
+        }
+        if (p.rowHistogram.size() <= bucket) {
+            p.rowHistogram.resize(bucket + 1, 0);
+        }
+        ++p.rowHistogram[bucket];
+        p.maxRowLength = std::max(p.maxRowLength, len);
+    }
+    return p;
+}
+
+strategy recommendStrategy(const MatrixProfile& A, const MatrixProfile& B) {
+    if (A.n != B.n) {
+        throw("Matrices have a different range");
+    }
+    if (A.density >= kDenseDensity && A.n <= kDenseMaxSize) {
+        return DENSE;
+    }
+    if (A.blockSize == kTile && B.blockSize == kTile &&
+        std::min(A.blockDensity, B.blockDensity) >= kBlockDensity) {
+        return BLOCKED;
+    }
+    if (A.sortedColumns && B.sortedColumns && B.nonZeros <= kMergeColumnLength * B.n) {
+        return COLUMN_MERGE;
+    }
+    return GUSTAVSON;
+}
+
+// Splits the columns of C into contiguous ranges of whole groups of align
+// columns, one per thread. kernel(first, last, &LI, &A, counts) appends the
+// columns [first, last) and stores their lengths in counts[first..last).
+template <typename Kernel>
+static void multiplyByColumnRanges(const size_t n, const size_t align, const int numTr, Kernel kernel,
+    std::vector<size_t>* LJ, std::vector<size_t>* LI, std::vector<double>* A) {
+    const size_t groups = (n + align - 1) / align;
+    const int parts = static_cast<int>(std::max<size_t>(1, std::min<size_t>(numTr > 0 ? numTr : 1, groups)));
+    std::vector<std::vector<size_t>> rows(parts);
+    std::vector<std::vector<double>> vals(parts);
+    LJ->assign(n + 1, 0);
+    size_t* counts = LJ->data() + 1;
+
+#pragma omp parallel for num_threads(parts) schedule(static, 1)
+    for (int p = 0; p < parts; ++p) {
+        const size_t first = std::min(n, groups * p / parts * align);
+        const size_t last = std::min(n, groups * (p + 1) / parts * align);
+        kernel(first, last, &rows[p], &vals[p], counts);
+    }
+
+    for (size_t j = 0; j < n; ++j) {
+        (*LJ)[j + 1] += (*LJ)[j];
+    }
+    LI->resize((*LJ)[n]);
+    A->resize((*LJ)[n]);
+    size_t pos = 0;
+    for (int p = 0; p < parts; ++p) {
+        std::copy(rows[p].begin(), rows[p].end(), LI->begin() + pos);
+        std::copy(vals[p].begin(), vals[p].end(), A->begin() + pos);
+        pos += rows[p].size();
+    }
+}
+
+// Dense tiles of a CCS matrix: tile t of block column K is the block row
+// blockRow[t] for ptr[K] <= t < ptr[K + 1], stored column by column
+struct TileColumns {
+    std::vector<size_t> ptr;
+    std::vector<size_t> blockRow;
+    std::vector<double> tiles;
+};
+
+static TileColumns getTileColumns(const size_t n, const std::vector<size_t>& LJ, const std::vector<size_t>& LI,
+    const std::vector<double>& val) {
+    const size_t blocks = (n + kTile - 1) / kTile;
+    TileColumns res;
+    res.ptr.assign(blocks + 1, 0);
+    std::vector<size_t> slot(blocks, 0);
+    std::vector<size_t> mark(blocks, blocks);
+    for (size_t K = 0; K < blocks; ++K) {
+        const size_t first = res.blockRow.size();
+        const size_t jEnd = std::min(n, (K + 1) * kTile);
+        for (size_t j = K * kTile; j < jEnd; ++j) {
+            for (size_t k = LJ[j]; k < LJ[j + 1]; ++k) {
+                const size_t I = LI[k] / kTile;
+                if (mark[I] != K) {
+                    mark[I] = K;
+                    res.blockRow.push_back(I);
+                }
+            }
+        }
+        std::sort(res.blockRow.begin() + first, res.blockRow.end());
+        for (size_t t = first; t < res.blockRow.size(); ++t) {
+            slot[res.blockRow[t]] = t;
+        }
+        res.tiles.resize(res.blockRow.size() * kTile * kTile, 0.0);
+        for (size_t j = K * kTile; j < jEnd; ++j) {
+            for (size_t k = LJ[j]; k < LJ[j + 1]; ++k) {
+                double* tile = &res.tiles[slot[LI[k] / kTile] * kTile * kTile];
+                tile[(j % kTile) * kTile + LI[k] % kTile] += val[k];
+            }
+        }
+        res.ptr[K + 1] = res.blockRow.size();
+    }
+    return res;
+}
+
+void getStrategyMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const strategy s, const int numThreads) {
+    if (A.getMatrixSize() != B.getMatrixSize()) {
+        throw("Matrices have a different range");
+    }
+    const size_t n = A.n;
+    C->n = n;
+
+    if (s == DENSE) {
+        // column-major copy of A, the columns of C are combinations of its columns
+        std::vector<double> dense(n * n, 0.0);
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t t = A.LJ[k]; t < A.LJ[k + 1]; ++t) {
+                dense[k * n + A.LI[t]] += A.A[t];
+            }
+        }
+        multiplyByColumnRanges(n, 1, numThreads, [&](size_t first, size_t last, std::vector<size_t>* rows,
+            std::vector<double>* vals, size_t* counts) {
+            std::vector<double> acc(n);
+            for (size_t j = first; j < last; ++j) {
+                std::fill(acc.begin(), acc.end(), 0.0);
+                double* c = acc.data();
+                for (size_t t = B.LJ[j]; t < B.LJ[j + 1]; ++t) {
+                    const double* a = &dense[B.LI[t] * n];
+                    const double b = B.A[t];
+#pragma omp simd
+                    for (size_t i = 0; i < n; ++i) {
+                        c[i] += isZero(a[i] * b);
+                    }
+                }
+                const size_t before = rows->size();
+                for (size_t i = 0; i < n; ++i) {
+                    if (c[i] != 0.0) {
+                        rows->push_back(i);
+                        vals->push_back(c[i]);
+                    }
+                }
+                counts[j] = rows->size() - before;
+            }
+        }, &C->LJ, &C->LI, &C->A);
+    } else if (s == GUSTAVSON) {
+        multiplyByColumnRanges(n, 1, numThreads, [&](size_t first, size_t last, std::vector<size_t>* rows,
+            std::vector<double>* vals, size_t* counts) {
+            std::vector<double> acc(n);
+            std::vector<size_t> mark(n, n);
+            std::vector<size_t> touched;
+            for (size_t j = first; j < last; ++j) {
+                touched.clear();
+                for (size_t t = B.LJ[j]; t < B.LJ[j + 1]; ++t) {
+                    const size_t k = B.LI[t];
+                    const double b = B.A[t];
+                    for (size_t u = A.LJ[k]; u < A.LJ[k + 1]; ++u) {
+                        const size_t i = A.LI[u];
+                        if (mark[i] != j) {
+                            mark[i] = j;
+                            acc[i] = 0.0;
+                            touched.push_back(i);
+                        }
+                        acc[i] += isZero(A.A[u] * b);
+                    }
+                }
+                std::sort(touched.begin(), touched.end());
+                const size_t before = rows->size();
+                for (const size_t i : touched) {
+                    if (acc[i] != 0.0) {
+                        rows->push_back(i);
+                        vals->push_back(acc[i]);
+                    }
+                }
+                counts[j] = rows->size() - before;
+            }
+        }, &C->LJ, &C->LI, &C->A);
+    } else if (s == COLUMN_MERGE) {
+        multiplyByColumnRanges(n, 1, numThreads, [&](size_t first, size_t last, std::vector<size_t>* rows,
+            std::vector<double>* vals, size_t* counts) {
+            // (row, position in the column of B); ties go to the smaller k
+            std::vector<std::pair<size_t, size_t>> heap;
+            std::vector<size_t> cursor;
+            const std::greater<std::pair<size_t, size_t>> later;
+            for (size_t j = first; j < last; ++j) {
+                const size_t m = B.LJ[j + 1] - B.LJ[j];
+                cursor.resize(m);
+                heap.clear();
+                for (size_t q = 0; q < m; ++q) {
+                    const size_t k = B.LI[B.LJ[j] + q];
+                    cursor[q] = A.LJ[k];
+                    if (A.LJ[k] < A.LJ[k + 1]) {
+                        heap.push_back(std::make_pair(A.LI[A.LJ[k]], q));
+                    }
+                }
+                std::make_heap(heap.begin(), heap.end(), later);
+                const size_t before = rows->size();
+                size_t row = n;
+                double elem = 0.0;
+                while (!heap.empty()) {
+                    std::pop_heap(heap.begin(), heap.end(), later);
+                    const size_t i = heap.back().first;
+                    const size_t q = heap.back().second;
+                    const size_t k = B.LI[B.LJ[j] + q];
+                    if (i != row) {
+                        if (row != n && elem != 0.0) {
+                            rows->push_back(row);
+                            vals->push_back(elem);
+                        }
+                        row = i;
+                        elem = 0.0;
+                    }
+                    elem += isZero(A.A[cursor[q]] * B.A[B.LJ[j] + q]);
+                    if (++cursor[q] < A.LJ[k + 1]) {
+                        heap.back().first = A.LI[cursor[q]];
+                        std::push_heap(heap.begin(), heap.end(), later);
+                    } else {
+                        heap.pop_back();
+                    }
+                }
+                if (row != n && elem != 0.0) {
+                    rows->push_back(row);
+                    vals->push_back(elem);
+                }
+                counts[j] = rows->size() - before;
+            }
+        }, &C->LJ, &C->LI, &C->A);
+    } else if (s == BLOCKED) {
+        const TileColumns a = getTileColumns(n, A.LJ, A.LI, A.A);
+        const TileColumns b = getTileColumns(n, B.LJ, B.LI, B.A);
+        const size_t blocks = a.ptr.size() - 1;
+        const size_t area = kTile * kTile;
+        multiplyByColumnRanges(n, kTile, numThreads, [&](size_t first, size_t last, std::vector<size_t>* rows,
+            std::vector<double>* vals, size_t* counts) {
+            std::vector<double> acc(blocks * area);
+            std::vector<size_t> mark(blocks, blocks);
+            std::vector<size_t> touched;
+            for (size_t J = first / kTile; J * kTile < last; ++J) {
+                touched.clear();
+                for (size_t tb = b.ptr[J]; tb < b.ptr[J + 1]; ++tb) {
+                    const size_t K = b.blockRow[tb];
+                    const double* bt = &b.tiles[tb * area];
+                    for (size_t ta = a.ptr[K]; ta < a.ptr[K + 1]; ++ta) {
+                        const size_t I = a.blockRow[ta];
+                        const double* at = &a.tiles[ta * area];
+                        double* ct = &acc[I * area];
+                        if (mark[I] != J) {
+                            mark[I] = J;
+                            std::fill(ct, ct + area, 0.0);
+                            touched.push_back(I);
+                        }
+                        for (size_t jj = 0; jj < kTile; ++jj) {
+                            for (size_t kk = 0; kk < kTile; ++kk) {
+                                const double bkj = bt[jj * kTile + kk];
+                                if (bkj == 0.0) {
+                                    continue;
+                                }
+#pragma omp simd
+                                for (size_t ii = 0; ii < kTile; ++ii) {
+                                    ct[jj * kTile + ii] += isZero(at[kk * kTile + ii] * bkj);
+                                }
+                            }
+                        }
+                    }
+                }
+                std::sort(touched.begin(), touched.end());
+                for (size_t j = J * kTile; j < std::min(last, (J + 1) * kTile); ++j) {
+                    const size_t before = rows->size();
+                    for (const size_t I : touched) {
+                        const double* ct = &acc[I * area + (j % kTile) * kTile];
+                        for (size_t ii = 0; ii < kTile && I * kTile + ii < n; ++ii) {
+                            if (ct[ii] != 0.0) {
+                                rows->push_back(I * kTile + ii);
+                                vals->push_back(ct[ii]);
+                            }
+                        }
+                    }
+                    counts[j] = rows->size() - before;
+                }
+            }
+        }, &C->LJ, &C->LI, &C->A);
+    } else {
+        throw("Unknown strategy");
+    }
+}
+
+strategy getAutoMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const int numThreads) {
+    const strategy s = recommendStrategy(getMatrixProfile(A, kTile), getMatrixProfile(B, kTile));
+    getStrategyMatrixMultiplication(A, B, C, s, numThreads);
+    return s;
+}
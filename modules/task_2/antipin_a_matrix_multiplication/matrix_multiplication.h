@@ -13,6 +13,17 @@ enum type {
     CCS
 };
 
+class SellMatrix;
+struct MatrixProfile;
+
+// Strategies of getStrategyMatrixMultiplication, see recommendStrategy
+enum strategy {
+    DENSE,
+    GUSTAVSON,
+    COLUMN_MERGE,
+    BLOCKED
+};
+
 template <type T = CCS>
 class SparseMatrix {
  public:
@@ -28,9 +39,20 @@ class SparseMatrix {
     void printM() const;
 
     friend void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B, const int numTr);
-    friend void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B);
+    friend void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B, const int numTr);
     friend void getParallelOMPMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B,
         SparseMatrix<CCS>* C, const int numThreads);
+    friend void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& x,
+        std::vector<double>* y, const int numThreads);
+    friend void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CCS>& A, const std::vector<double>& x,
+        std::vector<double>* y, const int numThreads);
+    friend void getParallelOMPMatrixDenseMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& X,
+        const size_t k, std::vector<double>* Y, const int numThreads);
+    friend bool isSellPreferable(const SparseMatrix<CRS>& A, const size_t sigma);
+    friend MatrixProfile getMatrixProfile(const SparseMatrix<CCS>& A, const size_t blockSize);
+    friend void getStrategyMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B,
+        SparseMatrix<CCS>* C, const strategy s, const int numThreads);
+    friend class SellMatrix;
  private:
     std::vector<double> A;
     std::vector<size_t> LI;
@@ -264,11 +286,97 @@ double isZero(const double nomber);
 
 void getRandomMatrix(std::vector<double>* A, const size_t n);
 
-void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B, const int numTr);
+// Both conversions are a parallel transpose of the storage (per-thread
+// histograms, prefix sum, scatter) and reuse the memory already held by B
+void convertMatrix(const SparseMatrix<CCS>& A, SparseMatrix<CRS>* B, const int numTr = omp_get_max_threads());
 
-void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B);
+void convertMatrix(const SparseMatrix<CRS>& A, SparseMatrix<CCS>* B, const int numTr = omp_get_max_threads());
 
 void getParallelOMPMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
     const int numThreads = omp_get_max_threads());
 
+// SELL-C-sigma storage: rows are sorted by length inside windows of sigma
+// rows and cut into chunks of C rows, every chunk is padded to its longest
+// row and kept column by column, so the C rows of a chunk are multiplied
+// together in unit-stride (vectorizable) loops
+class SellMatrix {
+ public:
+    static const size_t C = 8;
+
+    explicit SellMatrix(const SparseMatrix<CRS>& mat, const size_t sigma = 256);
+    size_t getMatrixSize() const;
+    size_t getStoredSize() const;
+
+    friend void getParallelOMPMatrixVectorMultiplication(const SellMatrix& A, const std::vector<double>& x,
+        std::vector<double>* y, const int numThreads);
+    friend void getParallelOMPMatrixDenseMultiplication(const SellMatrix& A, const std::vector<double>& X,
+        const size_t k, std::vector<double>* Y, const int numThreads);
+ private:
+    std::vector<double> A;
+    std::vector<size_t> LJ;
+    std::vector<size_t> chunkPtr;
+    std::vector<size_t> chunkLen;
+    std::vector<size_t> perm;
+    size_t n;
+};
+
+// y = A * x; the CCS version scatters into a partial y of every thread
+void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads = omp_get_max_threads());
+
+void getParallelOMPMatrixVectorMultiplication(const SparseMatrix<CCS>& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads = omp_get_max_threads());
+
+void getParallelOMPMatrixVectorMultiplication(const SellMatrix& A, const std::vector<double>& x,
+    std::vector<double>* y, const int numThreads = omp_get_max_threads());
+
+// Y = A * X, X is a dense n x k matrix of k vectors stored by rows
+void getParallelOMPMatrixDenseMultiplication(const SparseMatrix<CRS>& A, const std::vector<double>& X,
+    const size_t k, std::vector<double>* Y, const int numThreads = omp_get_max_threads());
+
+void getParallelOMPMatrixDenseMultiplication(const SellMatrix& A, const std::vector<double>& X,
+    const size_t k, std::vector<double>* Y, const int numThreads = omp_get_max_threads());
+
+// SELL is worth it when its chunks need less than a quarter of padding
+bool isSellPreferable(const SparseMatrix<CRS>& A, const size_t sigma = 256);
+
+// Structure of a CCS matrix as seen by the multiplication
+struct MatrixProfile {
+    size_t n;
+    size_t nonZeros;
+    double density;
+    // rowHistogram[0] counts the empty rows, rowHistogram[k] the rows with
+    // 2^(k-1) to 2^k - 1 elements
+    std::vector<size_t> rowHistogram;
+    size_t maxRowLength;
+    size_t maxColumnLength;
+    size_t bandwidth;  // largest |i - j| of an element
+    size_t blockSize;
+    double blockDensity;  // share of the elements in the nonempty blockSize x blockSize blocks
+    bool sortedColumns;  // row indices increase within every column
+};
+
+MatrixProfile getMatrixProfile(const SparseMatrix<CCS>& A, const size_t blockSize = 8);
+
+// DENSE: A is expanded to a dense matrix and its columns are combined with
+//     the elements of B (dense columns of C), for dense enough A
+// GUSTAVSON: every column of C is accumulated in a dense vector from the
+//     columns of A picked by the column of B (Gustavson's CRS algorithm on
+//     the transposed product, since CCS of C is CRS of C^T = B^T * A^T)
+// COLUMN_MERGE: the picked columns of A are merged by row index with a heap,
+//     no accumulator, for very short columns of B
+// BLOCKED: both matrices are cut into dense 8 x 8 tiles and multiplied tile
+//     by tile, for elements clustered into blocks
+// Every element of C sums its products in increasing order of k in all
+// strategies, so for matrices with increasing row indices and no repeated
+// elements the results are bit-identical.
+strategy recommendStrategy(const MatrixProfile& A, const MatrixProfile& B);
+
+void getStrategyMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const strategy s, const int numThreads = omp_get_max_threads());
+
+// Profiles both matrices and uses the recommended strategy
+strategy getAutoMatrixMultiplication(const SparseMatrix<CCS>& A, const SparseMatrix<CCS>& B, SparseMatrix<CCS>* C,
+    const int numThreads = omp_get_max_threads());
+
 #endif  // MODULES_TASK_2_ANTIPIN_A_MATRIX_MULTIPLICATION_MATRIX_MULTIPLICATION_H_
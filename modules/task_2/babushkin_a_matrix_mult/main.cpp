@@ -71,6 +71,47 @@ TEST(Matrix_Mult_Cann, Mult_Cannon_Rand_10x10) { test(20); }
 
 TEST(Matrix_Mult_Cann, Mult_Cannon_Rand_40x40) { test(40); }
 
+TEST(Matrix_Mult_Cann, Mult_Cannon_Rand_Odd_Size) { test(21); }
+
+TEST(Matrix_Mult_Cann, Mult_Cannon_Grid_3x3) {
+  mtrxmult::Matrix left = mtrxmult::random_matrix(36, 36);
+  mtrxmult::Matrix right = mtrxmult::random_matrix(36, 36);
+
+  mtrxmult::Matrix mult_res_seq = mtrxmult::multiply(left, right, SEQUENTIAL);
+
+  omp_set_num_threads(9);
+  mtrxmult::Matrix mult_res_cannon = mtrxmult::multiply_cannon(&left, &right);
+
+  ASSERT_TRUE(mult_res_cannon == mult_res_seq);
+}
+
+TEST(Matrix_Mult_Cann, Mult_Cannon_Keeps_Operands) {
+  mtrxmult::Matrix left = mtrxmult::random_matrix(40, 40);
+  mtrxmult::Matrix right = mtrxmult::random_matrix(40, 40);
+  mtrxmult::Matrix left_copy = left;
+  mtrxmult::Matrix right_copy = right;
+
+  omp_set_num_threads(4);
+  mtrxmult::multiply_cannon(&left, &right);
+
+  ASSERT_TRUE(left == left_copy);
+  ASSERT_TRUE(right == right_copy);
+}
+
+TEST(Matrix_Mult_Cann, Mult_Cannon_Stats) {
+  mtrxmult::Matrix left = mtrxmult::random_matrix(40, 40);
+  mtrxmult::Matrix right = mtrxmult::random_matrix(40, 40);
+  mtrxmult::cannon_stats stats;
+
+  omp_set_num_threads(4);
+  mtrxmult::multiply_cannon(&left, &right, &stats);
+
+  ASSERT_GE(stats.shift_time, 0.0);
+  ASSERT_GE(stats.exposed_time, 0.0);
+  ASSERT_GE(stats.hidden_fraction(), 0.0);
+  ASSERT_LE(stats.hidden_fraction(), 1.0);
+}
+
 TEST(Matrix_Mult_Cann, DISABLED_Comparison) {
   mtrxmult::Matrix test_matrix(mtrxmult::random_matrix(1000, 1000));
   mtrxmult::Matrix test_matrix_2(mtrxmult::random_matrix(1000, 1000));
@@ -90,9 +131,12 @@ TEST(Matrix_Mult_Cann, DISABLED_Comparison) {
 
   omp_set_num_threads(4);
   time = omp_get_wtime();
-  res2 = mtrxmult::multiply_cannon(&test_matrix, &test_matrix_2);
+  mtrxmult::cannon_stats stats;
+  res2 = mtrxmult::multiply_cannon(&test_matrix, &test_matrix_2, &stats);
   std::cout << "Elapsed time cannon parll: " << omp_get_wtime() - time << "s"
             << std::endl;
+  std::cout << "Shift time: " << stats.shift_time << "s, hidden "
+            << stats.hidden_fraction() * 100 << "%" << std::endl;
 
   ASSERT_TRUE(res1 == res2 && res2 == res3);
 }
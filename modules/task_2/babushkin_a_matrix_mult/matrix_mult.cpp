@@ -5,9 +5,11 @@
 #include <omp.h>
 
 #include <algorithm>
+#include <cmath>
 #include <random>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace mtrxmult {
@@ -123,7 +125,14 @@ Matrix multiply(const Matrix &left, const Matrix &right,
   return Matrix(result_vector, left.m_rows, right.m_cols);
 }
 
-Matrix multiply_cannon(Matrix *left, Matrix *right) {
+double cannon_stats::hidden_fraction() const {
+  if (shift_time <= 0.0) {
+    return 1.0;
+  }
+  return 1.0 - std::min(exposed_time, shift_time) / shift_time;
+}
+
+Matrix multiply_cannon(Matrix *left, Matrix *right, cannon_stats *stats) {
   if (right->m_data.size() == 0 || left->m_data.size() == 0) {
     throw new std::invalid_argument("Matrices must not be empty");
     return Matrix();
@@ -135,76 +144,133 @@ Matrix multiply_cannon(Matrix *left, Matrix *right) {
     return Matrix();
   }
 
-  if (right->m_rows != right->m_cols) {
+  if (right->m_rows != right->m_cols || left->m_rows != left->m_cols) {
     throw new std::invalid_argument("Matrices must be homogenious");
     return Matrix();
   }
 
   int size = omp_get_max_threads();
-  if (size < 4) {
+  int sqrt_size = std::sqrt(size);
+  // the block grid has to tile the matrix exactly
+  while (sqrt_size > 1 && left->m_cols % sqrt_size != 0) {
+    sqrt_size--;
+  }
+  if (size < 4 || sqrt_size < 2) {
     return multiply(*left, *right, PARALLEL);
   }
 
-  int sqrt_size = std::sqrt(size);
-  int block_size = left->m_cols / sqrt_size;
-
-  // left-circular-shift left matrix i-row by i positions
-  left->shift_left(block_size, true);
-  // Up-circular-shift right matrix i-column by i positions
-  right->shift_up(block_size, true);
-
-  std::vector<double> result(left->m_data.size());
+  const int n = left->m_cols;
+  const int block_size = n / sqrt_size;
+  const int block_length = block_size * block_size;
+  const int grid_size = sqrt_size * sqrt_size;
+
+  // Blocks are stored one after another, so a Cannon shift only has to
+  // rotate a grid of block pointers. The grid is double-buffered: one
+  // thread builds the grid for step iter + 1 while the others multiply.
+  std::vector<double> left_blocks(n * n);
+  std::vector<double> right_blocks(n * n);
+  std::vector<const double *> left_grid(grid_size), right_grid(grid_size);
+  std::vector<const double *> left_next(grid_size), right_next(grid_size);
+  std::vector<double> compute_time(grid_size);
+  std::vector<double> result(n * n);
+  double shift_time = 0.0;
+  double exposed_time = 0.0;
+
+#pragma omp parallel num_threads(grid_size)
+  {
+    int rank = omp_get_thread_num();
+    int row_start = (rank / sqrt_size) * block_size;
+    int col_start = (rank % sqrt_size) * block_size;
+
+    // pack own blocks
+    for (int l = 0; l < block_size; l++) {
+      for (int m = 0; m < block_size; m++) {
+        int from = (row_start + l) * n + col_start + m;
+        left_blocks[rank * block_length + l * block_size + m] =
+            left->m_data[from];
+        right_blocks[rank * block_length + l * block_size + m] =
+            right->m_data[from];
+      }
+    }
 
-  for (int iter = 0; iter < sqrt_size; iter++) {
-#pragma omp parallel
+#pragma omp barrier
+#pragma omp single
     {
-      int rank = omp_get_thread_num();
-      int row_start = (rank / sqrt_size) * block_size;
-      int row_end = row_start + block_size;
-
-      int col_start = (rank % sqrt_size) * block_size;
-      int col_end = col_start + block_size;
-
-      std::vector<double> left_block(block_size * block_size);
-      std::vector<double> right_block(block_size * block_size);
-      std::vector<double> res_block(block_size * block_size);
-
-      // copy blocks
-      for (int r = row_start, l = 0; r < row_end; r++, l++) {
-        for (int c = col_start, m = 0; c < col_end; c++, m++) {
-          left_block.at(l * block_size + m) =
-              left->m_data.at(r * left->m_cols + c);
-          right_block.at(l * block_size + m) =
-              right->m_data.at(r * right->m_cols + c);
-          res_block.at(l * block_size + m) = result.at(r * right->m_cols + c);
+      // initial skew: block row i of left by i, block column j of right by j
+      for (int i = 0; i < sqrt_size; i++) {
+        for (int j = 0; j < sqrt_size; j++) {
+          int k = (i + j) % sqrt_size;
+          left_grid[i * sqrt_size + j] =
+              &left_blocks[(i * sqrt_size + k) * block_length];
+          right_grid[i * sqrt_size + j] =
+              &right_blocks[(k * sqrt_size + j) * block_length];
         }
       }
+    }
 
-      // multiply blocks
-      for (int i = 0; i < block_size; i++) {
-        for (int j = 0; j < block_size; j++) {
-          for (int k = 0; k < block_size; k++) {
-            res_block.at(i * block_size + j) +=
-                left_block.at(i * block_size + k) *
-                right_block.at(k * block_size + j);
+    std::vector<double> res_block(block_length, 0.0);
+
+    for (int iter = 0; iter < sqrt_size; iter++) {
+      double step_start = omp_get_wtime();
+
+      if (iter + 1 < sqrt_size) {
+#pragma omp single nowait
+        {
+          double shift_start = omp_get_wtime();
+          for (int i = 0; i < sqrt_size; i++) {
+            for (int j = 0; j < sqrt_size; j++) {
+              left_next[i * sqrt_size + j] =
+                  left_grid[i * sqrt_size + (j + 1) % sqrt_size];
+              right_next[i * sqrt_size + j] =
+                  right_grid[((i + 1) % sqrt_size) * sqrt_size + j];
+            }
           }
+          shift_time += omp_get_wtime() - shift_start;
         }
       }
 
-      // write blocks back to the result
-      for (int r = row_start, l = 0; r < row_end; r++, l++) {
-        for (int c = col_start, m = 0; c < col_end; c++, m++) {
-          result.at(r * right->m_cols + c) = res_block.at(l * block_size + m);
+      double compute_start = omp_get_wtime();
+      const double *left_block = left_grid[rank];
+      const double *right_block = right_grid[rank];
+      for (int i = 0; i < block_size; i++) {
+        for (int k = 0; k < block_size; k++) {
+          double left_ik = left_block[i * block_size + k];
+          for (int j = 0; j < block_size; j++) {
+            res_block[i * block_size + j] +=
+                left_ik * right_block[k * block_size + j];
+          }
         }
       }
+      compute_time[rank] = omp_get_wtime() - compute_start;
+
+#pragma omp barrier
+#pragma omp single
+      {
+        double step_time = omp_get_wtime() - step_start;
+        double longest = *std::max_element(compute_time.begin(),
+                                           compute_time.end());
+        exposed_time += std::max(0.0, step_time - longest);
+        std::swap(left_grid, left_next);
+        std::swap(right_grid, right_next);
+      }
+    }
+
+    // write blocks back to the result
+    for (int l = 0; l < block_size; l++) {
+      for (int m = 0; m < block_size; m++) {
+        result[(row_start + l) * n + col_start + m] =
+            res_block[l * block_size + m];
+      }
     }
+  }
 
-    left->shift_left(block_size, false);
-    right->shift_up(block_size, false);
+  if (stats != nullptr) {
+    stats->shift_time = shift_time;
+    stats->exposed_time = exposed_time;
   }
 
-  return Matrix(result, left->m_rows, left->m_cols);
-}  // namespace mtrxmult
+  return Matrix(result, n, n);
+}
 
 Matrix random_matrix(const int rows, const int columns) {
   std::mt19937 gen;
@@ -12,6 +12,16 @@
 
 namespace mtrxmult {
 enum direction { up, left };
+
+// Timings of the block shifts in multiply_cannon; exposed_time is the part
+// of the step time that the block products did not cover
+struct cannon_stats {
+  double shift_time = 0.0;
+  double exposed_time = 0.0;
+
+  double hidden_fraction() const;
+};
+
 class Matrix {
  private:
   int m_rows;
@@ -46,14 +56,16 @@ class Matrix {
 
   friend Matrix multiply(const Matrix &left, const Matrix &right,
                          const bool isParallel);
-  friend Matrix multiply_cannon(Matrix *left, Matrix *right);
+  friend Matrix multiply_cannon(Matrix *left, Matrix *right,
+                                cannon_stats *stats);
 
   friend bool operator==(const Matrix &a, const Matrix &b);
   friend bool operator!=(const Matrix &a, const Matrix &b);
 };
 
 Matrix multiply(const Matrix &left, const Matrix &right, const bool isParallel);
-Matrix multiply_cannon(Matrix *left, Matrix *right);
+Matrix multiply_cannon(Matrix *left, Matrix *right,
+                       cannon_stats *stats = nullptr);
 
 Matrix random_matrix(const int rows, const int columns);
 }  // namespace mtrxmult
@@ -120,4 +120,121 @@ Matrix randMatrix(const int& size) {
   return matr;
 }
 
+MatrixBatch::MatrixBatch(const int& count, const int& n)
+    : count_(count), n_(n) {
+    if (count <= 0 || n <= 0)
+        throw "Wrong size batch";
+    data_.assign(groups() * groupLength(), 0.0);
+}
+
+MatrixBatch::MatrixBatch(const std::vector<Matrix>& mats)
+    : MatrixBatch(static_cast<int>(mats.size()),
+                  mats.empty() ? 0 : static_cast<int>(mats[0].size())) {
+    for (int b = 0; b < count_; b++) {
+        if (static_cast<int>(mats[b].size()) != n_ || !isSquare(mats[b]))
+            throw "Matrices of the batch have different sizes";
+        double* dst = group(b / kBatchLanes) + b % kBatchLanes;
+        for (int i = 0; i < n_; i++) {
+            for (int j = 0; j < n_; j++) {
+                dst[(i * n_ + j) * kBatchLanes] = mats[b][i][j];
+            }
+        }
+    }
+}
+
+Matrix MatrixBatch::get(const int& b) const {
+    if (b < 0 || b >= count_)
+        throw "Wrong matrix index";
+    const double* src = group(b / kBatchLanes) + b % kBatchLanes;
+    Matrix res(n_, std::vector<double>(n_));
+    for (int i = 0; i < n_; i++) {
+        for (int j = 0; j < n_; j++) {
+            res[i][j] = src[(i * n_ + j) * kBatchLanes];
+        }
+    }
+    return res;
+}
+
+namespace {
+
+// Multiplies the kBatchLanes interleaved pairs of one group. The innermost
+// loop runs over the lanes, so it is unit-stride and vectorizes; four
+// columns of C are accumulated at once and stay in registers over k.
+template <int N>
+void groupMultFixed(const double* a, const double* b, double* c) {
+    static_assert(N % 4 == 0, "Fixed kernels need a multiple of 4");
+    for (int i = 0; i < N; i++) {
+        const double* aRow = a + i * N * kBatchLanes;
+        for (int j = 0; j < N; j += 4) {
+            double acc[4][kBatchLanes] = {};
+            for (int k = 0; k < N; k++) {
+                const double* aik = aRow + k * kBatchLanes;
+                const double* bkj = b + (k * N + j) * kBatchLanes;
+                for (int jj = 0; jj < 4; jj++) {
+                    for (int l = 0; l < kBatchLanes; l++) {
+                        acc[jj][l] += aik[l] * bkj[jj * kBatchLanes + l];
+                    }
+                }
+            }
+            double* cij = c + (i * N + j) * kBatchLanes;
+            for (int jj = 0; jj < 4; jj++) {
+                for (int l = 0; l < kBatchLanes; l++) {
+                    cij[jj * kBatchLanes + l] = acc[jj][l];
+                }
+            }
+        }
+    }
+}
+
+void groupMult(const int n, const double* a, const double* b, double* c) {
+    for (int i = 0; i < n; i++) {
+        double* cRow = c + i * n * kBatchLanes;
+        std::fill(cRow, cRow + n * kBatchLanes, 0.0);
+        for (int k = 0; k < n; k++) {
+            const double* aik = a + (i * n + k) * kBatchLanes;
+            const double* bRow = b + k * n * kBatchLanes;
+            for (int j = 0; j < n; j++) {
+                for (int l = 0; l < kBatchLanes; l++) {
+                    cRow[j * kBatchLanes + l] += aik[l] * bRow[j * kBatchLanes + l];
+                }
+            }
+        }
+    }
+}
 
+}  // namespace
+
+void batchMult(const MatrixBatch& A, const MatrixBatch& B, MatrixBatch* C) {
+    if (A.count() != B.count() || A.size() != B.size() ||
+        C->count() != A.count() || C->size() != A.size())
+        throw "Different batch sizes";
+    const int n = A.size();
+    const int groups = A.groups();
+
+    #pragma omp parallel for schedule(static)
+    for (int g = 0; g < groups; g++) {
+        const double* a = A.group(g);
+        const double* b = B.group(g);
+        double* c = C->group(g);
+        switch (n) {
+            case 32: groupMultFixed<32>(a, b, c); break;
+            case 48: groupMultFixed<48>(a, b, c); break;
+            case 64: groupMultFixed<64>(a, b, c); break;
+            case 96: groupMultFixed<96>(a, b, c); break;
+            case 128: groupMultFixed<128>(a, b, c); break;
+            default: groupMult(n, a, b, c); break;
+        }
+    }
+}
+
+std::vector<Matrix> batchMult(const std::vector<Matrix>& A,
+                              const std::vector<Matrix>& B) {
+    MatrixBatch a(A), b(B);
+    MatrixBatch c(a.count(), a.size());
+    batchMult(a, b, &c);
+    std::vector<Matrix> res(c.count());
+    for (int i = 0; i < c.count(); i++) {
+        res[i] = c.get(i);
+    }
+    return res;
+}
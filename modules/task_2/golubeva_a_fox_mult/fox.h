@@ -12,4 +12,42 @@ Matrix simpleMult(const Matrix& A, const Matrix& B);
 Matrix foxMult(const Matrix& A, const Matrix& B, const int & numThreads);
 Matrix randMatrix(const int& n);
 
+// Number of matrices interleaved element by element inside one group
+constexpr int kBatchLanes = 8;
+
+// Batch of n x n matrices in batch-major (interleaved) layout: matrices are
+// split into groups of kBatchLanes and element (i, j) of matrix b is stored
+// at group(b / kBatchLanes)[(i * n + j) * kBatchLanes + b % kBatchLanes].
+// The last group is padded with zero matrices.
+class MatrixBatch {
+ public:
+    MatrixBatch(const int& count, const int& n);
+    explicit MatrixBatch(const std::vector<Matrix>& mats);
+
+    int count() const { return count_; }
+    int size() const { return n_; }
+    int groups() const { return (count_ + kBatchLanes - 1) / kBatchLanes; }
+
+    double* group(const int& g) { return &data_[g * groupLength()]; }
+    const double* group(const int& g) const {
+        return &data_[g * groupLength()];
+    }
+    Matrix get(const int& b) const;
+
+ private:
+    size_t groupLength() const {
+        return static_cast<size_t>(n_) * n_ * kBatchLanes;
+    }
+
+    int count_;
+    int n_;
+    std::vector<double> data_;
+};
+
+// C[b] = A[b] * B[b] for every b; the batch is split between the threads,
+// each product runs on a single thread
+void batchMult(const MatrixBatch& A, const MatrixBatch& B, MatrixBatch* C);
+std::vector<Matrix> batchMult(const std::vector<Matrix>& A,
+                              const std::vector<Matrix>& B);
+
 #endif  // MODULES_TASK_2_GOLUBEVA_A_FOX_MULT_FOX_H_
@@ -2,6 +2,8 @@
 
 #include <gtest/gtest.h>
 #include <omp.h>
+#include <iostream>
+#include <vector>
 #include "../../../modules/task_2/golubeva_a_fox_mult/fox.h"
 
 
@@ -64,6 +66,81 @@ TEST(Fox_Mult, res_fox_mult_is_correct) {
   }
 }
 
+TEST(Fox_Mult, batch_keeps_matrices) {
+  std::vector<Matrix> mats;
+  for (int b = 0; b < 11; b++)
+    mats.push_back(randMatrix(5));
+  MatrixBatch batch(mats);
+
+  ASSERT_EQ(batch.count(), 11);
+  ASSERT_EQ(batch.groups(), 2);
+  for (int b = 0; b < 11; b++)
+    ASSERT_EQ(batch.get(b), mats[b]);
+}
+
+TEST(Fox_Mult, cant_do_batch_mult_with_different_size) {
+  std::vector<Matrix> A = {randMatrix(4), randMatrix(4)};
+  std::vector<Matrix> B = {randMatrix(4)};
+  std::vector<Matrix> C = {randMatrix(4), randMatrix(5)};
+
+  ASSERT_ANY_THROW(batchMult(A, B));
+  ASSERT_ANY_THROW(batchMult(A, C));
+}
+
+void checkBatchMult(const int count, const int n) {
+  std::vector<Matrix> A, B;
+  for (int b = 0; b < count; b++) {
+    A.push_back(randMatrix(n));
+    B.push_back(randMatrix(n));
+  }
+
+  std::vector<Matrix> res = batchMult(A, B);
+
+  ASSERT_EQ(static_cast<int>(res.size()), count);
+  for (int b = 0; b < count; b++) {
+    Matrix expected = simpleMult(A[b], B[b]);
+    for (int i = 0; i < n; i++) {
+      for (int j = 0; j < n; j++) {
+        ASSERT_NEAR(res[b][i][j], expected[i][j], 1e-6 * expected[i][j]);
+      }
+    }
+  }
+}
+
+TEST(Fox_Mult, res_batch_mult_is_correct_fixed_size) {
+  checkBatchMult(13, 32);
+}
+
+TEST(Fox_Mult, res_batch_mult_is_correct_any_size) {
+  checkBatchMult(9, 21);
+}
+
+TEST(Fox_Mult, DISABLED_batch_mult_throughput) {
+  for (int n : {32, 64, 128}) {
+    const int count = 2 * 1024 * 1024 / (n * n);
+    std::vector<Matrix> A, B;
+    for (int b = 0; b < count; b++) {
+      A.push_back(randMatrix(n));
+      B.push_back(randMatrix(n));
+    }
+    MatrixBatch a(A), b(B), c(count, n);
+    double flops = 2.0 * n * n * n * count;
+
+    double start = omp_get_wtime();
+    for (int i = 0; i < count; i++)
+      foxMult(A[i], B[i], 4);
+    double foxTime = omp_get_wtime() - start;
+
+    start = omp_get_wtime();
+    batchMult(a, b, &c);
+    double batchTime = omp_get_wtime() - start;
+
+    std::cout << n << "x" << n << ", " << count << " matrices: fox "
+              << flops / foxTime * 1e-9 << " GFLOP/s, batched "
+              << flops / batchTime * 1e-9 << " GFLOP/s" << std::endl;
+  }
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
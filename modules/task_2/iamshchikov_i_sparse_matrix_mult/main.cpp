@@ -4,6 +4,7 @@
 #include <random>
 #include <ctime>
 #include <cmath>
+#include <iostream>
 #include "./sparse_matrix_mult.h"
 
 TEST(sparse_matrix_mult_seq, can_create_matrix) {
@@ -98,6 +99,66 @@ TEST(sparse_matrix_mult_seq, multiply_matrix_by_matrix) {
     EXPECT_EQ(m3, matrixMultiplicate(&m1, &m2));
 }
 
+TEST(sparse_matrix_mult_seq, gustavson_multiply_matrix_by_matrix) {
+    CcsMatrix m1(4, 5, 6);
+    m1.value = { 1, 3, 2, 5, 4, 8 };
+    m1.row = { 0, 3, 1, 2, 3, 0 };
+    m1.colIndex = { 0, 1, 2, 3, 5, 6 };
+
+    CcsMatrix m2(5, 3, 5);
+    m2.value = { 1, 6, 3, 7, 2 };
+    m2.row = { 0, 4, 3, 1, 4 };
+    m2.colIndex = { 0, 2, 3, 5 };
+
+    CcsMatrix m3(4, 3, 5);
+    m3.value = { 49, 15, 12, 16, 21};
+    m3.row = { 0, 2, 3, 0, 3 };
+    m3.colIndex = { 0, 1, 3, 5 };
+
+    EXPECT_EQ(m3, gustavsonMultiplicate(&m1, &m2));
+}
+
+TEST(sparse_matrix_mult_seq, gustavson_drops_zero_sums) {
+    CcsMatrix m1(2, 2, 3);
+    m1.value = { 1, 1, 2 };
+    m1.row = { 0, 0, 1 };
+    m1.colIndex = { 0, 1, 3 };
+
+    CcsMatrix m2(2, 2, 4);
+    m2.value = { 3, -3, 1, 1 };
+    m2.row = { 0, 1, 0, 1 };
+    m2.colIndex = { 0, 2, 4 };
+
+    CcsMatrix m3(2, 2, 3);
+    m3.value = { -6, 2, 2 };
+    m3.row = { 1, 0, 1 };
+    m3.colIndex = { 0, 1, 3 };
+
+    EXPECT_EQ(m3, gustavsonMultiplicate(&m1, &m2));
+    EXPECT_EQ(matrixMultiplicate(&m1, &m2), gustavsonMultiplicate(&m1, &m2));
+}
+
+TEST(sparse_matrix_mult_seq, gustavson_throws_when_matrices_are_incompatible) {
+    CcsMatrix m1(4, 5, 0);
+    CcsMatrix m2(4, 5, 0);
+
+    ASSERT_ANY_THROW(gustavsonMultiplicate(&m1, &m2));
+}
+
+TEST(sparse_matrix_mult_seq, DISABLED_gustavson_time) {
+    CcsMatrix m1(generateMatrix(3000, 3000));
+    CcsMatrix m2(generateMatrix(3000, 3000));
+
+    double t1 = omp_get_wtime();
+    matrixMultiplicate(&m1, &m2);
+    double t2 = omp_get_wtime();
+    gustavsonMultiplicate(&m1, &m2);
+    double t3 = omp_get_wtime();
+
+    std::cout << "Dot products: " << t2 - t1 << std::endl;
+    std::cout << "Gustavson: " << t3 - t2 << std::endl;
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
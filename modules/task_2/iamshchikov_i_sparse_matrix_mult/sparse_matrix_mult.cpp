@@ -167,3 +167,85 @@ CcsMatrix matrixMultiplicate(const CcsMatrix* m1, const CcsMatrix* m2) {
 
     return res;
 }
+
+CcsMatrix gustavsonMultiplicate(const CcsMatrix* m1, const CcsMatrix* m2) {
+    if (m1->N != m2->M) throw "m1 and m2 are incompatible";
+    CcsMatrix res(m1->M, m2->N, 0);
+
+    // symbolic pass: number of structural nonzeros in every column of res
+    #pragma omp parallel
+    {
+        std::vector<int> marker(m1->M, -1);
+        #pragma omp for schedule(dynamic, 64)
+        for (int j = 0; j < m2->N; j++) {
+            int colNZ = 0;
+            for (int l = m2->colIndex[j]; l < m2->colIndex[j + 1]; l++) {
+                int k = m2->row[l];
+                for (int t = m1->colIndex[k]; t < m1->colIndex[k + 1]; t++) {
+                    if (marker[m1->row[t]] != j) {
+                        marker[m1->row[t]] = j;
+                        colNZ++;
+                    }
+                }
+            }
+            res.colIndex[j + 1] = colNZ;
+        }
+    }
+    for (int j = 0; j < res.N; j++)
+        res.colIndex[j + 1] += res.colIndex[j];
+    res.value.resize(res.colIndex.back());
+    res.row.resize(res.colIndex.back());
+
+    // numeric pass, zero sums are not stored like in matrixMultiplicate
+    std::vector<int> col_size(res.N, 0);
+    #pragma omp parallel
+    {
+        std::vector<int> marker(m1->M, -1);
+        std::vector<double> acc(m1->M);
+        std::vector<int> touched;
+        #pragma omp for schedule(dynamic, 64)
+        for (int j = 0; j < m2->N; j++) {
+            touched.clear();
+            for (int l = m2->colIndex[j]; l < m2->colIndex[j + 1]; l++) {
+                int k = m2->row[l];
+                double v = m2->value[l];
+                for (int t = m1->colIndex[k]; t < m1->colIndex[k + 1]; t++) {
+                    int i = m1->row[t];
+                    if (marker[i] != j) {
+                        marker[i] = j;
+                        acc[i] = 0;
+                        touched.push_back(i);
+                    }
+                    acc[i] += m1->value[t] * v;
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            int pos = res.colIndex[j];
+            for (int i : touched) {
+                if (acc[i] != 0) {
+                    res.value[pos] = acc[i];
+                    res.row[pos++] = i;
+                }
+            }
+            col_size[j] = pos - res.colIndex[j];
+        }
+    }
+
+    // close the gaps left by zero sums
+    int nz = 0;
+    for (int j = 0; j < res.N; j++) {
+        int from = res.colIndex[j];
+        for (int l = 0; l < col_size[j]; l++) {
+            res.value[nz + l] = res.value[from + l];
+            res.row[nz + l] = res.row[from + l];
+        }
+        res.colIndex[j] = nz;
+        nz += col_size[j];
+    }
+    res.colIndex[res.N] = nz;
+    res.value.resize(nz);
+    res.row.resize(nz);
+    res.not_zero_number = nz;
+
+    return res;
+}
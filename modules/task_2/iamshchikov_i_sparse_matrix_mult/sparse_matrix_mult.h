@@ -22,5 +22,8 @@ CcsMatrix transposeMatrix(const CcsMatrix* m);
 double scalarMultiplication(const CcsMatrix* transposed_m, const CcsMatrix* m,
                             int i, int j);
 CcsMatrix matrixMultiplicate(const CcsMatrix* m1, const CcsMatrix* m2);
+// Column-wise Gustavson product res(:, j) = sum m1(:, k) * m2(k, j),
+// m1 is not transposed and every thread keeps a dense accumulator
+CcsMatrix gustavsonMultiplicate(const CcsMatrix* m1, const CcsMatrix* m2);
 
 #endif  // MODULES_TASK_2_IAMSHCHIKOV_I_SPARSE_MATRIX_MULT_SPARSE_MATRIX_MULT_H_
@@ -145,3 +145,106 @@ Matrix foxAlgParallel(const Matrix& mat1, const Matrix& mat2, const unsigned& n_
     res.resize(old_n);
     return res;
 }
+
+DenseMatrix::DenseMatrix(size_t rows, size_t cols)
+    : rows_(rows), cols_(cols),
+      stride_((cols + kAlignment / sizeof(double) - 1) / (kAlignment / sizeof(double)) * (kAlignment / sizeof(double))),
+      storage_(rows_ * stride_, 0.0) {}
+
+DenseMatrix::DenseMatrix(const Matrix& mat) : DenseMatrix(mat.size(), mat.empty() ? 0 : mat[0].size()) {
+    for (size_t i = 0; i < rows_; ++i) {
+        if (mat[i].size() != cols_)
+            throw std::logic_error("Rows have different size");
+        std::copy(mat[i].begin(), mat[i].end(), data() + i * stride_);
+    }
+}
+
+Matrix DenseMatrix::toMatrix() const {
+    Matrix res(rows_);
+    for (size_t i = 0; i < rows_; ++i)
+        res[i].assign(data() + i * stride_, data() + i * stride_ + cols_);
+    return res;
+}
+
+void multiplyAdd(const ConstMatrixView& a, const ConstMatrixView& b, const MatrixView& c) {
+    for (size_t i = 0; i < a.rows; ++i) {
+        double* c_row = &c(i, 0);
+        for (size_t k = 0; k < a.cols; ++k) {
+            const double a_ik = a(i, k);
+            const double* b_row = &b(k, 0);
+            for (size_t j = 0; j < b.cols; ++j)
+                c_row[j] += a_ik * b_row[j];
+        }
+    }
+}
+
+DenseMatrix naiveMultiplication(const DenseMatrix& mat1, const DenseMatrix& mat2) {
+    if (mat1.cols() != mat2.rows())
+        throw std::exception();
+    DenseMatrix res(mat1.rows(), mat2.cols());
+    multiplyAdd(mat1.view(), mat2.view(), res.view());
+    return res;
+}
+
+DenseMatrix blockMultiplication(const DenseMatrix& mat1, const DenseMatrix& mat2) {
+    if (mat1.rows() != mat1.cols() || mat2.rows() != mat2.cols() || mat1.rows() != mat2.rows())
+        throw std::logic_error("Matrix should be squared");
+    size_t n = mat1.rows();
+    size_t block_size = n == 0 ? 1 : static_cast<size_t>(std::sqrt(n));
+    DenseMatrix res(n, n);
+
+    for (size_t ii = 0; ii < n; ii += block_size) {
+        size_t bi = std::min(block_size, n - ii);
+        for (size_t kk = 0; kk < n; kk += block_size) {
+            size_t bk = std::min(block_size, n - kk);
+            for (size_t jj = 0; jj < n; jj += block_size) {
+                size_t bj = std::min(block_size, n - jj);
+                multiplyAdd(mat1.view().block(ii, kk, bi, bk), mat2.view().block(kk, jj, bk, bj),
+                            res.view().block(ii, jj, bi, bj));
+            }
+        }
+    }
+    return res;
+}
+
+// Both grid algorithms give block (i, j) of the result to one thread; at step s it
+// multiplies A(i, k) by B(k, j) with k = (i + s) % q for Fox and (i + j + s) % q for
+// Cannon. Blocks are views into the inputs, so nothing is copied or padded: when q
+// does not divide n the last block row/column is just larger.
+static DenseMatrix gridMultiplication(const DenseMatrix& mat1, const DenseMatrix& mat2,
+                                      const unsigned& n_threads, bool cannon) {
+    if (mat1.rows() != mat1.cols() || mat2.rows() != mat2.cols() || mat1.rows() != mat2.rows())
+        throw std::logic_error("Matrix should be squared");
+
+    size_t n = mat1.rows();
+    size_t q = std::max<size_t>(1, static_cast<size_t>(std::sqrt(n_threads)));
+    q = std::min(q, std::max<size_t>(1, n));
+    size_t block_size = n / q;
+    DenseMatrix res(n, n);
+
+    auto blockBegin = [&](size_t b) { return b * block_size; };
+    auto blockLen = [&](size_t b) { return b == q - 1 ? n - b * block_size : block_size; };
+
+    #pragma omp parallel for num_threads(q*q)
+    for (int t = 0; t < static_cast<int>(q * q); ++t) {
+        size_t thread_i = t / q;
+        size_t thread_j = t % q;
+        MatrixView c = res.view().block(blockBegin(thread_i), blockBegin(thread_j),
+                                        blockLen(thread_i), blockLen(thread_j));
+        for (size_t step = 0; step < q; ++step) {
+            size_t k_bar = cannon ? (thread_i + thread_j + step) % q : (thread_i + step) % q;
+            multiplyAdd(mat1.view().block(blockBegin(thread_i), blockBegin(k_bar), blockLen(thread_i), blockLen(k_bar)),
+                        mat2.view().block(blockBegin(k_bar), blockBegin(thread_j), blockLen(k_bar), blockLen(thread_j)),
+                        c);
+        }
+    }
+    return res;
+}
+
+DenseMatrix foxAlgParallel(const DenseMatrix& mat1, const DenseMatrix& mat2, const unsigned& n_threads) {
+    return gridMultiplication(mat1, mat2, n_threads, false);
+}
+
+DenseMatrix cannonAlgParallel(const DenseMatrix& mat1, const DenseMatrix& mat2, const unsigned& n_threads) {
+    return gridMultiplication(mat1, mat2, n_threads, true);
+}
@@ -3,6 +3,9 @@
 #define MODULES_TASK_2_ISAEV_FOX_ALG_FOX_ALG_H_
 
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <vector>
 
 using Matrix = std::vector<std::vector<double>>;
@@ -22,4 +25,88 @@ bool matrixComparison(const Matrix& mat1, const Matrix& mat2);
 
 Matrix foxAlgParallel(const Matrix& mat1, const Matrix& mat2, const unsigned& n_threads);
 
+// Allocator giving kAlignment-byte aligned storage to std::vector
+const size_t kAlignment = 64;
+
+template <class T>
+struct AlignedAllocator {
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U>&) noexcept {}  // NOLINT(runtime/explicit)
+
+    T* allocate(size_t n) {
+        void* raw = ::operator new(n * sizeof(T) + kAlignment);
+        uintptr_t aligned = (reinterpret_cast<uintptr_t>(raw) + kAlignment) & ~(kAlignment - 1);
+        reinterpret_cast<void**>(aligned)[-1] = raw;
+        return reinterpret_cast<T*>(aligned);
+    }
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(reinterpret_cast<void**>(p)[-1]);
+    }
+};
+
+template <class T, class U>
+bool operator==(const AlignedAllocator<T>&, const AlignedAllocator<U>&) noexcept { return true; }
+template <class T, class U>
+bool operator!=(const AlignedAllocator<T>&, const AlignedAllocator<U>&) noexcept { return false; }
+
+// Strided window into row-major storage, element (i, j) is data[i * stride + j]
+template <class T>
+struct BasicMatrixView {
+    T* data;
+    size_t rows;
+    size_t cols;
+    size_t stride;
+
+    BasicMatrixView(T* _data, size_t _rows, size_t _cols, size_t _stride)
+        : data(_data), rows(_rows), cols(_cols), stride(_stride) {}
+    template <class U>
+    BasicMatrixView(const BasicMatrixView<U>& other)  // NOLINT(runtime/explicit)
+        : data(other.data), rows(other.rows), cols(other.cols), stride(other.stride) {}
+
+    T& operator()(size_t i, size_t j) const { return data[i * stride + j]; }
+    BasicMatrixView block(size_t row, size_t col, size_t n_rows, size_t n_cols) const {
+        return {data + row * stride + col, n_rows, n_cols, stride};
+    }
+};
+
+using MatrixView = BasicMatrixView<double>;
+using ConstMatrixView = BasicMatrixView<const double>;
+
+// Contiguous row-major matrix. Every row starts on a kAlignment boundary
+// (the stride is padded to a whole number of cache lines).
+class DenseMatrix {
+ public:
+    DenseMatrix(size_t rows, size_t cols);
+    explicit DenseMatrix(const Matrix& mat);
+
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    size_t stride() const noexcept { return stride_; }
+    double* data() noexcept { return storage_.data(); }
+    const double* data() const noexcept { return storage_.data(); }
+    double& operator()(size_t i, size_t j) noexcept { return storage_[i * stride_ + j]; }
+    const double& operator()(size_t i, size_t j) const noexcept { return storage_[i * stride_ + j]; }
+
+    MatrixView view() noexcept { return {data(), rows_, cols_, stride_}; }
+    ConstMatrixView view() const noexcept { return {data(), rows_, cols_, stride_}; }
+    Matrix toMatrix() const;
+
+ private:
+    size_t rows_;
+    size_t cols_;
+    size_t stride_;
+    std::vector<double, AlignedAllocator<double>> storage_;
+};
+
+// c += a * b on views
+void multiplyAdd(const ConstMatrixView& a, const ConstMatrixView& b, const MatrixView& c);
+
+DenseMatrix naiveMultiplication(const DenseMatrix& mat1, const DenseMatrix& mat2);
+DenseMatrix blockMultiplication(const DenseMatrix& mat1, const DenseMatrix& mat2);
+DenseMatrix foxAlgParallel(const DenseMatrix& mat1, const DenseMatrix& mat2, const unsigned& n_threads);
+DenseMatrix cannonAlgParallel(const DenseMatrix& mat1, const DenseMatrix& mat2, const unsigned& n_threads);
+
 #endif  // MODULES_TASK_2_ISAEV_FOX_ALG_FOX_ALG_H_
@@ -1,6 +1,8 @@
 // Copyright 2020 Isaev Ilya
 #include <omp.h>
 #include <gtest/gtest.h>
+#include <cstdint>
+#include <iostream>
 #include <vector>
 #include "../../../modules/task_2/isaev_fox_alg/fox_alg.h"
 
@@ -73,7 +75,69 @@ TEST(Omp_Fox, Parallel_And_Block_Have_The_Same_Answer15x15) {
     ASSERT_TRUE(matrixComparison(res1, res2));
 }
 
+TEST(Omp_Fox, Dense_Matrix_Rows_Are_Aligned) {
+    DenseMatrix mat(5, 13);
 
+    ASSERT_EQ(mat.stride() % (kAlignment / sizeof(double)), 0u);
+    for (size_t i = 0; i < mat.rows(); ++i)
+        ASSERT_EQ(reinterpret_cast<uintptr_t>(&mat(i, 0)) % kAlignment, 0u);
+}
+
+TEST(Omp_Fox, Dense_Matrix_Round_Trip) {
+    auto mat = getRandomMatrix(7);
+
+    ASSERT_EQ(DenseMatrix(mat).toMatrix(), mat);
+}
+
+TEST(Omp_Fox, Dense_Matrix_View_Block) {
+    Matrix mat = {{1, 2, 3},
+                  {4, 5, 6},
+                  {7, 8, 9}};
+    DenseMatrix dense(mat);
+    ConstMatrixView block = dense.view().block(1, 1, 2, 2);
+
+    ASSERT_EQ(block(0, 0), 5);
+    ASSERT_EQ(block(1, 0), 8);
+    ASSERT_EQ(block(1, 1), 9);
+}
+
+TEST(Omp_Fox, Dense_Naive_Block_Fox_Cannon_Have_The_Same_Answer15x15) {
+    auto mat1 = getRandomMatrix(15);
+    auto mat2 = getRandomMatrix(15);
+    DenseMatrix dense1(mat1), dense2(mat2);
+
+    auto expected = naiveMultiplication(mat1, mat2);
+
+    ASSERT_TRUE(matrixComparison(naiveMultiplication(dense1, dense2).toMatrix(), expected));
+    ASSERT_TRUE(matrixComparison(blockMultiplication(dense1, dense2).toMatrix(), expected));
+    ASSERT_TRUE(matrixComparison(foxAlgParallel(dense1, dense2, 4).toMatrix(), expected));
+    ASSERT_TRUE(matrixComparison(cannonAlgParallel(dense1, dense2, 9).toMatrix(), expected));
+}
+
+TEST(Omp_Fox, Dense_Fox_Throws_On_NonEqual_Matrix) {
+    DenseMatrix a(5, 5), b(6, 6);
+
+    ASSERT_ANY_THROW(foxAlgParallel(a, b, 4));
+}
+
+TEST(Omp_Fox, DISABLED_Dense_And_Nested_Vector_Time2048) {
+    auto mat1 = getRandomMatrix(2048);
+    auto mat2 = getRandomMatrix(2048);
+    DenseMatrix dense1(mat1), dense2(mat2);
+
+    double t = omp_get_wtime();
+    auto res1 = foxAlgParallel(mat1, mat2, 4);
+    double nested_time = omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    auto res2 = foxAlgParallel(dense1, dense2, 4);
+    double dense_time = omp_get_wtime() - t;
+
+    std::cout << "vector<vector<double>> Fox: " << nested_time << std::endl
+              << "DenseMatrix Fox: " << dense_time << std::endl;
+
+    ASSERT_TRUE(matrixComparison(res1, res2.toMatrix()));
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -107,6 +107,32 @@ TEST(Sparce_Matrix, can_transpose) {
   ASSERT_EQ(TrMatrix.point, check_point);
 }
 
+TEST(Sparce_Matrix, can_transpose_random_into_existing_matrix) {
+  SparceMatrix A(45, 70, 300);
+  SparceMatrix Tr(1, 1);
+  A.Transpose(&Tr);
+  ASSERT_EQ(Tr.nCol, 70);
+  ASSERT_EQ(Tr.nRow, 45);
+  std::vector<std::vector<std::complex<int>>> dense(70, std::vector<std::complex<int>>(45));
+  for (int j = 0; j < Tr.nCol; j++) {
+    int start = (j == 0) ? 0 : Tr.point[j - 1];
+    for (int k = start; k < Tr.point[j]; k++) {
+      if (k > start) {
+        ASSERT_LT(Tr.row_number[k - 1], Tr.row_number[k]);
+      }
+      dense[j][Tr.row_number[k]] = Tr.val[k];
+    }
+  }
+  for (int j = 0; j < A.nCol; j++) {
+    int start = (j == 0) ? 0 : A.point[j - 1];
+    for (int k = start; k < A.point[j]; k++)
+      ASSERT_EQ(dense[A.row_number[k]][j], A.val[k]);
+  }
+  SparceMatrix Back(1, 1);
+  Tr.Transpose(&Back);
+  ASSERT_TRUE(Back == A);
+}
+
 TEST(Sparce_Matrix, can_multiplication_without_throw) {
   SparceMatrix A(5, 3, 5);
   SparceMatrix B(3, 5, 10);
@@ -7,6 +7,7 @@
 #include <iostream>
 #include <complex>
 #include <algorithm>
+#include <cstdint>
 #include "../../../modules/task_2/karin_t_sparce_matrix_complex_CCS/sparce_matrix.h"
 
 SparceMatrix::SparceMatrix(int _nCol, int _nRow) {
@@ -116,26 +117,69 @@ SparceMatrix::SparceMatrix(int _nCol, int _nRow, std::vector<std::complex<int>>
 
 SparceMatrix SparceMatrix::Transpose() const {
   SparceMatrix Tr(this->nRow, this->nCol);
-  std::vector<std::vector<int>> matr(nRow);
-  std::vector<int> cols;
-  int iter = 0;
-  for (unsigned i = 0; i < row_number.size(); i++) {
-    while ((static_cast<int>(i) >= point[iter]) && (iter != nCol-1))
-      iter++;
-    matr[row_number[i]].push_back(i);
-    cols.push_back(iter);
-  }
-  Tr.point[0] = matr[0].size();
-  for (int i = 1; i < nRow; i++)
-    Tr.point[i] = Tr.point[i-1] + matr[i].size();
-  for (int i = 0; i < nRow; i++)
-    for (unsigned j = 0; j < matr[i].size(); j++) {
-      Tr.val.push_back(val[matr[i][j]]);
-      Tr.row_number.push_back(cols[matr[i][j]]);
-    }
+  Transpose(&Tr);
   return Tr;
 }
 
+void SparceMatrix::Transpose(SparceMatrix* Tr) const {
+  // Per-thread row counts, a prefix sum, then an in-order scatter of each thread's columns
+  static thread_local std::vector<int> counters;
+  const int threads = std::max(1, std::min(omp_get_max_threads(), nCol));
+  const int not_null = val.size();
+  Tr->nCol = nRow;
+  Tr->nRow = nCol;
+  Tr->point.resize(nRow);
+  Tr->val.resize(not_null);
+  Tr->row_number.resize(not_null);
+  counters.assign(static_cast<size_t>(threads) * nRow, 0);
+  int* count = counters.data();
+
+  #pragma omp parallel num_threads(threads)
+  {
+    const int tid = omp_get_thread_num();
+    const int num = omp_get_num_threads();
+    const int first = static_cast<int64_t>(nCol) * tid / num;
+    const int last = static_cast<int64_t>(nCol) * (tid + 1) / num;
+    int* own = count + static_cast<size_t>(tid) * nRow;
+    // the last column runs to the end of val, as in ScalarMult
+    for (int j = first; j < last; j++) {
+      int stop = (j == nCol - 1) ? not_null : point[j];
+      for (int k = (j == 0) ? 0 : point[j - 1]; k < stop; k++)
+        own[row_number[k]]++;
+    }
+    #pragma omp barrier
+    #pragma omp for schedule(static)
+    for (int i = 0; i < nRow; i++) {
+      int total = 0;
+      for (int t = 0; t < num; t++)
+        total += count[static_cast<size_t>(t) * nRow + i];
+      Tr->point[i] = total;
+    }
+    #pragma omp single
+    {
+      for (int i = 0; i < nRow - 1; i++)
+        Tr->point[i + 1] += Tr->point[i];
+    }
+    #pragma omp for schedule(static)
+    for (int i = 0; i < nRow; i++) {
+      int pos = (i == 0) ? 0 : Tr->point[i - 1];
+      for (int t = 0; t < num; t++) {
+        int row_count = count[static_cast<size_t>(t) * nRow + i];
+        count[static_cast<size_t>(t) * nRow + i] = pos;
+        pos += row_count;
+      }
+    }
+    for (int j = first; j < last; j++) {
+      int stop = (j == nCol - 1) ? not_null : point[j];
+      for (int k = (j == 0) ? 0 : point[j - 1]; k < stop; k++) {
+        int pos = own[row_number[k]]++;
+        Tr->val[pos] = val[k];
+        Tr->row_number[pos] = j;
+      }
+    }
+  }
+}
+
 SparceMatrix SparceMatrix::operator*(const SparceMatrix& B) {
   if (this->nRow != B.nCol)
     throw "wrong matrix size";
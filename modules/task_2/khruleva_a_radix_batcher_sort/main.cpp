@@ -8,6 +8,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <bitset>
+#include <cstdint>
 #include <algorithm>
 #include "gtest/gtest.h"
 #include "../../../modules/task_2/khruleva_a_radix_batcher_sort/radix_batcher_sort.h"
@@ -75,6 +76,56 @@ TEST(Radix_Batcher_Sort_OMP, Can_Odd_Even_Merge_Properly) {
     ASSERT_EQ((int)std::equal(&result1[0], &result1[n / 2], &result[0]), 1);
 }
 
+TEST(Radix_Batcher_Sort_OMP, Can_Sort_Negative_Elements_By_All_Bits) {
+    int n = 9;
+    std::vector<int> array = { 5, -3, 2147483647, 0, -2147483647 - 1, -1, 7, -3, 256 };
+    std::vector<int> b = array;
+    least_significant_digit_sort(array.data(), n, 32);
+    std::sort(b.begin(), b.end());
+    ASSERT_EQ(array, b);
+}
+
+TEST(Radix_Batcher_Sort_OMP, Parallel_Sort_Equals_Sequential) {
+    const int sizes[] = { 1, 3, 1000, 70000, (1 << 20) + 5 };
+    const int bits[] = { BITS, 20, 32 };
+    std::mt19937 gen(7);
+    for (int n : sizes) {
+        std::vector<int> array(n);
+        for (int i = 0; i < n; i++)
+            array[i] = static_cast<int>(gen());
+        for (int bits_value : bits) {
+            std::vector<int> seq = array, omp = array;
+            least_significant_digit_sort(seq.data(), n, bits_value);
+            parallel_least_significant_digit_sort(omp.data(), n, THREADS, bits_value);
+            ASSERT_EQ(seq, omp);
+            const uint32_t mask = bits_value >= 32 ? ~0u : (1u << bits_value) - 1;
+            for (int i = 1; i < n && bits_value < 32; i++)
+                ASSERT_LE(static_cast<uint32_t>(seq[i - 1]) & mask, static_cast<uint32_t>(seq[i]) & mask);
+        }
+        std::vector<int> b = array;
+        std::sort(b.begin(), b.end());
+        parallel_least_significant_digit_sort(array.data(), n, THREADS, 32);
+        ASSERT_EQ(array, b);
+    }
+}
+
+
+TEST(Radix_Batcher_Sort_OMP, Parallel_Sort_With_Skipped_Digits) {
+    // 70000 keys are sorted by 11-bit digits: the keys share the low digit
+    // in the first array and the middle one in the second
+    const int n = 70000;
+    const uint32_t masks[] = { ~0x7ffu, ~(0x7ffu << 11) };
+    std::mt19937 gen(11);
+    for (uint32_t mask : masks) {
+        std::vector<int> array(n);
+        for (int i = 0; i < n; i++)
+            array[i] = static_cast<int>((gen() & mask) | (0x2d2d2du & ~mask));
+        std::vector<int> b = array;
+        std::sort(b.begin(), b.end());
+        parallel_least_significant_digit_sort(array.data(), n, THREADS, 32);
+        ASSERT_EQ(array, b);
+    }
+}
 
 TEST(Radix_Batcher_Sort_OMP, DISABLED_Compare_Seq_and_Omp_Average_Time) {
     omp_set_nested(1);
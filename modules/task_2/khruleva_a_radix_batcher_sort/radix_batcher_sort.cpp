@@ -11,6 +11,8 @@
 #include <cmath>
 #include <cstdlib>
 #include <bitset>
+#include <cstdint>
+#include <cstring>
 #include "../../../modules/task_2/khruleva_a_radix_batcher_sort/radix_batcher_sort.h"
 
 void gen_rnd_arr(int* arr, int size, int bits_value) {
@@ -103,28 +105,166 @@ void odd_even_merger(int* arr, int size) {
     delete[] right_arr;
 }
 
+int digit_bits(int size) {
+    if (size < (1 << 16))
+        return 8;
+    return size < (1 << 23) ? 11 : 16;
+}
+
+// Large inputs are scattered through a buffer of one cache line per bucket,
+// so the output is written a whole line at a time
+const int kLineKeys = 16;
+const int kLineMinSize = 1 << 20;
+
+struct digit_pass {
+    int shift;
+    uint32_t mask;  // digit mask cut to the sorted bits
+};
+
+static void scatter_by_digit(const uint32_t* src, uint32_t* dst, int begin, int end, digit_pass pass,
+                             int* pos, uint32_t* lines, int* fill) {
+    if (lines == nullptr) {
+        for (int i = begin; i < end; ++i)
+            dst[pos[(src[i] >> pass.shift) & pass.mask]++] = src[i];
+        return;
+    }
+    for (int i = begin; i < end; ++i) {
+        uint32_t digit = (src[i] >> pass.shift) & pass.mask;
+        lines[digit * kLineKeys + fill[digit]++] = src[i];
+        if (fill[digit] == kLineKeys) {
+            memcpy(dst + pos[digit], lines + digit * kLineKeys, sizeof(uint32_t) * kLineKeys);
+            pos[digit] += kLineKeys;
+            fill[digit] = 0;
+        }
+    }
+    for (uint32_t digit = 0; digit <= pass.mask; ++digit) {
+        memcpy(dst + pos[digit], lines + digit * kLineKeys, sizeof(uint32_t) * fill[digit]);
+        pos[digit] += fill[digit];
+        fill[digit] = 0;
+    }
+}
+
+static std::vector<digit_pass> digit_passes(int size, int bits) {
+    int width = digit_bits(size);
+    bits = std::min(std::max(bits, 0), 32);
+    std::vector<digit_pass> passes;
+    for (int shift = 0; shift < bits; shift += width) {
+        int len = std::min(width, bits - shift);
+        passes.push_back({ shift, static_cast<uint32_t>((1ull << len) - 1) });
+    }
+    return passes;
+}
+
 void least_significant_digit_sort(int* arr, int size, int bits) {
-    int** numbers = new int* [2];
-    numbers[0] = new int[size];
-    numbers[1] = new int[size];
-    int counters[] = { 0, 0 };
-    for (int bit_num = 0; bit_num < bits; ++bit_num) {
-        for (int i = 0; i < size; ++i) {
-            int bit = ((arr[i] >> bit_num) & 1);
-            numbers[bit][counters[bit]] = arr[i];
-            ++counters[bit];
+    std::vector<digit_pass> passes = digit_passes(size, bits);
+    if (size <= 0 || passes.empty())
+        return;
+    const int buckets = 1 << digit_bits(size);
+    const int passes_count = passes.size();
+    // With all 32 bits the sign bit is flipped to order negative numbers
+    // first; the counters of all digits are filled in one pass
+    const uint32_t flip = bits >= 32 ? 0x80000000u : 0;
+    std::vector<uint32_t> keys(size), tmp(size);
+    std::vector<int> count(passes_count * buckets, 0);
+    for (int i = 0; i < size; ++i) {
+        uint32_t key = static_cast<uint32_t>(arr[i]) ^ flip;
+        keys[i] = key;
+        for (int p = 0; p < passes_count; ++p)
+            ++count[p * buckets + ((key >> passes[p].shift) & passes[p].mask)];
+    }
+
+    uint32_t* src = keys.data();
+    uint32_t* dst = tmp.data();
+    std::vector<int> pos(buckets), fill(buckets, 0);
+    std::vector<uint32_t> lines(size >= kLineMinSize && buckets <= 2048 ? buckets * kLineKeys : 0);
+    for (int p = 0; p < passes_count; ++p) {
+        const int* digit_count = &count[p * buckets];
+        if (digit_count[(src[0] >> passes[p].shift) & passes[p].mask] == size)
+            continue;  // the digit is the same for all numbers
+        int sum = 0;
+        for (int b = 0; b < buckets; ++b) {
+            pos[b] = sum;
+            sum += digit_count[b];
         }
-        int k = 0;
-        for (int i = 0; i < counters[0]; ++i, ++k)
-            arr[k] = numbers[0][i];
-        for (int i = 0; i < counters[1]; ++i, ++k)
-            arr[k] = numbers[1][i];
-         counters[0] = counters[1] = 0;
+        scatter_by_digit(src, dst, 0, size, passes[p], pos.data(), lines.empty() ? nullptr : lines.data(),
+                         fill.data());
+        std::swap(src, dst);
     }
+    for (int i = 0; i < size; ++i)
+        arr[i] = static_cast<int>(src[i] ^ flip);
+}
 
-    delete[] numbers[0];
-    delete[] numbers[1];
-    delete[] numbers;
+void parallel_least_significant_digit_sort(int* arr, int size, int threads_value, int bits) {
+    std::vector<digit_pass> passes = digit_passes(size, bits);
+    if (size <= 0 || passes.empty())
+        return;
+    threads_value = std::max(1, std::min(threads_value, size));
+    const int buckets = 1 << digit_bits(size);
+    const int passes_count = passes.size();
+    const uint32_t flip = bits >= 32 ? 0x80000000u : 0;
+    const bool use_lines = size >= kLineMinSize && buckets <= 2048;
+    std::vector<uint32_t> keys(size), tmp(size);
+    // Counters of thread t for pass p start at (p * threads_value + t) * buckets;
+    // the numbers of every chunk keep their order inside a bucket, so the
+    // chunks are placed bucket by bucket in thread order
+    std::vector<int> count(passes_count * threads_value * buckets, 0);
+    std::vector<int> pos(threads_value * buckets);
+    std::vector<char> skip(passes_count, 0);
+
+#pragma omp parallel num_threads(threads_value)
+    {
+        const int t = omp_get_thread_num();
+        const int begin = static_cast<int>(static_cast<int64_t>(size) * t / threads_value);
+        const int end = static_cast<int>(static_cast<int64_t>(size) * (t + 1) / threads_value);
+        std::vector<uint32_t> lines(use_lines ? buckets * kLineKeys : 0);
+        std::vector<int> fill(buckets, 0);
+        // The first digit is counted in the read that loads the keys. Unlike
+        // the sequential sort, the counters of the later digits can not be
+        // filled here too: a pass needs the digits of the keys in the chunk
+        // of each thread, and the scatter before it sends the keys of every
+        // chunk to all buckets, so the chunk is counted again after it. The
+        // totals over all threads would not change, but the per-thread
+        // offsets can not be derived from them
+        int* first_count = &count[t * buckets];
+        for (int i = begin; i < end; ++i) {
+            uint32_t key = static_cast<uint32_t>(arr[i]) ^ flip;
+            keys[i] = key;
+            ++first_count[(key >> passes[0].shift) & passes[0].mask];
+        }
+        uint32_t* src = keys.data();
+        uint32_t* dst = tmp.data();
+
+        for (int p = 0; p < passes_count; ++p) {
+            int* my_count = &count[(p * threads_value + t) * buckets];
+            if (p > 0) {
+                for (int i = begin; i < end; ++i)
+                    ++my_count[(src[i] >> passes[p].shift) & passes[p].mask];
+            }
+#pragma omp barrier
+#pragma omp single
+            {
+                int sum = 0;
+                skip[p] = 0;
+                for (int b = 0; b < buckets; ++b) {
+                    const int bucket_begin = sum;
+                    for (int th = 0; th < threads_value; ++th) {
+                        pos[th * buckets + b] = sum;
+                        sum += count[(p * threads_value + th) * buckets + b];
+                    }
+                    if (sum - bucket_begin == size)
+                        skip[p] = 1;  // the digit is the same for all numbers
+                }
+            }
+            if (!skip[p]) {
+                scatter_by_digit(src, dst, begin, end, passes[p], &pos[t * buckets],
+                                 use_lines ? lines.data() : nullptr, fill.data());
+                std::swap(src, dst);
+#pragma omp barrier
+            }
+        }
+        for (int i = begin; i < end; ++i)
+            arr[i] = static_cast<int>(src[i] ^ flip);
+    }
 }
 
 void duplicate_array(int* a, int* b, int n) {
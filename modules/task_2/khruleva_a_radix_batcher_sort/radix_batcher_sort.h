@@ -19,7 +19,12 @@ void gen_rnd_arr(int* arr, int size, int bits_value);
 void odd_even_simple_merge(int* arr, int size, int* result);
 void compare_exchange(int* a, int* b);
 void odd_even_merger(int* arr, int size);
+// Sorts by the low bits of the numbers (all of them and with the sign
+// when bits is 32) in passes of digit_bits(size) bits
+int digit_bits(int size);
 void least_significant_digit_sort(int* arr, int size, int bits = BITS);
+// The same passes with per-thread counters and scatters
+void parallel_least_significant_digit_sort(int* arr, int size, int threads_value, int bits = BITS);
 void duplicate_array(int* a, int* b, int n);
 void radix_batcher_sort(int* arr, int size, int threads_value);
 
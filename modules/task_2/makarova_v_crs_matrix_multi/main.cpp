@@ -101,6 +101,23 @@ TEST(CRS_Matrix_Multiplication, Transponation) {
     EXPECT_EQ(matrixCRS_tr.ptrs, c_ptrs);
 }
 
+TEST(CRS_Matrix_Multiplication, Transponation_Not_Square_Into_Existing) {
+    Matrix mat = generateRandomMat(37, 23);
+    Matrix mat_tr(23, 37);
+    for (int i = 0; i < 37; ++i)
+        for (int j = 0; j < 23; ++j)
+            mat_tr.val[j * 37 + i] = mat.val[i * 23 + j];
+    MatrixCRS expected = convert(mat_tr);
+
+    MatrixCRS result = convert(mat);
+    transp(convert(mat), &result);
+    EXPECT_EQ(result.rows, 23);
+    EXPECT_EQ(result.cols, 37);
+    EXPECT_EQ(result.val, expected.val);
+    EXPECT_EQ(result.cols_pos, expected.cols_pos);
+    EXPECT_EQ(result.ptrs, expected.ptrs);
+}
+
 TEST(CRS_Matrix_Multiplication, B) {
     Matrix first(3, 3);
     Matrix second(3, 3);
@@ -163,6 +180,50 @@ TEST(CRS_Matrix_Multiplication, C) {
     EXPECT_EQ(res.ptrs, multRes.ptrs);
 }
 
+TEST(CRS_Matrix_Multiplication, Gustavson_Same_As_Dot_Products) {
+    MatrixCRS first = generateRandomCRSMat(30, 30);
+    MatrixCRS second = convert(generateRandomMat(30, 30));
+
+    MatrixCRS res = matrixCRSMult(first, second);
+    MatrixCRS multRes = matrixCRSMultGustavson(first, second);
+
+    EXPECT_EQ(res.val, multRes.val);
+    EXPECT_EQ(res.cols_pos, multRes.cols_pos);
+    EXPECT_EQ(res.ptrs, multRes.ptrs);
+}
+
+TEST(CRS_Matrix_Multiplication, Gustavson_Not_Square) {
+    Matrix fir = generateRandomMat(17, 40);
+    Matrix sec = generateRandomMat(40, 9);
+
+    MatrixCRS res = convert(matrixMult(fir, sec));
+    MatrixCRS multRes = matrixCRSMultGustavson(convert(fir), convert(sec));
+
+    EXPECT_EQ(res.val, multRes.val);
+    EXPECT_EQ(res.cols_pos, multRes.cols_pos);
+    EXPECT_EQ(res.ptrs, multRes.ptrs);
+    EXPECT_ANY_THROW(matrixCRSMultGustavson(convert(sec), convert(sec)));
+}
+
+TEST(CRS_Matrix_Multiplication, Gustavson_Drops_Zero_Sums) {
+    Matrix fir(2, 2);
+    fir.val = {1, 1,
+               0, 2};
+    Matrix sec(2, 2);
+    sec.val = {std::complex<int>(3, 1), 1,
+               std::complex<int>(-3, -1), 1};
+
+    std::vector<std::complex<int>> c_vals = {2, std::complex<int>(-6, -2), 2};
+    std::vector<int> c_cols = {1, 0, 1};
+    std::vector<int> c_ptrs = {1, 2, 4};
+
+    MatrixCRS multRes = matrixCRSMultGustavson(convert(fir), convert(sec));
+
+    EXPECT_EQ(multRes.val, c_vals);
+    EXPECT_EQ(multRes.cols_pos, c_cols);
+    EXPECT_EQ(multRes.ptrs, c_ptrs);
+}
+
 int main(int argc, char** argv) {
     ::testing::InitGoogleTest(&argc, argv);
     return RUN_ALL_TESTS();
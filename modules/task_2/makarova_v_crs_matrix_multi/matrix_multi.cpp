@@ -5,6 +5,8 @@
 #include <stdexcept>
 #include <vector>
 #include <iostream>
+#include <algorithm>
+#include <cstdint>
 #include "../../../modules/task_2/makarova_v_crs_matrix_multi/matrix_multi.h"
 
 Matrix generateRandomMat(int rows, int cols) {
@@ -54,41 +56,67 @@ MatrixCRS convert(const Matrix &inMat) {
 }
 
 MatrixCRS transp(const MatrixCRS &inMat) {
-    // generate out mat
-    Matrix just_mat(inMat.rows, inMat.cols);
-    int t = static_cast<int>(inMat.ptrs.size());
-#pragma omp parallel for
-    for (int i = 1; i < t; ++i) {
-        // i its rows
-        for (int j = inMat.ptrs[i - 1]; j < inMat.ptrs[i]; ++j) {
-            just_mat.val[just_mat.cols * (i - 1) +
-             inMat.cols_pos[j - 1]] = inMat.val[j - 1];
-        }
-    }
-
-    // get tr matCRS from out mat
     MatrixCRS result;
-    result.cols = inMat.cols;
-    result.rows = inMat.rows;
-    int count;
+    transp(inMat, &result);
+    return result;
+}
 
-    count = 1;
-    result.ptrs.emplace_back(1);
-    for (int j = 0; j < just_mat.rows; ++j) {
-        count = 0;
-        for (int i = 0; i < just_mat.cols; ++i) {
-            if (just_mat.val[just_mat.cols * i + j] != 0) {
-                ++count;
-                result.val.emplace_back(just_mat.val[inMat.cols * i + j]);
-                result.cols_pos.emplace_back(i);
+void transp(const MatrixCRS &inMat, MatrixCRS *out) {
+    // per-thread column counts, a prefix sum, then an in-order scatter of
+    // each thread's rows (ptrs are 1-based, cols_pos 0-based)
+    static thread_local std::vector<int> counters;
+    const int rows = inMat.rows;
+    const int cols = inMat.cols;
+    const int threads = std::max(1, std::min(omp_get_max_threads(), rows));
+    const int nonzeros = static_cast<int>(inMat.val.size());
+    out->rows = cols;
+    out->cols = rows;
+    out->val.resize(nonzeros);
+    out->cols_pos.resize(nonzeros);
+    out->ptrs.resize(cols + 1);
+    counters.assign(static_cast<size_t>(threads) * cols, 0);
+    int *count = counters.data();
+
+#pragma omp parallel num_threads(threads)
+    {
+        const int tid = omp_get_thread_num();
+        const int num = omp_get_num_threads();
+        const int first = static_cast<int64_t>(rows) * tid / num;
+        const int last = static_cast<int64_t>(rows) * (tid + 1) / num;
+        int *own = count + static_cast<size_t>(tid) * cols;
+        for (int i = first; i < last; ++i)
+            for (int j = inMat.ptrs[i]; j < inMat.ptrs[i + 1]; ++j)
+                ++own[inMat.cols_pos[j - 1]];
+#pragma omp barrier
+#pragma omp for schedule(static)
+        for (int c = 0; c < cols; ++c) {
+            int total = 0;
+            for (int t = 0; t < num; ++t)
+                total += count[static_cast<size_t>(t) * cols + c];
+            out->ptrs[c + 1] = total;
+        }
+#pragma omp single
+        {
+            out->ptrs[0] = 1;
+            for (int c = 0; c < cols; ++c)
+                out->ptrs[c + 1] += out->ptrs[c];
+        }
+#pragma omp for schedule(static)
+        for (int c = 0; c < cols; ++c) {
+            int pos = out->ptrs[c] - 1;
+            for (int t = 0; t < num; ++t) {
+                int line_count = count[static_cast<size_t>(t) * cols + c];
+                count[static_cast<size_t>(t) * cols + c] = pos;
+                pos += line_count;
             }
         }
-
-        count += result.ptrs.back();
-        result.ptrs.emplace_back(count);
+        for (int i = first; i < last; ++i)
+            for (int j = inMat.ptrs[i]; j < inMat.ptrs[i + 1]; ++j) {
+                int pos = own[inMat.cols_pos[j - 1]]++;
+                out->val[pos] = inMat.val[j - 1];
+                out->cols_pos[pos] = i;
+            }
     }
-
-    return result;
 }
 
 Matrix matrixMult(const Matrix &first, const Matrix &second) {
@@ -121,7 +149,7 @@ MatrixCRS matrixCRSMult(const MatrixCRS &first, const MatrixCRS &second_a) {
 
     MatrixCRS out;
     out.rows = first.rows;
-    out.cols = second.cols;
+    out.cols = second.rows;
 
     int first_it;
     int second_it;
@@ -162,6 +190,93 @@ MatrixCRS matrixCRSMult(const MatrixCRS &first, const MatrixCRS &second_a) {
     return out;
 }
 
+MatrixCRS matrixCRSMultGustavson(const MatrixCRS &first,
+                                 const MatrixCRS &second) {
+    if (first.cols != second.rows)
+        throw std::runtime_error("Matrix dimensions do not match");
+
+    MatrixCRS out;
+    out.rows = first.rows;
+    out.cols = second.cols;
+    out.ptrs.assign(first.rows + 1, 1);
+
+    // symbolic pass: upper bound of nonzeros of every row of out
+    // (ptrs are 1-based, so every position is shifted by one)
+#pragma omp parallel
+    {
+        std::vector<int> marker(second.cols, -1);
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < first.rows; ++i) {
+            int count = 0;
+            for (int a = first.ptrs[i]; a < first.ptrs[i + 1]; ++a) {
+                int k = first.cols_pos[a - 1];
+                for (int b = second.ptrs[k]; b < second.ptrs[k + 1]; ++b) {
+                    if (marker[second.cols_pos[b - 1]] != i) {
+                        marker[second.cols_pos[b - 1]] = i;
+                        ++count;
+                    }
+                }
+            }
+            out.ptrs[i + 1] = count;
+        }
+    }
+    for (int i = 0; i < first.rows; ++i)
+        out.ptrs[i + 1] += out.ptrs[i];
+    out.val.resize(out.ptrs[first.rows] - 1);
+    out.cols_pos.resize(out.ptrs[first.rows] - 1);
+
+    // numeric pass, sums equal to zero are not stored as in matrixCRSMult
+    std::vector<int> row_size(first.rows, 0);
+#pragma omp parallel
+    {
+        std::vector<int> marker(second.cols, -1);
+        std::vector<std::complex<int>> acc(second.cols);
+        std::vector<int> touched;
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < first.rows; ++i) {
+            touched.clear();
+            for (int a = first.ptrs[i]; a < first.ptrs[i + 1]; ++a) {
+                int k = first.cols_pos[a - 1];
+                for (int b = second.ptrs[k]; b < second.ptrs[k + 1]; ++b) {
+                    int j = second.cols_pos[b - 1];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        acc[j] = 0;
+                        touched.push_back(j);
+                    }
+                    acc[j] += first.val[a - 1] * second.val[b - 1];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            int pos = out.ptrs[i] - 1;
+            for (int j : touched) {
+                if (acc[j] != 0) {
+                    out.val[pos] = acc[j];
+                    out.cols_pos[pos++] = j;
+                }
+            }
+            row_size[i] = pos - (out.ptrs[i] - 1);
+        }
+    }
+
+    // close the gaps left by zero sums
+    int count = 0;
+    for (int i = 0; i < first.rows; ++i) {
+        int from = out.ptrs[i] - 1;
+        for (int j = 0; j < row_size[i]; ++j) {
+            out.val[count + j] = out.val[from + j];
+            out.cols_pos[count + j] = out.cols_pos[from + j];
+        }
+        out.ptrs[i] = count + 1;
+        count += row_size[i];
+    }
+    out.ptrs[first.rows] = count + 1;
+    out.val.resize(count);
+    out.cols_pos.resize(count);
+
+    return out;
+}
+
 void print(const MatrixCRS &in) {
     std::cout <<"vals: "<< std::endl;
     for (size_t i = 0; i < in.val.size(); i++)
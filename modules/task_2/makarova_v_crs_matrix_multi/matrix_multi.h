@@ -27,8 +27,14 @@ Matrix generateRandomMat(int rows, int cols);
 
 MatrixCRS convert(const Matrix &inMat);
 MatrixCRS transp(const MatrixCRS &inMat);
+// Writes the transpose into out, reusing the memory it already holds
+void transp(const MatrixCRS &inMat, MatrixCRS *out);
 
 MatrixCRS matrixCRSMult(const MatrixCRS &first, const MatrixCRS &second);
+// Gustavson row-by-row product: needs no transposition of second, every
+// thread accumulates its rows in a dense array with a marker per column
+MatrixCRS matrixCRSMultGustavson(const MatrixCRS &first,
+                                 const MatrixCRS &second);
 Matrix matrixMult(const Matrix &first, const Matrix &second);
 
 void print(const MatrixCRS &in);
@@ -104,3 +104,83 @@ std::vector<int> DijkstraAlg(const Graph& graph, int sourceVertex) {
 
   return dist;
 }
+
+static void relaxRequests(const std::vector<std::vector<int>>& linkedList,
+                          const std::vector<int>& vertices, int delta,
+                          bool light, const std::vector<int>& dist,
+                          std::vector<std::pair<int, int>>* requests) {
+  int numVertex = linkedList.size();
+  int count = vertices.size();
+
+#pragma omp parallel
+  {
+    std::vector<std::pair<int, int>> local;
+
+#pragma omp for schedule(dynamic, 1)
+    for (int i = 0; i < count; ++i) {
+      int u = vertices[i];
+      int distU = dist[u];
+      for (int v = 0; v < numVertex; ++v) {
+        int weight = linkedList[u][v];
+        if (v == u || weight == INT8_MAX || (weight <= delta) != light)
+          continue;
+        if (distU + weight < dist[v])
+          local.push_back(std::make_pair(v, distU + weight));
+      }
+    }
+
+#pragma omp critical
+    requests->insert(requests->end(), local.begin(), local.end());
+  }
+}
+
+std::vector<int> DeltaSteppingAlg(const Graph& graph, int sourceVertex,
+                                  int delta) {
+  if (delta <= 0) throw std::runtime_error("Delta must be > 0");
+  std::vector<std::vector<int>> linkedList = graph.getLinkedList();
+  int numVertex = linkedList.size();
+  if (sourceVertex < 0 || sourceVertex >= numVertex)
+    throw std::runtime_error("Wrong source vertex");
+
+  std::vector<int> dist(numVertex, INT8_MAX);
+  std::vector<std::vector<int>> buckets(INT8_MAX / delta + 1);
+  std::vector<int> bucketMark(numVertex, -1);
+  std::vector<std::pair<int, int>> requests;
+  dist[sourceVertex] = 0;
+  buckets[0].push_back(sourceVertex);
+
+  for (int i = 0; i < static_cast<int>(buckets.size()); ++i) {
+    std::vector<int> settled;
+    while (!buckets[i].empty()) {
+      std::vector<int> frontier;
+      std::vector<int> current;
+      frontier.swap(buckets[i]);
+      for (int v : frontier)
+        if (dist[v] / delta == i) {
+          current.push_back(v);
+          if (bucketMark[v] != i) {
+            bucketMark[v] = i;
+            settled.push_back(v);
+          }
+        }
+
+      requests.clear();
+      relaxRequests(linkedList, current, delta, true, dist, &requests);
+      for (const auto& request : requests)
+        if (request.second < dist[request.first]) {
+          dist[request.first] = request.second;
+          buckets[request.second / delta].push_back(request.first);
+        }
+    }
+
+    requests.clear();
+    relaxRequests(linkedList, settled, delta, false, dist, &requests);
+    for (const auto& request : requests)
+      if (request.second < dist[request.first]) {
+        dist[request.first] = request.second;
+        buckets[request.second / delta].push_back(request.first);
+      }
+  }
+
+  return dist;
+}
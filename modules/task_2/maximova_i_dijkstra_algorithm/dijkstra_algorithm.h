@@ -19,5 +19,8 @@ class Graph {
 };
 
 std::vector<int> DijkstraAlg(const Graph& graph, int sourceVertex);
+// Bucketed (delta-stepping) SSSP, returns the same distances as DijkstraAlg
+std::vector<int> DeltaSteppingAlg(const Graph& graph, int sourceVertex,
+                                  int delta = 25);
 
 #endif  // MODULES_TASK_2_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
@@ -1,5 +1,7 @@
 // Copyright 2020 Maximova Irina
 #include <gtest/gtest.h>
+#include <omp.h>
+#include <iostream>
 #include <vector>
 #include "./dijkstra_algorithm.h"
 
@@ -94,6 +96,64 @@ TEST(Dijkstra_Algorithm_OpenMP, Test_Execute_Dijkstra_Alg_Unlinked_Graph) {
   ASSERT_EQ(algRes, currentRes);
 }
 
+TEST(Dijkstra_Algorithm_OpenMP, Test_Delta_Stepping_Linked_Graph) {
+  int numVertex = 5;
+  int numEdges = 5;
+  int sourceVertex = 1;
+
+  Graph graph(numVertex, numEdges);
+  graph.putEdge(0, 1, 3);
+  graph.putEdge(4, 1, 2);
+  graph.putEdge(4, 2, 1);
+  graph.putEdge(4, 3, 1);
+  graph.putEdge(3, 2, 4);
+  std::vector<int> algRes = DeltaSteppingAlg(graph, sourceVertex, 2);
+  std::vector<int> currentRes = {3, 0, 3, 3, 2};
+
+  ASSERT_EQ(algRes, currentRes);
+}
+
+TEST(Dijkstra_Algorithm_OpenMP, Test_Delta_Stepping_Error_Wrong_Delta) {
+  Graph graph(5, 4);
+
+  ASSERT_ANY_THROW(DeltaSteppingAlg(graph, 0, 0));
+}
+
+TEST(Dijkstra_Algorithm_OpenMP, Test_Delta_Stepping_Equals_Dijkstra) {
+  int numVertex = 150;
+  int numEdges = 600;
+  int sourceVertex = 3;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> dijkstraRes = DijkstraAlg(graph, sourceVertex);
+
+  for (int delta : {1, 7, 25, 100, 200})
+    ASSERT_EQ(dijkstraRes, DeltaSteppingAlg(graph, sourceVertex, delta));
+}
+
+TEST(Dijkstra_Algorithm_OpenMP, DISABLED_Test_Delta_Stepping_Time) {
+  int numVertex = 3000;
+  int numEdges = 24000;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+
+  double start = omp_get_wtime();
+  std::vector<int> dijkstraRes = DijkstraAlg(graph, sourceVertex);
+  double timeDijkstra = omp_get_wtime() - start;
+
+  start = omp_get_wtime();
+  std::vector<int> deltaRes = DeltaSteppingAlg(graph, sourceVertex);
+  double timeDelta = omp_get_wtime() - start;
+
+  std::cout << "Dijkstra: " << timeDijkstra << std::endl
+            << "Delta-stepping: " << timeDelta << std::endl;
+
+  ASSERT_EQ(dijkstraRes, deltaRes);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
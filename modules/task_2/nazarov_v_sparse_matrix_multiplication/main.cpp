@@ -43,6 +43,28 @@ TEST(Sparce_Matrix_Multiplication, Test_Matrix_Transpose) {
     EXPECT_EQ(trans, resMatrix);
 }
 
+TEST(Sparce_Matrix_Multiplication, Test_Random_Matrix_Transpose) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(70, 45, 0.1);
+    std::vector<std::vector<cpx>> dense = rand1.getSparseMatrix();
+    CRS_Matrix trans;
+    // restores the thread count for the following tests even if an assertion fails
+    struct ThreadsGuard {
+        int previous;
+        ~ThreadsGuard() { omp_set_num_threads(previous); }
+    } guard{ omp_get_max_threads() };
+    for (int threads : { 1, 3, 8 }) {
+        omp_set_num_threads(threads);
+        rand1.transpose(&trans);
+        ASSERT_EQ(trans.getRow(), 70u);
+        ASSERT_EQ(trans.getCol(), 45u);
+        std::vector<std::vector<cpx>> denseTrans = trans.getSparseMatrix();
+        for (size_t i = 0; i < 45; ++i)
+            for (size_t j = 0; j < 70; ++j)
+                ASSERT_EQ(dense[i][j], denseTrans[j][i]);
+        EXPECT_EQ(trans.transpose(), rand1);
+    }
+}
+
 TEST(Sparce_Matrix_Multiplication, Test_Matrix_Multiplication) {
     CRS_Matrix matrix1({
         { cpx(0, 9), cpx(0, 0), cpx(0, 0), cpx(3, 9) },
@@ -94,3 +116,219 @@ TEST(Sparce_Matrix_Multiplication, Test_Random_CRS_Multiplication) {
     CRS_Matrix multNaive(naiveMultiplication(matr1, matr2));
     EXPECT_EQ(multCRS, multNaive);
 }
+
+TEST(Sparce_Matrix_Multiplication, Test_Gustavson_Multiplication) {
+    CRS_Matrix matrix1({
+        { cpx(0, 9), cpx(0, 0), cpx(0, 0), cpx(3, 9) },
+        { cpx(10, 3), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+        { cpx(0, 0), cpx(21, 5), cpx(0, 0), cpx(0, 0) },
+        { cpx(0, 0), cpx(0, 0), cpx(33, 2), cpx(0, 0) },
+    });
+    CRS_Matrix matrix2({
+        { cpx(0, 0), cpx(0, 0), cpx(0, 0), cpx(0, 4) },
+        { cpx(4, 5), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+        { cpx(8, 1), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+        { cpx(0, 0), cpx(0, 0), cpx(12, 9), cpx(0, 0) },
+    });
+    EXPECT_EQ(matrix1.gustavsonMultiply(matrix2), matrix1 * matrix2.transpose());
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Gustavson_Drops_Cancelled_Entries) {
+    CRS_Matrix matrix1({
+        { cpx(1, 0), cpx(1, 0) },
+        { cpx(0, 0), cpx(2, 0) },
+    });
+    CRS_Matrix matrix2({
+        { cpx(3, 1), cpx(0, 0), cpx(1, 0) },
+        { cpx(-3, -1), cpx(0, 0), cpx(1, 0) },
+    });
+    CRS_Matrix resMatrix({
+        { cpx(0, 0), cpx(0, 0), cpx(2, 0) },
+        { cpx(-6, -2), cpx(0, 0), cpx(2, 0) },
+    });
+    EXPECT_EQ(matrix1.gustavsonMultiply(matrix2), resMatrix);
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Random_Gustavson_Multiplication) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(50, 37, 0.1);
+    CRS_Matrix rand2 = getRandomCRSMatrix(23, 50, 0.1);
+    EXPECT_EQ(rand1.gustavsonMultiply(rand2), rand1 * rand2.transpose());
+    EXPECT_ANY_THROW(rand2.gustavsonMultiply(rand2));
+}
+
+TEST(Sparce_Matrix_Multiplication, DISABLED_Test_Gustavson_Time) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(2000, 2000, 0.002);
+    CRS_Matrix rand2 = getRandomCRSMatrix(2000, 2000, 0.002);
+    double start = omp_get_wtime();
+    CRS_Matrix mult = rand1.parallelMultiply(rand2.transpose());
+    double end = omp_get_wtime();
+    std::cout << "Dot products: " << end - start << std::endl;
+    start = omp_get_wtime();
+    CRS_Matrix gustavson = rand1.gustavsonMultiply(rand2);
+    end = omp_get_wtime();
+    std::cout << "Gustavson: " << end - start << std::endl;
+    EXPECT_EQ(mult, gustavson);
+}
+
+CRS_Matrix withNewValues(CRS_Matrix mat, const cpx& factor) {
+    std::vector<cpx> val = mat.getVal();
+    for (size_t i = 0; i < val.size(); ++i)
+        val[i] = val[i] * factor + cpx(static_cast<double>(i % 7), 1);
+    return CRS_Matrix(val, mat.getColIndex(), mat.getRowIndex(), mat.getCol(), mat.getRow());
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Plan_Multiplication) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(60, 45, 0.1);
+    CRS_Matrix rand2 = getRandomCRSMatrix(30, 60, 0.1);
+    CRS_MultiplyPlan plan(rand1, rand2, 3);
+    EXPECT_EQ(plan.multiply(rand1, rand2), rand1.gustavsonMultiply(rand2));
+    EXPECT_EQ(plan.getNonZeros(), rand1.gustavsonMultiply(rand2).getVal().size());
+    EXPECT_LE(plan.getChunks(), 3u);
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Plan_Refresh_With_New_Values) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(40, 40, 0.15);
+    CRS_Matrix rand2 = getRandomCRSMatrix(40, 40, 0.15);
+    CRS_MultiplyPlan plan(rand1, rand2);
+    CRS_Matrix res = plan.multiply(rand1, rand2);
+    for (int iter = 1; iter <= 3; ++iter) {
+        CRS_Matrix new1 = withNewValues(rand1, cpx(iter, -iter));
+        CRS_Matrix new2 = withNewValues(rand2, cpx(0.5, iter));
+        plan.multiply(new1, new2, &res);
+        EXPECT_EQ(res, new1.gustavsonMultiply(new2));
+    }
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Plan_Keeps_Cancelled_Entries) {
+    CRS_Matrix matrix1({
+        { cpx(1, 0), cpx(1, 0) },
+        { cpx(0, 0), cpx(2, 0) },
+    });
+    CRS_Matrix matrix2({
+        { cpx(3, 1), cpx(0, 0), cpx(1, 0) },
+        { cpx(-3, -1), cpx(0, 0), cpx(1, 0) },
+    });
+    CRS_MultiplyPlan plan(matrix1, matrix2);
+    CRS_Matrix res = plan.multiply(matrix1, matrix2);
+    EXPECT_EQ(res.getColIndex(), std::vector<size_t>({0, 2, 0, 2}));
+    EXPECT_EQ(res.getSparseMatrix(), matrix1.gustavsonMultiply(matrix2).getSparseMatrix());
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Plan_Wrong_Operands) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(20, 20, 0.2);
+    CRS_Matrix rand2 = getRandomCRSMatrix(20, 20, 0.2);
+    CRS_Matrix rand3 = getRandomCRSMatrix(20, 10, 0.2);
+    EXPECT_ANY_THROW(CRS_MultiplyPlan(rand3, rand3));
+    CRS_MultiplyPlan plan(rand1, rand2);
+    EXPECT_ANY_THROW(plan.multiply(rand3, rand2));
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Plan_Same_NonZeros_Other_Pattern) {
+    std::vector<std::vector<cpx>> diag(20, std::vector<cpx>(20)), antiDiag(20, std::vector<cpx>(20));
+    for (size_t i = 0; i < 20; ++i) {
+        diag[i][i] = cpx(1, 1);
+        antiDiag[i][19 - i] = cpx(1, 1);
+    }
+    // antiDiag has as many nonzeros as diag, in other positions
+    CRS_Matrix lhs(diag), other(antiDiag);
+    CRS_Matrix rhs = getRandomCRSMatrix(20, 20, 0.3);
+    CRS_MultiplyPlan plan(lhs, rhs);
+    CRS_MultiplyPlan rhsPlan(rhs, lhs);
+    CRS_Matrix res;
+    EXPECT_ANY_THROW(plan.multiply(other, rhs, &res));
+    EXPECT_ANY_THROW(rhsPlan.multiply(rhs, other, &res));
+    CRS_SplitMatrix splitRes(lhs);
+    EXPECT_ANY_THROW(plan.multiply(CRS_SplitMatrix(other), CRS_SplitMatrix(rhs), &splitRes));
+    EXPECT_NO_THROW(plan.multiply(lhs, rhs, &res));
+}
+
+TEST(Sparce_Matrix_Multiplication, DISABLED_Test_Plan_Time) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(4000, 4000, 0.002);
+    CRS_Matrix rand2 = getRandomCRSMatrix(4000, 4000, 0.002);
+    double start = omp_get_wtime();
+    for (int iter = 0; iter < 10; ++iter)
+        rand1.gustavsonMultiply(rand2);
+    double end = omp_get_wtime();
+    std::cout << "Gustavson, 10 products: " << end - start << std::endl;
+    start = omp_get_wtime();
+    CRS_MultiplyPlan plan(rand1, rand2);
+    end = omp_get_wtime();
+    std::cout << "Plan: " << end - start << std::endl;
+    CRS_Matrix res;
+    start = omp_get_wtime();
+    for (int iter = 0; iter < 10; ++iter)
+        plan.multiply(rand1, rand2, &res);
+    end = omp_get_wtime();
+    std::cout << "Numeric refresh, 10 products: " << end - start << std::endl;
+    EXPECT_EQ(res, rand1.gustavsonMultiply(rand2));
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Split_Conversion) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(30, 20, 0.2);
+    CRS_SplitMatrix split(rand1);
+    EXPECT_EQ(split.getNonZeros(), rand1.getVal().size());
+    EXPECT_EQ(split.toCRS(), rand1);
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Split_Gustavson_Multiplication) {
+    CRS_Matrix matrix1({
+        { cpx(1, 1), cpx(0, 0), cpx(2, -1) },
+        { cpx(0, 0), cpx(0, 3), cpx(0, 0) }
+    });
+    CRS_Matrix matrix2({
+        { cpx(1, 0), cpx(0, 0) },
+        { cpx(0, 0), cpx(2, 2) },
+        { cpx(-1, 1), cpx(0, 0) }
+    });
+    CRS_Matrix res = CRS_SplitMatrix(matrix1).gustavsonMultiply(CRS_SplitMatrix(matrix2)).toCRS();
+    EXPECT_EQ(res, matrix1.gustavsonMultiply(matrix2));
+
+    CRS_Matrix rand1 = getRandomCRSMatrix(60, 40, 0.1);
+    CRS_Matrix rand2 = getRandomCRSMatrix(50, 60, 0.1);
+    EXPECT_EQ(CRS_SplitMatrix(rand1).gustavsonMultiply(CRS_SplitMatrix(rand2)).toCRS(),
+        rand1.gustavsonMultiply(rand2));
+    EXPECT_ANY_THROW(CRS_SplitMatrix(rand2).gustavsonMultiply(CRS_SplitMatrix(rand2)));
+}
+
+TEST(Sparce_Matrix_Multiplication, Test_Split_Plan_Multiplication) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(40, 30, 0.15);
+    CRS_Matrix rand2 = getRandomCRSMatrix(35, 40, 0.15);
+    CRS_MultiplyPlan plan(rand1, rand2);
+    CRS_SplitMatrix res(rand1);
+    plan.multiply(CRS_SplitMatrix(rand1), CRS_SplitMatrix(rand2), &res);
+    EXPECT_EQ(res.toCRS(), plan.multiply(rand1, rand2));
+    EXPECT_ANY_THROW(plan.multiply(CRS_SplitMatrix(rand2), CRS_SplitMatrix(rand1), &res));
+}
+
+TEST(Sparce_Matrix_Multiplication, DISABLED_Test_Split_Gustavson_Time) {
+    CRS_Matrix rand1 = getRandomCRSMatrix(2000, 2000, 0.02);
+    CRS_Matrix rand2 = getRandomCRSMatrix(2000, 2000, 0.02);
+    double start = omp_get_wtime();
+    CRS_Matrix res = rand1.gustavsonMultiply(rand2);
+    double end = omp_get_wtime();
+    std::cout << "Gustavson, interleaved: " << end - start << std::endl;
+    start = omp_get_wtime();
+    CRS_SplitMatrix split1(rand1), split2(rand2);
+    end = omp_get_wtime();
+    std::cout << "Conversion to split: " << end - start << std::endl;
+    start = omp_get_wtime();
+    CRS_SplitMatrix splitRes = split1.gustavsonMultiply(split2);
+    end = omp_get_wtime();
+    std::cout << "Gustavson, split: " << end - start << std::endl;
+    EXPECT_EQ(splitRes.toCRS(), res);
+
+    CRS_MultiplyPlan plan(rand1, rand2);
+    CRS_Matrix planRes;
+    start = omp_get_wtime();
+    for (int iter = 0; iter < 10; ++iter)
+        plan.multiply(rand1, rand2, &planRes);
+    end = omp_get_wtime();
+    std::cout << "Numeric refresh, interleaved, 10 products: " << end - start << std::endl;
+    CRS_SplitMatrix splitPlanRes(rand1);
+    start = omp_get_wtime();
+    for (int iter = 0; iter < 10; ++iter)
+        plan.multiply(split1, split2, &splitPlanRes);
+    end = omp_get_wtime();
+    std::cout << "Numeric refresh, split, 10 products: " << end - start << std::endl;
+    EXPECT_EQ(splitPlanRes.toCRS(), planRes);
+}
@@ -1,6 +1,7 @@
 // Copyright 2020 Nazarov Vladislav
 
 #include <omp.h>
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 #include <random>
@@ -118,30 +119,326 @@ CRS_Matrix CRS_Matrix::parallelMultiply(const CRS_Matrix& mat) const& {
     return res;
 }
 
-CRS_Matrix CRS_Matrix::transpose() {
-    std::vector<std::vector<size_t>> index(col);
-    std::vector<std::vector<cpx>> values(col);
-    for (size_t i = 1; i < rowIndex.size(); ++i)
-        for (size_t j = rowIndex[i-1]; j < rowIndex[i]; ++j) {
-            index[colIndex[j]].push_back(i-1);
-            values[colIndex[j]].push_back(val[j]);
-        }
+CRS_Matrix CRS_Matrix::gustavsonMultiply(const CRS_Matrix& mat) const& {
+    if (col != mat.row)
+        throw std::runtime_error("Different numbers of cols");
+    const int rows = static_cast<int>(row);
     CRS_Matrix res;
-    res.col = row;
-    res.row = col;
-    size_t size = 0;
-    res.rowIndex.push_back(0);
-    for (size_t i = 0; i < col; ++i) {
-        for (size_t j = 0; j < index[i].size(); ++j) {
-            res.val.push_back(values[i][j]);
-            res.colIndex.push_back(index[i][j]);
+    res.row = row;
+    res.col = mat.col;
+    res.rowIndex.assign(row + 1, 0);
+
+    // Symbolic pass: number of structural nonzeros in every row of the result
+#pragma omp parallel
+    {
+        std::vector<int> marker(mat.col, -1);
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            size_t count = 0;
+            for (size_t lhs = rowIndex[i]; lhs < rowIndex[i+1]; ++lhs) {
+                size_t k = colIndex[lhs];
+                for (size_t rhs = mat.rowIndex[k]; rhs < mat.rowIndex[k+1]; ++rhs)
+                    if (marker[mat.colIndex[rhs]] != i) {
+                        marker[mat.colIndex[rhs]] = i;
+                        count++;
+                    }
+            }
+            res.rowIndex[i+1] = count;
+        }
+    }
+    for (size_t i = 0; i < row; ++i)
+        res.rowIndex[i+1] += res.rowIndex[i];
+    res.val.resize(res.rowIndex[row]);
+    res.colIndex.resize(res.rowIndex[row]);
+
+    // Numeric pass: dense accumulator plus the list of touched columns,
+    // entries that cancel out are dropped like in operator*
+    std::vector<size_t> rowSize(row, 0);
+#pragma omp parallel
+    {
+        std::vector<int> marker(mat.col, -1);
+        std::vector<cpx> acc(mat.col);
+        std::vector<size_t> touched;
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            touched.clear();
+            for (size_t lhs = rowIndex[i]; lhs < rowIndex[i+1]; ++lhs) {
+                size_t k = colIndex[lhs];
+                for (size_t rhs = mat.rowIndex[k]; rhs < mat.rowIndex[k+1]; ++rhs) {
+                    size_t j = mat.colIndex[rhs];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        acc[j] = 0;
+                        touched.push_back(j);
+                    }
+                    acc[j] += val[lhs] * mat.val[rhs];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            size_t pos = res.rowIndex[i];
+            for (size_t j : touched)
+                if (std::abs(acc[j].real()) > pow(10, -9) || std::abs(acc[j].imag()) > pow(10, -9)) {
+                    res.colIndex[pos] = j;
+                    res.val[pos++] = acc[j];
+                }
+            rowSize[i] = pos - res.rowIndex[i];
+        }
+    }
+
+    // Close the gaps left by cancelled entries
+    size_t NonZeroCounter = 0;
+    for (size_t i = 0; i < row; ++i) {
+        size_t from = res.rowIndex[i];
+        for (size_t j = 0; j < rowSize[i]; ++j) {
+            res.colIndex[NonZeroCounter + j] = res.colIndex[from + j];
+            res.val[NonZeroCounter + j] = res.val[from + j];
+        }
+        res.rowIndex[i] = NonZeroCounter;
+        NonZeroCounter += rowSize[i];
+    }
+    res.rowIndex[row] = NonZeroCounter;
+    res.val.resize(NonZeroCounter);
+    res.colIndex.resize(NonZeroCounter);
+    return res;
+}
+
+CRS_MultiplyPlan::CRS_MultiplyPlan(const CRS_Matrix& lhs, const CRS_Matrix& rhs, int chunks) {
+    if (lhs.col != rhs.row)
+        throw std::runtime_error("Different numbers of cols");
+    if (chunks < 0)
+        throw std::runtime_error("Wrong number of chunks");
+    row = lhs.row;
+    col = rhs.col;
+    lhsRowIndex = lhs.rowIndex;
+    lhsColIndex = lhs.colIndex;
+    rhsRowIndex = rhs.rowIndex;
+    rhsColIndex = rhs.colIndex;
+    const int rows = static_cast<int>(row);
+    rowIndex.assign(row + 1, 0);
+    termIndex.assign(row + 1, 0);
+
+    // Symbolic pass: structural nonzeros and partial products of every row
+#pragma omp parallel
+    {
+        std::vector<int> marker(col, -1);
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            size_t count = 0, terms = 0;
+            for (size_t l = lhs.rowIndex[i]; l < lhs.rowIndex[i+1]; ++l) {
+                size_t k = lhs.colIndex[l];
+                terms += rhs.rowIndex[k+1] - rhs.rowIndex[k];
+                for (size_t r = rhs.rowIndex[k]; r < rhs.rowIndex[k+1]; ++r)
+                    if (marker[rhs.colIndex[r]] != i) {
+                        marker[rhs.colIndex[r]] = i;
+                        count++;
+                    }
+            }
+            rowIndex[i+1] = count;
+            termIndex[i+1] = terms;
+        }
+    }
+    for (size_t i = 0; i < row; ++i) {
+        rowIndex[i+1] += rowIndex[i];
+        termIndex[i+1] += termIndex[i];
+    }
+    colIndex.resize(rowIndex[row]);
+    termPos.resize(termIndex[row]);
+
+    // Pattern of every row, sorted by column, and where each partial product goes
+#pragma omp parallel
+    {
+        std::vector<int> marker(col, -1);
+        std::vector<size_t> pos(col);
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            size_t* rowCols = colIndex.data() + rowIndex[i];
+            size_t count = 0;
+            for (size_t l = lhs.rowIndex[i]; l < lhs.rowIndex[i+1]; ++l) {
+                size_t k = lhs.colIndex[l];
+                for (size_t r = rhs.rowIndex[k]; r < rhs.rowIndex[k+1]; ++r)
+                    if (marker[rhs.colIndex[r]] != i) {
+                        marker[rhs.colIndex[r]] = i;
+                        rowCols[count++] = rhs.colIndex[r];
+                    }
+            }
+            std::sort(rowCols, rowCols + count);
+            for (size_t j = 0; j < count; ++j)
+                pos[rowCols[j]] = rowIndex[i] + j;
+            size_t term = termIndex[i];
+            for (size_t l = lhs.rowIndex[i]; l < lhs.rowIndex[i+1]; ++l) {
+                size_t k = lhs.colIndex[l];
+                for (size_t r = rhs.rowIndex[k]; r < rhs.rowIndex[k+1]; ++r)
+                    termPos[term++] = pos[rhs.colIndex[r]];
+            }
+        }
+    }
+
+    // Contiguous chunks of rows with about the same number of partial
+    // products; a row is charged one extra unit for clearing its entries
+    if (chunks == 0)
+        chunks = 4 * omp_get_max_threads();
+    chunks = static_cast<int>(std::max<size_t>(1, std::min<size_t>(chunks, row)));
+    const size_t total = termIndex[row] + rowIndex[row];
+    chunkRows.assign(1, 0);
+    size_t i = 0;
+    for (int c = 1; c < chunks; ++c) {
+        const size_t target = total * c / chunks;
+        while (i < row && termIndex[i] + rowIndex[i] < target)
+            ++i;
+        if (i > chunkRows.back())
+            chunkRows.push_back(i);
+    }
+    chunkRows.push_back(row);
+}
+
+void CRS_MultiplyPlan::checkOperands(size_t lhsCol, const std::vector<size_t>& lhsRows,
+    const std::vector<size_t>& lhsCols, size_t rhsRow, size_t rhsCol, const std::vector<size_t>& rhsRows,
+    const std::vector<size_t>& rhsCols) const {
+    // Equal sizes are not enough: another pattern with the same number of
+    // nonzeros would send the partial products to wrong termPos entries
+    if (lhsCol != rhsRow || rhsCol != col || lhsRows != lhsRowIndex || lhsCols != lhsColIndex ||
+        rhsRows != rhsRowIndex || rhsCols != rhsColIndex)
+        throw std::runtime_error("Operands do not match the plan");
+}
+
+void CRS_MultiplyPlan::multiply(const CRS_Matrix& lhs, const CRS_Matrix& rhs, CRS_Matrix* res) const {
+    checkOperands(lhs.col, lhs.rowIndex, lhs.colIndex, rhs.row, rhs.col, rhs.rowIndex, rhs.colIndex);
+    if (lhs.val.size() != lhsColIndex.size() || rhs.val.size() != rhsColIndex.size())
+        throw std::runtime_error("Operands do not match the plan");
+    if (res->rowIndex != rowIndex || res->colIndex != colIndex) {
+        res->row = row;
+        res->col = col;
+        res->rowIndex = rowIndex;
+        res->colIndex = colIndex;
+        res->val.assign(colIndex.size(), 0);
+    }
+
+    // Numeric pass only, rows of a chunk write to their own part of res->val
+    const int numChunks = static_cast<int>(chunkRows.size()) - 1;
+    cpx* out = res->val.data();
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < numChunks; ++c) {
+        for (size_t i = chunkRows[c]; i < chunkRows[c+1]; ++i) {
+            std::fill(out + rowIndex[i], out + rowIndex[i+1], cpx(0, 0));
+            size_t term = termIndex[i];
+            for (size_t l = lhs.rowIndex[i]; l < lhs.rowIndex[i+1]; ++l) {
+                const cpx a = lhs.val[l];
+                size_t k = lhs.colIndex[l];
+                for (size_t r = rhs.rowIndex[k]; r < rhs.rowIndex[k+1]; ++r)
+                    out[termPos[term++]] += a * rhs.val[r];
+            }
+        }
+    }
+}
+
+void CRS_MultiplyPlan::multiply(const CRS_SplitMatrix& lhs, const CRS_SplitMatrix& rhs,
+    CRS_SplitMatrix* res) const {
+    checkOperands(lhs.col, lhs.rowIndex, lhs.colIndex, rhs.row, rhs.col, rhs.rowIndex, rhs.colIndex);
+    if (res->rowIndex != rowIndex || res->colIndex != colIndex) {
+        res->row = row;
+        res->col = col;
+        res->rowIndex = rowIndex;
+        res->colIndex = colIndex;
+        res->re.assign(colIndex.size(), 0);
+        res->im.assign(colIndex.size(), 0);
+    }
+
+    // Same numeric pass on split arrays; the products of one lhs element
+    // land on distinct positions, so the inner loop is a clean SIMD scatter
+    const int numChunks = static_cast<int>(chunkRows.size()) - 1;
+    double* outRe = res->re.data();
+    double* outIm = res->im.data();
+    const double* bRe = rhs.re.data();
+    const double* bIm = rhs.im.data();
+    const size_t* pos = termPos.data();
+#pragma omp parallel for schedule(dynamic, 1)
+    for (int c = 0; c < numChunks; ++c) {
+        for (size_t i = chunkRows[c]; i < chunkRows[c+1]; ++i) {
+            std::fill(outRe + rowIndex[i], outRe + rowIndex[i+1], 0.0);
+            std::fill(outIm + rowIndex[i], outIm + rowIndex[i+1], 0.0);
+            size_t term = termIndex[i];
+            for (size_t l = lhs.rowIndex[i]; l < lhs.rowIndex[i+1]; ++l) {
+                const double aRe = lhs.re[l], aIm = lhs.im[l];
+                const size_t k = lhs.colIndex[l];
+                const size_t first = rhs.rowIndex[k], last = rhs.rowIndex[k+1];
+                const size_t* p = pos + term - first;
+#pragma omp simd
+                for (size_t r = first; r < last; ++r) {
+                    outRe[p[r]] += aRe * bRe[r] - aIm * bIm[r];
+                    outIm[p[r]] += aRe * bIm[r] + aIm * bRe[r];
+                }
+                term += last - first;
+            }
         }
-        size += index[i].size();
-        res.rowIndex.push_back(size);
     }
+}
+
+CRS_Matrix CRS_MultiplyPlan::multiply(const CRS_Matrix& lhs, const CRS_Matrix& rhs) const {
+    CRS_Matrix res;
+    multiply(lhs, rhs, &res);
+    return res;
+}
+
+CRS_Matrix CRS_Matrix::transpose() {
+    CRS_Matrix res;
+    transpose(&res);
     return res;
 }
 
+void CRS_Matrix::transpose(CRS_Matrix* res) const {
+    // Per-thread column counts, a prefix sum, then an in-order scatter of each thread's rows
+    static thread_local std::vector<size_t> counters;
+    const size_t maxThreads = omp_get_max_threads();
+    res->row = col;
+    res->col = row;
+    res->rowIndex.resize(col + 1);
+    res->colIndex.resize(val.size());
+    res->val.resize(val.size());
+    counters.assign(maxThreads * col, 0);
+    size_t* counts = counters.data();
+    const int cols = static_cast<int>(col);
+
+#pragma omp parallel num_threads(static_cast<int>(maxThreads))
+    {
+        const size_t tid = omp_get_thread_num();
+        const size_t numThreads = omp_get_num_threads();
+        const size_t first = row * tid / numThreads, last = row * (tid + 1) / numThreads;
+        size_t* own = counts + tid * col;
+        for (size_t i = first; i < last; ++i)
+            for (size_t j = rowIndex[i]; j < rowIndex[i+1]; ++j)
+                own[colIndex[j]]++;
+#pragma omp barrier
+#pragma omp for schedule(static)
+        for (int c = 0; c < cols; ++c) {
+            size_t total = 0;
+            for (size_t t = 0; t < numThreads; ++t)
+                total += counts[t * col + c];
+            res->rowIndex[c+1] = total;
+        }
+#pragma omp single
+        {
+            res->rowIndex[0] = 0;
+            for (size_t c = 0; c < col; ++c)
+                res->rowIndex[c+1] += res->rowIndex[c];
+        }
+#pragma omp for schedule(static)
+        for (int c = 0; c < cols; ++c) {
+            size_t pos = res->rowIndex[c];
+            for (size_t t = 0; t < numThreads; ++t) {
+                size_t count = counts[t * col + c];
+                counts[t * col + c] = pos;
+                pos += count;
+            }
+        }
+        for (size_t i = first; i < last; ++i)
+            for (size_t j = rowIndex[i]; j < rowIndex[i+1]; ++j) {
+                size_t pos = own[colIndex[j]]++;
+                res->colIndex[pos] = i;
+                res->val[pos] = val[j];
+            }
+    }
+}
+
 void CRS_Matrix::print() {
     std::cout << "Value = [ ";
     for (const auto& elem : val)
@@ -188,6 +485,110 @@ std::vector<std::vector<cpx>> naiveMultiplication(const std::vector<std::vector<
     return res;
 }
 
+CRS_SplitMatrix::CRS_SplitMatrix(const CRS_Matrix& mat) : re(mat.val.size()), im(mat.val.size()),
+    colIndex(mat.colIndex), rowIndex(mat.rowIndex), row(mat.row), col(mat.col) {
+    for (size_t i = 0; i < mat.val.size(); ++i) {
+        re[i] = mat.val[i].real();
+        im[i] = mat.val[i].imag();
+    }
+}
+
+CRS_Matrix CRS_SplitMatrix::toCRS() const {
+    std::vector<cpx> val(re.size());
+    for (size_t i = 0; i < re.size(); ++i)
+        val[i] = cpx(re[i], im[i]);
+    return CRS_Matrix(val, colIndex, rowIndex, col, row);
+}
+
+CRS_SplitMatrix CRS_SplitMatrix::gustavsonMultiply(const CRS_SplitMatrix& mat) const {
+    if (col != mat.row)
+        throw std::runtime_error("Different numbers of cols");
+    const int rows = static_cast<int>(row);
+    CRS_SplitMatrix res(CRS_Matrix(0, 0, row + 1, mat.col, row));
+
+    // Symbolic pass, as in CRS_Matrix::gustavsonMultiply
+#pragma omp parallel
+    {
+        std::vector<int> marker(mat.col, -1);
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            size_t count = 0;
+            for (size_t lhs = rowIndex[i]; lhs < rowIndex[i+1]; ++lhs) {
+                size_t k = colIndex[lhs];
+                for (size_t rhs = mat.rowIndex[k]; rhs < mat.rowIndex[k+1]; ++rhs)
+                    if (marker[mat.colIndex[rhs]] != i) {
+                        marker[mat.colIndex[rhs]] = i;
+                        count++;
+                    }
+            }
+            res.rowIndex[i+1] = count;
+        }
+    }
+    for (size_t i = 0; i < row; ++i)
+        res.rowIndex[i+1] += res.rowIndex[i];
+    res.re.resize(res.rowIndex[row]);
+    res.im.resize(res.rowIndex[row]);
+    res.colIndex.resize(res.rowIndex[row]);
+
+    // Numeric pass: the accumulators stay zero between rows (every emitted
+    // column is cleared), so the multiply-add needs no reset branch and is
+    // four double operations instead of a NaN-checked complex product
+    std::vector<size_t> rowSize(row, 0);
+#pragma omp parallel
+    {
+        std::vector<int> marker(mat.col, -1);
+        std::vector<double> accRe(mat.col, 0.0), accIm(mat.col, 0.0);
+        std::vector<size_t> touched;
+#pragma omp for schedule(dynamic, 64)
+        for (int i = 0; i < rows; ++i) {
+            touched.clear();
+            for (size_t lhs = rowIndex[i]; lhs < rowIndex[i+1]; ++lhs) {
+                const double aRe = re[lhs], aIm = im[lhs];
+                const size_t k = colIndex[lhs];
+                for (size_t rhs = mat.rowIndex[k]; rhs < mat.rowIndex[k+1]; ++rhs) {
+                    const size_t j = mat.colIndex[rhs];
+                    if (marker[j] != i) {
+                        marker[j] = i;
+                        touched.push_back(j);
+                    }
+                    accRe[j] += aRe * mat.re[rhs] - aIm * mat.im[rhs];
+                    accIm[j] += aRe * mat.im[rhs] + aIm * mat.re[rhs];
+                }
+            }
+            std::sort(touched.begin(), touched.end());
+            size_t pos = res.rowIndex[i];
+            for (size_t j : touched) {
+                if (std::abs(accRe[j]) > pow(10, -9) || std::abs(accIm[j]) > pow(10, -9)) {
+                    res.colIndex[pos] = j;
+                    res.re[pos] = accRe[j];
+                    res.im[pos++] = accIm[j];
+                }
+                accRe[j] = 0;
+                accIm[j] = 0;
+            }
+            rowSize[i] = pos - res.rowIndex[i];
+        }
+    }
+
+    // Close the gaps left by cancelled entries
+    size_t NonZeroCounter = 0;
+    for (size_t i = 0; i < row; ++i) {
+        size_t from = res.rowIndex[i];
+        for (size_t j = 0; j < rowSize[i]; ++j) {
+            res.colIndex[NonZeroCounter + j] = res.colIndex[from + j];
+            res.re[NonZeroCounter + j] = res.re[from + j];
+            res.im[NonZeroCounter + j] = res.im[from + j];
+        }
+        res.rowIndex[i] = NonZeroCounter;
+        NonZeroCounter += rowSize[i];
+    }
+    res.rowIndex[row] = NonZeroCounter;
+    res.re.resize(NonZeroCounter);
+    res.im.resize(NonZeroCounter);
+    res.colIndex.resize(NonZeroCounter);
+    return res;
+}
+
 CRS_Matrix getRandomCRSMatrix(const size_t& col, const size_t& row, const double& percent) {
     if ((percent > 1) || (percent < 0))
         throw std::runtime_error("Invalid parameters");
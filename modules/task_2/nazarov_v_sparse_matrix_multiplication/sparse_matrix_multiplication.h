@@ -9,6 +9,9 @@
 
 using cpx = std::complex<double>;
 
+class CRS_MultiplyPlan;
+class CRS_SplitMatrix;
+
 class CRS_Matrix {
     std::vector<cpx> val;
     std::vector<size_t> colIndex;
@@ -25,7 +28,13 @@ class CRS_Matrix {
     bool operator== (const CRS_Matrix& mat) const&;
     CRS_Matrix operator* (const CRS_Matrix& mat) const&;
     CRS_Matrix parallelMultiply(const CRS_Matrix& mat) const&;
+    // Row-wise Gustavson product this * mat; unlike operator* the right
+    // operand is NOT transposed. A symbolic pass sizes the result exactly,
+    // then every thread accumulates rows in its own dense accumulator.
+    CRS_Matrix gustavsonMultiply(const CRS_Matrix& mat) const&;
     CRS_Matrix transpose();
+    // Parallel transpose into res, reusing the memory res already holds
+    void transpose(CRS_Matrix* res) const;
     std::vector<cpx> getVal() {return val;}
     std::vector<size_t> getColIndex() {return colIndex;}
     std::vector<size_t> getRowIndex() {return rowIndex;}
@@ -33,6 +42,58 @@ class CRS_Matrix {
     size_t getCol() { return col; }
     std::vector<std::vector<cpx>> getSparseMatrix();
     void print();
+    friend class CRS_MultiplyPlan;
+    friend class CRS_SplitMatrix;
+};
+
+// The same matrix with real and imaginary parts in separate arrays, so the
+// complex multiply-add is four double operations instead of the NaN-checked
+// std::complex product. Converts to and from CRS_Matrix. The products are
+// scatters into the result, which only vectorize with gather/scatter
+// instructions: without -march both layouts run at the same speed.
+class CRS_SplitMatrix {
+    std::vector<double> re;
+    std::vector<double> im;
+    std::vector<size_t> colIndex;
+    std::vector<size_t> rowIndex;
+    size_t row, col;
+ public:
+    explicit CRS_SplitMatrix(const CRS_Matrix& mat);
+    CRS_Matrix toCRS() const;
+    // Same product and zero dropping as CRS_Matrix::gustavsonMultiply
+    CRS_SplitMatrix gustavsonMultiply(const CRS_SplitMatrix& mat) const;
+    size_t getNonZeros() const { return colIndex.size(); }
+    friend class CRS_MultiplyPlan;
+};
+
+// Cached structure of the product lhs * rhs (rhs is NOT transposed, as in
+// gustavsonMultiply) for operands whose sparsity pattern stays fixed while
+// their values change. The constructor does the symbolic work once: the
+// pattern of the result, the result position of every partial product and
+// the cost of every row. multiply() then only does the arithmetic, spread
+// over chunks of rows of about equal cost. Entries that cancel are kept as
+// explicit zeros, so the result pattern is the same on every refresh.
+class CRS_MultiplyPlan {
+    size_t row, col;
+    // Patterns of the operands the plan was made for; termPos is only
+    // valid for exactly these, so multiply() compares them first
+    std::vector<size_t> lhsRowIndex, lhsColIndex;
+    std::vector<size_t> rhsRowIndex, rhsColIndex;
+    std::vector<size_t> rowIndex;
+    std::vector<size_t> colIndex;
+    std::vector<size_t> termIndex;  // first partial product of every row
+    std::vector<size_t> termPos;    // result position of every partial product
+    std::vector<size_t> chunkRows;  // row bounds of the chunks
+    void checkOperands(size_t lhsCol, const std::vector<size_t>& lhsRows, const std::vector<size_t>& lhsCols,
+        size_t rhsRow, size_t rhsCol, const std::vector<size_t>& rhsRows, const std::vector<size_t>& rhsCols) const;
+ public:
+    CRS_MultiplyPlan(const CRS_Matrix& lhs, const CRS_Matrix& rhs, int chunks = 0);
+    CRS_Matrix multiply(const CRS_Matrix& lhs, const CRS_Matrix& rhs) const;
+    void multiply(const CRS_Matrix& lhs, const CRS_Matrix& rhs, CRS_Matrix* res) const;
+    void multiply(const CRS_SplitMatrix& lhs, const CRS_SplitMatrix& rhs, CRS_SplitMatrix* res) const;
+    size_t getNonZeros() const { return colIndex.size(); }
+    size_t getTerms() const { return termPos.size(); }
+    size_t getChunks() const { return chunkRows.size() - 1; }
 };
 
 CRS_Matrix getRandomCRSMatrix(const size_t& col, const size_t& row, const double& percent);
@@ -7,6 +7,7 @@
 #include <algorithm>
 #include <utility>
 #include <iostream>
+#include <functional>
 #include "../../../modules/task_2/sadikov_a_deikstra_algorithm/deikstra_algorithm.h"
 
 
@@ -93,3 +94,105 @@ std::vector<int> getMinRange(const std::vector<int>& graph, int start, int end)
 
     return way;
 }
+
+DeikstraScratch::DeikstraScratch(int points_count)
+    : points_len(points_count, std::numeric_limits<int>::max()),
+      prev(points_count, -1),
+      visited(points_count, false) {}
+
+void DeikstraScratch::reset() {
+    for (int i : touched) {
+        points_len[i] = std::numeric_limits<int>::max();
+        prev[i] = -1;
+        visited[i] = false;
+    }
+    touched.clear();
+    heap.clear();
+}
+
+static void runDeikstra(const std::vector<int>& graph, int points_count,
+                        int start, int end, DeikstraScratch* scratch) {
+    std::vector<int>& points_len = scratch->points_len;
+    std::vector<std::pair<int, int>>& heap = scratch->heap;
+    std::greater<std::pair<int, int>> heap_cmp;
+
+    points_len[start] = 0;
+    scratch->touched.push_back(start);
+    heap.push_back(std::make_pair(0, start));
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), heap_cmp);
+        int min_len = heap.back().first;
+        int min_point = heap.back().second;
+        heap.pop_back();
+        if (scratch->visited[min_point])
+            continue;
+        scratch->visited[min_point] = true;
+        if (min_point == end)
+            return;
+
+        const int* row = &graph[min_point * points_count];
+        for (int i = 0; i < points_count; i++) {
+            if (row[i] > 0 && !scratch->visited[i] && min_len + row[i] < points_len[i]) {
+                if (points_len[i] == std::numeric_limits<int>::max())
+                    scratch->touched.push_back(i);
+                points_len[i] = min_len + row[i];
+                scratch->prev[i] = min_point;
+                heap.push_back(std::make_pair(points_len[i], i));
+                std::push_heap(heap.begin(), heap.end(), heap_cmp);
+            }
+        }
+    }
+}
+
+std::vector<std::vector<int>> getMinRanges(const std::vector<int>& graph,
+                                           const std::vector<std::pair<int, int>>& queries) {
+    int points_count = sqrt(graph.size());
+    int queries_count = queries.size();
+    std::vector<std::vector<int>> ways(queries_count);
+
+    #pragma omp parallel
+    {
+        DeikstraScratch scratch(points_count);
+
+        #pragma omp for schedule(dynamic)
+        for (int q = 0; q < queries_count; q++) {
+            int start = std::min(queries[q].first, queries[q].second) - 1;
+            int end = std::max(queries[q].first, queries[q].second) - 1;
+            if (start == end) {
+                ways[q] = std::vector<int>(1, 0);
+                continue;
+            }
+
+            runDeikstra(graph, points_count, start, end, &scratch);
+            if (scratch.visited[end]) {
+                for (int point = end; point != -1; point = scratch.prev[point])
+                    ways[q].push_back(point + 1);
+            }
+            scratch.reset();
+        }
+    }
+
+    return ways;
+}
+
+std::vector<std::vector<int>> getMinRangesFrom(const std::vector<int>& graph,
+                                               const std::vector<int>& sources) {
+    int points_count = sqrt(graph.size());
+    int sources_count = sources.size();
+    std::vector<std::vector<int>> ranges(sources_count);
+
+    #pragma omp parallel
+    {
+        DeikstraScratch scratch(points_count);
+
+        #pragma omp for schedule(dynamic)
+        for (int q = 0; q < sources_count; q++) {
+            runDeikstra(graph, points_count, sources[q] - 1, -1, &scratch);
+            ranges[q] = scratch.points_len;
+            scratch.reset();
+        }
+    }
+
+    return ranges;
+}
@@ -3,8 +3,31 @@
 #ifndef MODULES_TASK_2_SADIKOV_A_DEIKSTRA_ALGORITHM_DEIKSTRA_ALGORITHM_H_
 #define MODULES_TASK_2_SADIKOV_A_DEIKSTRA_ALGORITHM_DEIKSTRA_ALGORITHM_H_
 #include <limits>
+#include <utility>
 #include <vector>
 
+// Per-thread buffers reused between the queries of one batch
+struct DeikstraScratch {
+    std::vector<int> points_len;
+    std::vector<int> prev;
+    std::vector<bool> visited;
+    std::vector<int> touched;
+    std::vector<std::pair<int, int>> heap;
+
+    explicit DeikstraScratch(int points_count);
+    void reset();
+};
+
 std::vector<int> getMinRange(const std::vector<int>& graph, int start, int end);
 
+// Runs getMinRange for every (start, end) pair in parallel over the queries.
+// A search stops as soon as its end point is settled, an unreachable end
+// point gives an empty way.
+std::vector<std::vector<int>> getMinRanges(const std::vector<int>& graph,
+                                           const std::vector<std::pair<int, int>>& queries);
+
+// Distances from every source point (1-based) to all points, INT_MAX if unreachable
+std::vector<std::vector<int>> getMinRangesFrom(const std::vector<int>& graph,
+                                               const std::vector<int>& sources);
+
 #endif  // MODULES_TASK_2_SADIKOV_A_DEIKSTRA_ALGORITHM_DEIKSTRA_ALGORITHM_H_
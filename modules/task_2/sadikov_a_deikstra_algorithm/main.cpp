@@ -1,5 +1,10 @@
 // Copyright 2020 Sadikov Artem
 #include <gtest/gtest.h>
+#include <omp.h>
+#include <algorithm>
+#include <iostream>
+#include <random>
+#include <utility>
 #include <vector>
 #include "./deikstra_algorithm.h"
 
@@ -58,7 +63,88 @@ TEST(Deikstra_Algorithm_Seq, Test_On_Six_Points_Graph_Another_Way) {
     EXPECT_EQ(getMinRange(g, 2, 6), res);
 }
 
+TEST(Deikstra_Algorithm_Seq, Test_Batch_Equals_Single_Queries) {
+    std::vector<int> g = {0, 7, 9, 0, 0, 14,
+                          7, 0, 10, 15, 0, 0,
+                          9, 10, 0, 11, 0, 2,
+                          0, 15, 11, 0, 6, 0,
+                          0, 0, 0, 6, 0, 9,
+                          14, 0, 2, 0, 9, 0};
+    std::vector<std::pair<int, int>> queries = {{1, 5}, {5, 1}, {2, 6}, {3, 3}, {1, 3}};
+
+    std::vector<std::vector<int>> ways = getMinRanges(g, queries);
 
+    ASSERT_EQ(ways.size(), queries.size());
+    for (size_t q = 0; q < queries.size(); q++)
+        EXPECT_EQ(ways[q], getMinRange(g, queries[q].first, queries[q].second));
+}
+
+TEST(Deikstra_Algorithm_Seq, Test_Batch_Unreachable_Point) {
+    std::vector<int> g = {0, 2, 0,
+                          2, 0, 0,
+                          0, 0, 0};
+    std::vector<std::pair<int, int>> queries = {{1, 3}, {1, 2}};
+    std::vector<int> res = {2, 1};
+
+    std::vector<std::vector<int>> ways = getMinRanges(g, queries);
+
+    EXPECT_TRUE(ways[0].empty());
+    EXPECT_EQ(ways[1], res);
+}
+
+TEST(Deikstra_Algorithm_Seq, Test_Batch_Ranges_From_Sources) {
+    std::vector<int> g = {0, 7, 9, 0, 0, 14,
+                          7, 0, 10, 15, 0, 0,
+                          9, 10, 0, 11, 0, 2,
+                          0, 15, 11, 0, 6, 0,
+                          0, 0, 0, 6, 0, 9,
+                          14, 0, 2, 0, 9, 0};
+    std::vector<int> res1 = {0, 7, 9, 20, 20, 11};
+    std::vector<int> res4 = {20, 15, 11, 0, 6, 13};
+
+    std::vector<std::vector<int>> ranges = getMinRangesFrom(g, {1, 4});
+
+    EXPECT_EQ(ranges[0], res1);
+    EXPECT_EQ(ranges[1], res4);
+}
+
+TEST(Deikstra_Algorithm_Seq, DISABLED_Test_Batch_Time) {
+    int points_count = 400;
+    int queries_count = 200;
+    std::mt19937 gen(42);
+    std::vector<int> g(points_count * points_count, 0);
+    for (int i = 0; i < points_count; i++)
+        for (int j = i + 1; j < points_count; j++)
+            if (gen() % 20 == 0)
+                g[i * points_count + j] = g[j * points_count + i] = gen() % 100 + 1;
+    std::vector<std::pair<int, int>> queries;
+    for (int q = 0; q < queries_count; q++)
+        queries.push_back(std::make_pair(gen() % points_count + 1, gen() % points_count + 1));
+
+    double start = omp_get_wtime();
+    std::vector<std::vector<int>> single(queries_count);
+    for (int q = 0; q < queries_count; q++)
+        single[q] = getMinRange(g, queries[q].first, queries[q].second);
+    double single_time = omp_get_wtime() - start;
+
+    start = omp_get_wtime();
+    std::vector<std::vector<int>> ways = getMinRanges(g, queries);
+    double batch_time = omp_get_wtime() - start;
+
+    std::cout << "Single queries: " << single_time << std::endl
+              << "Batch: " << batch_time << std::endl;
+    for (int q = 0; q < queries_count; q++) {
+        int start_point = std::min(queries[q].first, queries[q].second);
+        int end_point = std::max(queries[q].first, queries[q].second);
+        if (start_point == end_point)
+            continue;
+        int len = 0;
+        for (size_t i = 1; i < ways[q].size(); i++)
+            len += g[(ways[q][i - 1] - 1) * points_count + ways[q][i] - 1];
+        EXPECT_EQ(ways[q].back(), start_point);
+        EXPECT_EQ(len, getMinRangesFrom(g, {start_point})[0][end_point - 1]);
+    }
+}
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);
@@ -35,6 +35,37 @@ TEST(SparceMatrixMultiplication, can_transpose) {
   ASSERT_TRUE(mat_trans == tmp);
 }
 
+TEST(SparceMatrixMultiplication, can_transpose_random_into_existing_matrix) {
+  std::vector<std::vector<std::complex<double>>> mat = randomMatrix(70, 45, 10);
+  std::vector<std::vector<std::complex<double>>> mat_trans(45, std::vector<std::complex<double>>(70));
+  for (int i = 0; i < 70; ++i)
+    for (int j = 0; j < 45; ++j)
+      mat_trans[j][i] = mat[i][j];
+  SparseComplexMatrix crsMat;
+  crsMat = crsMat.matrixToCRS(mat);
+  SparseComplexMatrix crsTrans;
+  crsTrans = crsTrans.matrixToCRS(mat_trans);
+
+  // operator== does not compare column indices; a product with a diagonal
+  // of distinct values makes every value depend on its column
+  std::vector<std::vector<std::complex<double>>> diag(70, std::vector<std::complex<double>>(70));
+  for (int i = 0; i < 70; ++i)
+    diag[i][i] = std::complex<double>(i + 1, 0);
+  SparseComplexMatrix crsDiag;
+  crsDiag = crsDiag.matrixToCRS(diag);
+
+  SparseComplexMatrix tmp = crsMat;
+  const int previous_threads = omp_get_max_threads();
+  for (int threads : { 1, 3, 8 }) {
+    omp_set_num_threads(threads);
+    crsMat.transposeCRS(&tmp);
+    EXPECT_TRUE(crsTrans == tmp);
+    EXPECT_TRUE(crsTrans.gustavsonMult(crsDiag) == tmp.gustavsonMult(crsDiag));
+  }
+  omp_set_num_threads(previous_threads);
+  ASSERT_TRUE(crsMat == tmp.transposeCRS());
+}
+
 TEST(SparceMatrixMultiplication, can_multimply_square_csr_matrices) {
   int size = 5;
   std::vector<std::vector<std::complex<double>>> mat1;
@@ -136,6 +167,108 @@ TEST(SparceMatrixMultiplication, can_multimply_not_square_csr_matrices_correctly
   ASSERT_TRUE(crsMat3 == res_mat);
 }
 
+TEST(SparceMatrixMultiplication, gustavson_mult_matches_crs_mult) {
+  std::vector<std::vector<std::complex<double>>> mat1 = randomMatrix(40, 30, 10);
+  std::vector<std::vector<std::complex<double>>> mat2 = randomMatrix(30, 25, 10);
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(mat1);
+  crsMat2 = crsMat2.matrixToCRS(mat2);
+  ASSERT_TRUE(crsMat1.gustavsonMult(crsMat2) == crsMat1 * crsMat2);
+}
+
+TEST(SparceMatrixMultiplication, gustavson_mult_drops_cancelled_values) {
+  std::vector<std::vector<std::complex<double>>> mat1 = {
+    {std::complex<double>(1, 0), std::complex<double>(1, 0)},
+    {std::complex<double>(0, 0), std::complex<double>(2, 0)}
+  };
+  std::vector<std::vector<std::complex<double>>> mat2 = {
+    {std::complex<double>(3, 1), std::complex<double>(1, 0)},
+    {std::complex<double>(-3, -1), std::complex<double>(1, 0)}
+  };
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(mat1);
+  crsMat2 = crsMat2.matrixToCRS(mat2);
+  SparseComplexMatrix res_mat(2, 2, {std::complex<double>(2, 0), std::complex<double>(-6, -2),
+    std::complex<double>(2, 0)}, {1, 0, 1}, {0, 1, 3});
+  ASSERT_TRUE(crsMat1.gustavsonMult(crsMat2) == res_mat);
+}
+
+TEST(SparceMatrixMultiplication, gustavson_mult_throws_on_wrong_sizes) {
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(randomMatrix(4, 3, 50));
+  crsMat2 = crsMat2.matrixToCRS(randomMatrix(4, 3, 50));
+  ASSERT_ANY_THROW(crsMat1.gustavsonMult(crsMat2));
+}
+
+TEST(SparceMatrixMultiplication, DISABLED_gustavson_mult_time) {
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(randomMatrix(1500, 1500, 0.3));
+  crsMat2 = crsMat2.matrixToCRS(randomMatrix(1500, 1500, 0.3));
+  double start = omp_get_wtime();
+  SparseComplexMatrix res1 = crsMat1.crsParallelMult(crsMat2);
+  double end = omp_get_wtime();
+  std::cout << "Dot products: " << end - start << std::endl;
+  start = omp_get_wtime();
+  SparseComplexMatrix res2 = crsMat1.gustavsonMult(crsMat2);
+  end = omp_get_wtime();
+  std::cout << "Gustavson: " << end - start << std::endl;
+  ASSERT_TRUE(res1 == res2);
+}
+
+std::vector<std::vector<std::complex<double>>> skewedMatrix(int rows, int cols, double percent) {
+  std::vector<std::vector<std::complex<double>>> matrix = randomMatrix(rows, cols, percent);
+  for (int i = 0; i < rows / 10; ++i)
+    for (int j = 0; j < cols; ++j)
+      matrix[i][j] = std::complex<double>(i + 1, j % 5);
+  return matrix;
+}
+
+TEST(SparceMatrixMultiplication, partition_rows_by_flops_balances_work) {
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(skewedMatrix(100, 80, 2));
+  crsMat2 = crsMat2.matrixToCRS(randomMatrix(80, 60, 20));
+  std::vector<int> bounds = crsMat1.partitionRowsByFlops(crsMat2, 4);
+  ASSERT_EQ(bounds.size(), 5u);
+  ASSERT_EQ(bounds[0], 0);
+  ASSERT_EQ(bounds[4], 100);
+  for (int part = 0; part < 4; ++part)
+    ASSERT_LE(bounds[part], bounds[part + 1]);
+  // the dense rows at the top take more than a quarter of the work
+  ASSERT_LT(bounds[1], 10);
+  ASSERT_ANY_THROW(crsMat1.partitionRowsByFlops(crsMat1, 4));
+}
+
+TEST(SparceMatrixMultiplication, skewed_parallel_mult_matches_crs_mult) {
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(skewedMatrix(50, 40, 5));
+  crsMat2 = crsMat2.matrixToCRS(randomMatrix(40, 30, 10));
+  SparseComplexMatrix res = crsMat1 * crsMat2;
+  ASSERT_TRUE(crsMat1.crsParallelMult(crsMat2) == res);
+  ASSERT_TRUE(crsMat1.gustavsonMult(crsMat2) == res);
+}
+
+TEST(SparceMatrixMultiplication, DISABLED_skewed_mult_time) {
+  SparseComplexMatrix crsMat1;
+  SparseComplexMatrix crsMat2;
+  crsMat1 = crsMat1.matrixToCRS(skewedMatrix(1000, 1000, 0.5));
+  crsMat2 = crsMat2.matrixToCRS(randomMatrix(1000, 1000, 1));
+  double start = omp_get_wtime();
+  SparseComplexMatrix res1 = crsMat1 * crsMat2;
+  double end = omp_get_wtime();
+  std::cout << "Sequential: " << end - start << std::endl;
+  start = omp_get_wtime();
+  SparseComplexMatrix res2 = crsMat1.crsParallelMult(crsMat2);
+  end = omp_get_wtime();
+  std::cout << "Parallel by rows: " << end - start << std::endl;
+  ASSERT_TRUE(res1 == res2);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -2,6 +2,7 @@
 #include "../../modules/task_2/shashkin_e_sparse_matrix_multiplication_crs/sparse_matrix_multiplication_crs.h"
 #include <omp.h>
 #include <vector>
+#include <algorithm>
 SparseComplexMatrix::SparseComplexMatrix() {
   rows_num = 0;
   cols_num = 0;
@@ -90,30 +91,64 @@ SparseComplexMatrix SparseComplexMatrix::matrixToCRS(std::vector<std::vector<std
 }
 
 SparseComplexMatrix SparseComplexMatrix::transposeCRS() {
-  SparseComplexMatrix result(cols_num, rows_num);
-  std::vector<int> rowT_count;
-  std::vector<int> row_count;
-  std::vector<int> row_idxs;
-  int k = 0;
-  result.row_index.push_back(0);
-  for (int i = 0; i < rows_num; ++i) {
-    row_count.push_back(row_index[i + 1] - row_index[i]);
-    for (int j = 0; j < row_count[i]; ++j)
-      row_idxs.push_back(i);
-  }
-  for (int i = 0; i < cols_num; ++i) {
-    for (unsigned j = 0; j < values.size(); ++j) {
-      if (col_index[j] == i) {
-        result.values.push_back(values[j]);
-        result.col_index.push_back(row_idxs[j]);
-        k++;
+  SparseComplexMatrix result;
+  transposeCRS(&result);
+  return result;
+}
+
+void SparseComplexMatrix::transposeCRS(SparseComplexMatrix* result) const& {
+  // Per-thread column counts, a prefix sum, then an in-order scatter of each thread's rows
+  static thread_local std::vector<int> counters;
+  const int threads = std::max(1, std::min(omp_get_max_threads(), rows_num));
+  const int nonzeros = values.size();
+  result->rows_num = cols_num;
+  result->cols_num = rows_num;
+  result->values.resize(nonzeros);
+  result->col_index.resize(nonzeros);
+  result->row_index.resize(cols_num + 1);
+  counters.assign(static_cast<size_t>(threads) * cols_num, 0);
+  int* count = counters.data();
+
+#pragma omp parallel num_threads(threads)
+  {
+    const int tid = omp_get_thread_num();
+    const int num = omp_get_num_threads();
+    const int first = static_cast<int64_t>(rows_num) * tid / num;
+    const int last = static_cast<int64_t>(rows_num) * (tid + 1) / num;
+    int* own = count + static_cast<size_t>(tid) * cols_num;
+    for (int i = first; i < last; ++i)
+      for (int iter = row_index[i]; iter < row_index[i + 1]; ++iter)
+        ++own[col_index[iter]];
+#pragma omp barrier
+#pragma omp for schedule(static)
+    for (int j = 0; j < cols_num; ++j) {
+      int total = 0;
+      for (int t = 0; t < num; ++t)
+        total += count[static_cast<size_t>(t) * cols_num + j];
+      result->row_index[j + 1] = total;
+    }
+#pragma omp single
+    {
+      result->row_index[0] = 0;
+      for (int j = 0; j < cols_num; ++j)
+        result->row_index[j + 1] += result->row_index[j];
+    }
+#pragma omp for schedule(static)
+    for (int j = 0; j < cols_num; ++j) {
+      int pos = result->row_index[j];
+      for (int t = 0; t < num; ++t) {
+        int line_count = count[static_cast<size_t>(t) * cols_num + j];
+        count[static_cast<size_t>(t) * cols_num + j] = pos;
+        pos += line_count;
       }
     }
-    rowT_count.push_back(k);
-    k = 0;
-    result.row_index.push_back(result.row_index[i] + rowT_count[i]);
+    for (int i = first; i < last; ++i)
+      for (int iter = row_index[i]; iter < row_index[i + 1]; ++iter) {
+        int pos = own[col_index[iter]]++;
+        result->values[pos] = values[iter];
+        result->col_index[pos] = i;
+      }
   }
-  return result;
 }
 
 bool SparseComplexMatrix::operator==(const SparseComplexMatrix& mat) const& {
@@ -132,8 +167,7 @@ bool SparseComplexMatrix::operator==(const SparseComplexMatrix& mat) const& {
 SparseComplexMatrix SparseComplexMatrix::operator*(const SparseComplexMatrix& mat) const& {
   SparseComplexMatrix result(rows_num, mat.cols_num);
   SparseComplexMatrix tmp;
-  tmp = mat;
-  tmp = tmp.transposeCRS();
+  mat.transposeCRS(&tmp);
   int not_zero_vals = 0;
   if (cols_num != tmp.cols_num)
     throw std::runtime_error("Error! Incorrect numbers of cols!\n");
@@ -167,26 +201,63 @@ SparseComplexMatrix SparseComplexMatrix::operator*(const SparseComplexMatrix& ma
   return result;
 }
 
+// Prefix sums of the row costs, then every bound is the first row whose
+// prefix reaches its share of the total; returns parts + 1 row bounds
+static std::vector<int> partitionRowsByCost(const std::vector<int64_t>& row_cost, int parts) {
+  std::vector<int64_t> cost(row_cost.size() + 1, 0);
+  for (unsigned i = 0; i < row_cost.size(); ++i)
+    cost[i + 1] = cost[i] + row_cost[i];
+  std::vector<int> bounds(parts + 1, static_cast<int>(row_cost.size()));
+  bounds[0] = 0;
+  for (int part = 1; part < parts; ++part) {
+    int64_t target = cost.back() * part / parts;
+    bounds[part] = std::lower_bound(cost.begin(), cost.end(), target) - cost.begin();
+  }
+  return bounds;
+}
+
+std::vector<int> SparseComplexMatrix::partitionRowsByFlops(const SparseComplexMatrix& mat, int parts) const& {
+  if (cols_num != mat.rows_num)
+    throw std::runtime_error("Error! Incorrect numbers of cols!\n");
+  if (parts <= 0)
+    throw std::runtime_error("Error! Incorrect number of parts!\n");
+  std::vector<int64_t> row_cost(rows_num);
+  for (int i = 0; i < rows_num; ++i) {
+    row_cost[i] = 1;
+    for (int iter = row_index[i]; iter < row_index[i + 1]; ++iter)
+      row_cost[i] += mat.row_index[col_index[iter] + 1] - mat.row_index[col_index[iter]];
+  }
+  return partitionRowsByCost(row_cost, parts);
+}
+
 SparseComplexMatrix SparseComplexMatrix::crsParallelMult(const SparseComplexMatrix& mat) const& {
   SparseComplexMatrix result(rows_num, mat.cols_num);
   SparseComplexMatrix tmp;
-  tmp = mat;
-  tmp = tmp.transposeCRS();
-  int not_zero_vals = 0;
+  mat.transposeCRS(&tmp);
   if (cols_num != tmp.cols_num)
     throw std::runtime_error("Error! Incorrect numbers of cols!\n");
-  result.row_index.push_back(0);
-  for (unsigned i = 1; i < row_index.size(); ++i) {
-    std::vector<std::complex<double>> vals(tmp.row_index.size(), std::complex<double>(0.0, 0.0));
-    std::vector<int> cols(tmp.row_index.size(), 0);
-#pragma omp parallel
-    {
-#pragma omp for schedule(static)
-      for (int j = 1; j < static_cast<int>(tmp.row_index.size()); ++j) {
+
+  // Rows are split between the threads by cost: every dot product of a
+  // non-empty row walks at most the row itself and one row of tmp
+  const int64_t tmp_nonzeros = tmp.values.size();
+  std::vector<int64_t> cost(rows_num);
+  for (int i = 0; i < rows_num; ++i) {
+    int64_t len = row_index[i + 1] - row_index[i];
+    cost[i] = len == 0 ? tmp.rows_num : len * tmp.rows_num + tmp_nonzeros;
+  }
+  const int parts = omp_get_max_threads();
+  std::vector<int> bounds = partitionRowsByCost(cost, parts);
+
+  std::vector<std::vector<std::complex<double>>> vals(rows_num);
+  std::vector<std::vector<int>> cols(rows_num);
+#pragma omp parallel for schedule(static, 1)
+  for (int part = 0; part < parts; ++part) {
+    for (int i = bounds[part]; i < bounds[part + 1]; ++i) {
+      for (int j = 0; j < tmp.rows_num; ++j) {
         std::complex<double> s = 0;
-        int iter1 = row_index[i - 1];
-        int iter2 = tmp.row_index[j - 1];
-        while ((iter1 < row_index[i]) && (iter2 < tmp.row_index[j])) {
+        int iter1 = row_index[i];
+        int iter2 = tmp.row_index[j];
+        while ((iter1 < row_index[i + 1]) && (iter2 < tmp.row_index[j + 1])) {
           if (col_index[iter1] == tmp.col_index[iter2]) {
             s += values[iter1] * tmp.values[iter2];
             iter1++;
@@ -200,20 +271,107 @@ SparseComplexMatrix SparseComplexMatrix::crsParallelMult(const SparseComplexMatr
           }
         }
         if (s.real() != 0.0 || s.imag() != 0.0) {
-          vals[j - 1] = s;
-          cols[j - 1] = j - 1;
-#pragma omp atomic
-          not_zero_vals++;
+          vals[i].push_back(s);
+          cols[i].push_back(j);
         }
       }
     }
-    for (unsigned j = 0; j < tmp.row_index.size(); ++j)
-      if (vals[j].real() != 0.0 || vals[j].imag() != 0.0) {
-        result.values.push_back(vals[j]);
-        result.col_index.push_back(cols[j]);
+  }
+
+  result.row_index.push_back(0);
+  for (int i = 0; i < rows_num; ++i) {
+    result.values.insert(result.values.end(), vals[i].begin(), vals[i].end());
+    result.col_index.insert(result.col_index.end(), cols[i].begin(), cols[i].end());
+    result.row_index.push_back(result.values.size());
+  }
+  return result;
+}
+
+SparseComplexMatrix SparseComplexMatrix::gustavsonMult(const SparseComplexMatrix& mat) const& {
+  if (cols_num != mat.rows_num)
+    throw std::runtime_error("Error! Incorrect numbers of cols!\n");
+  SparseComplexMatrix result(rows_num, mat.cols_num);
+  result.row_index.assign(rows_num + 1, 0);
+  // One part per thread; a row costs its multiply-adds plus one
+  const int parts = omp_get_max_threads();
+  std::vector<int> bounds = partitionRowsByFlops(mat, parts);
+
+  // symbolic pass: number of structural nonzeros of every row
+#pragma omp parallel
+  {
+    std::vector<int> marker(mat.cols_num, -1);
+#pragma omp for schedule(static, 1)
+    for (int part = 0; part < parts; ++part) {
+      for (int i = bounds[part]; i < bounds[part + 1]; ++i) {
+        int count = 0;
+        for (int iter1 = row_index[i]; iter1 < row_index[i + 1]; ++iter1) {
+          int k = col_index[iter1];
+          for (int iter2 = mat.row_index[k]; iter2 < mat.row_index[k + 1]; ++iter2) {
+            if (marker[mat.col_index[iter2]] != i) {
+              marker[mat.col_index[iter2]] = i;
+              count++;
+            }
+          }
+        }
+        result.row_index[i + 1] = count;
       }
-    result.row_index.push_back(not_zero_vals);
+    }
+  }
+  for (int i = 0; i < rows_num; ++i)
+    result.row_index[i + 1] += result.row_index[i];
+  result.values.resize(result.row_index[rows_num]);
+  result.col_index.resize(result.row_index[rows_num]);
+
+  // numeric pass, sums that cancel to zero are dropped like in operator*
+  std::vector<int> row_size(rows_num, 0);
+#pragma omp parallel
+  {
+    std::vector<int> marker(mat.cols_num, -1);
+    std::vector<std::complex<double>> acc(mat.cols_num);
+    std::vector<int> touched;
+#pragma omp for schedule(static, 1)
+    for (int part = 0; part < parts; ++part) {
+      for (int i = bounds[part]; i < bounds[part + 1]; ++i) {
+        touched.clear();
+        for (int iter1 = row_index[i]; iter1 < row_index[i + 1]; ++iter1) {
+          int k = col_index[iter1];
+          for (int iter2 = mat.row_index[k]; iter2 < mat.row_index[k + 1]; ++iter2) {
+            int j = mat.col_index[iter2];
+            if (marker[j] != i) {
+              marker[j] = i;
+              acc[j] = 0;
+              touched.push_back(j);
+            }
+            acc[j] += values[iter1] * mat.values[iter2];
+          }
+        }
+        std::sort(touched.begin(), touched.end());
+        int pos = result.row_index[i];
+        for (int j : touched) {
+          if (acc[j].real() != 0.0 || acc[j].imag() != 0.0) {
+            result.col_index[pos] = j;
+            result.values[pos++] = acc[j];
+          }
+        }
+        row_size[i] = pos - result.row_index[i];
+      }
+    }
+  }
+
+  // close the gaps left by cancelled entries
+  int not_zero_vals = 0;
+  for (int i = 0; i < rows_num; ++i) {
+    int from = result.row_index[i];
+    for (int j = 0; j < row_size[i]; ++j) {
+      result.col_index[not_zero_vals + j] = result.col_index[from + j];
+      result.values[not_zero_vals + j] = result.values[from + j];
+    }
+    result.row_index[i] = not_zero_vals;
+    not_zero_vals += row_size[i];
   }
+  result.row_index[rows_num] = not_zero_vals;
+  result.values.resize(not_zero_vals);
+  result.col_index.resize(not_zero_vals);
   return result;
 }
 
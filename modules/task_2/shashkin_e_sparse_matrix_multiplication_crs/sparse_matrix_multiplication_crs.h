@@ -8,6 +8,7 @@
 #include <random>
 #include <ctime>
 #include <algorithm>
+#include <cstdint>
 
 class SparseComplexMatrix {
  private:
@@ -17,6 +18,7 @@ class SparseComplexMatrix {
   std::vector<std::complex<double>> values;
   std::vector<int> col_index;
   std::vector<int> row_index;
+
  public:
   SparseComplexMatrix();
   SparseComplexMatrix(int _rows_num, int _cols_num);
@@ -26,8 +28,18 @@ class SparseComplexMatrix {
   bool operator==(const SparseComplexMatrix& mat) const&;
   SparseComplexMatrix operator*(const SparseComplexMatrix& mat) const&;
   SparseComplexMatrix crsParallelMult(const SparseComplexMatrix& mat) const&;
+  // Row-wise Gustavson product: a symbolic pass sizes every row of the result
+  // exactly, then each thread accumulates its rows in a dense accumulator
+  // with a marker array and a list of touched columns
+  SparseComplexMatrix gustavsonMult(const SparseComplexMatrix& mat) const&;
+  // Splits the rows of (*this) into parts contiguous ranges of about the same
+  // cost in (*this) * mat (multiply-adds plus one for the row itself),
+  // returns parts + 1 row bounds
+  std::vector<int> partitionRowsByFlops(const SparseComplexMatrix& mat, int parts) const&;
   SparseComplexMatrix matrixToCRS(std::vector<std::vector<std::complex<double>>> matrix);
   SparseComplexMatrix transposeCRS();
+  // Writes the transpose into result, reusing the memory it already holds
+  void transposeCRS(SparseComplexMatrix* result) const&;
   void printCRS();
 };
 
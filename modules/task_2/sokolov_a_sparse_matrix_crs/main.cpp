@@ -1,6 +1,11 @@
 // Copyright 2020 Sokolov Andrey
 #include <gtest/gtest.h>
 #include <omp.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
 #include <vector>
 #include "./sparse_matrix_crs_omp.h"
 
@@ -396,3 +401,378 @@ TEST(Sparse_Matrix, Test_Omp_Matrix_Miltiplication_With_Rand_Gen) {
     // std::cout << "Acseleration_Sparse_Mul " << (t2Seq - t1Seq) / (t2Omp - t1Omp) << std::endl;
     ASSERT_NEAR_SPARSE_MATRIX(resultSparse, resultSparseOmp, 1e-6);
 }
+
+int64_t partCost(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int begin, int end) {
+    int64_t cost{0};
+    for (int idx{begin}; idx < end; ++idx) {
+        cost += matrixB.cols;
+        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+            int tmpCol{matrixA.colIndex[jdx]};
+            cost += matrixB.rowIndex[tmpCol + 1] - matrixB.rowIndex[tmpCol];
+        }
+    }
+    return cost;
+}
+
+TEST(Sparse_Matrix, Test_Partition_Rows_By_Flops) {
+    SparseMatrix sparseMatrixA{ generatePowerLawMatrix(200, 200, 200) };
+    SparseMatrix sparseMatrixB{ generateMatrix(200, 200, 5) };
+    constexpr int parts{4};
+
+    std::vector<int> bounds = partitionRowsByFlops(sparseMatrixA, sparseMatrixB, parts);
+
+    ASSERT_EQ(bounds.size(), static_cast<size_t>(parts + 1));
+    ASSERT_EQ(bounds.front(), 0);
+    ASSERT_EQ(bounds.back(), 200);
+    int64_t total{partCost(sparseMatrixA, sparseMatrixB, 0, 200)};
+    int64_t maxRowCost{0};
+    for (int idx{0}; idx < 200; ++idx) {
+        maxRowCost = std::max(maxRowCost, partCost(sparseMatrixA, sparseMatrixB, idx, idx + 1));
+    }
+    for (int part{0}; part < parts; ++part) {
+        ASSERT_LE(bounds[part], bounds[part + 1]);
+        ASSERT_LE(partCost(sparseMatrixA, sparseMatrixB, bounds[part], bounds[part + 1]),
+                  total / parts + maxRowCost);
+    }
+}
+
+TEST(Sparse_Matrix, Test_Omp_Matrix_Miltiplication_Power_Law) {
+    Matrix matrixA{ generatePowerLawMatrix(60, 40, 40) };
+    Matrix matrixB{ generateMatrix(40, 70, 10) };
+
+    SparseMatrix sparseMatrixA{ matrixA };
+    SparseMatrix sparseMatrixB{ matrixB };
+
+    SparseMatrix resultToSparse{ MatMul(matrixA, matrixB) };
+    SparseMatrix resultSparseOmp = SparseMatMulOmp(sparseMatrixA, sparseMatrixB);
+
+    ASSERT_NEAR_SPARSE_MATRIX(resultToSparse, resultSparseOmp, 1e-6);
+}
+
+TEST(Sparse_Matrix, DISABLED_Test_Omp_Power_Law_Balance) {
+    constexpr size_t size{3000U};
+    constexpr int parts{4};
+    SparseMatrix sparseMatrixA{ generatePowerLawMatrix(size, size, size) };
+    SparseMatrix sparseMatrixB{ generateMatrix(size, size, 10) };
+
+    std::vector<int> bounds = partitionRowsByFlops(sparseMatrixA, sparseMatrixB, parts);
+    int64_t total{partCost(sparseMatrixA, sparseMatrixB, 0, size)};
+    int64_t maxByRows{0};
+    int64_t maxByFlops{0};
+    for (int part{0}; part < parts; ++part) {
+        maxByRows = std::max(maxByRows, partCost(sparseMatrixA, sparseMatrixB, size * part / parts,
+                                                 size * (part + 1) / parts));
+        maxByFlops = std::max(maxByFlops, partCost(sparseMatrixA, sparseMatrixB, bounds[part], bounds[part + 1]));
+    }
+    std::cout << "Heaviest part / average, equal rows: " << maxByRows * parts / static_cast<double>(total)
+              << ", equal flops: " << maxByFlops * parts / static_cast<double>(total) << std::endl;
+
+    double t1 = omp_get_wtime();
+    SparseMatrix resultSparse = SparseMatMul(sparseMatrixA, sparseMatrixB);
+    double t2 = omp_get_wtime();
+    SparseMatrix resultSparseOmp = SparseMatMulOmp(sparseMatrixA, sparseMatrixB);
+    double t3 = omp_get_wtime();
+    std::cout << "Seq_Sparse_Mul: " << t2 - t1 << std::endl;
+    std::cout << "OMP_Sparse_Mul: " << t3 - t2 << std::endl;
+
+    ASSERT_NEAR_SPARSE_MATRIX(resultSparse, resultSparseOmp, 1e-6);
+}
+
+TEST(Sparse_Matrix, Test_Dense_And_Sparse_Accumulators_Are_Bit_Identical) {
+    const size_t coeffs[] = {0U, 5U, 60U};
+    for (size_t coeff : coeffs) {
+        SparseMatrix sparseMatrixA{ generateMatrix(70, 50, coeff) };
+        SparseMatrix sparseMatrixB{ generateMatrix(50, 90, coeff) };
+
+        SparseMatrix resultDense = SparseMatMul(sparseMatrixA, sparseMatrixB, 0.0);
+        SparseMatrix resultSparse = SparseMatMul(sparseMatrixA, sparseMatrixB, 1e9);
+        SparseMatrix resultHybrid = SparseMatMul(sparseMatrixA, sparseMatrixB);
+        SparseMatrix resultHybridOmp = SparseMatMulOmp(sparseMatrixA, sparseMatrixB);
+        SparseMatrix resultSparseOmp = SparseMatMulOmp(sparseMatrixA, sparseMatrixB, 1e9);
+
+        EXPECT_EQ(resultDense.rowIndex, resultSparse.rowIndex);
+        EXPECT_EQ(resultDense.colIndex, resultSparse.colIndex);
+        EXPECT_EQ(resultDense.value, resultSparse.value);
+        EXPECT_EQ(resultDense.value, resultHybrid.value);
+        EXPECT_EQ(resultDense.value, resultHybridOmp.value);
+        EXPECT_EQ(resultDense.value, resultSparseOmp.value);
+        EXPECT_EQ(resultDense.colIndex, resultSparseOmp.colIndex);
+    }
+}
+
+TEST(Sparse_Matrix, Test_Sparse_Accumulator_Rectangular) {
+    Matrix matrixA{ generatePowerLawMatrix(30, 80, 20) };
+    Matrix matrixB{ generateMatrix(80, 15, 3) };
+
+    SparseMatrix resultToSparse{ MatMul(matrixA, matrixB) };
+    SparseMatrix resultSparse = SparseMatMul(SparseMatrix{ matrixA }, SparseMatrix{ matrixB }, 1e9);
+
+    ASSERT_NEAR_SPARSE_MATRIX(resultToSparse, resultSparse, 1e-6);
+}
+
+// generateMatrix(size, size, 0) has about 1% of elements, so a result row
+// gets about size / 10000 * cols products
+TEST(Sparse_Matrix, DISABLED_Test_Dense_Accumulator_Threshold) {
+    const size_t sizes[] = {250U, 500U, 750U, 1000U, 1500U, 2000U, 3000U};
+    for (size_t size : sizes) {
+        SparseMatrix sparseMatrix{ generateMatrix(size, size, 0) };
+        int repeats{static_cast<int>(3000U / size)};
+        double fill{static_cast<double>(sparseMatrix.value.size()) * sparseMatrix.value.size() / size / size / size};
+
+        double t1 = omp_get_wtime();
+        for (int rep{0}; rep < repeats; ++rep) {
+            SparseMatMul(sparseMatrix, sparseMatrix, 0.0);
+        }
+        double t2 = omp_get_wtime();
+        for (int rep{0}; rep < repeats; ++rep) {
+            SparseMatMul(sparseMatrix, sparseMatrix, 1e9);
+        }
+        double t3 = omp_get_wtime();
+        std::cout << "Products per row / cols " << fill << ": dense " << (t2 - t1) / repeats
+                  << ", sparse " << (t3 - t2) / repeats << std::endl;
+    }
+}
+
+TEST(Sparse_Matrix, Test_Sell_Mat_Vec) {
+    Matrix matrix{ generatePowerLawMatrix(37, 29, 29) };
+    SparseMatrix sparseMatrix{ matrix };
+    std::vector<double> x(29);
+    for (size_t idx{0U}; idx < x.size(); ++idx) {
+        x[idx] = 0.5 * idx - 3.0;
+    }
+    std::vector<double> expected(37, 0.0);
+    for (size_t idx{0U}; idx < 37U; ++idx) {
+        for (size_t jdx{0U}; jdx < 29U; ++jdx) {
+            expected[idx] += matrix[idx][jdx] * x[jdx];
+        }
+    }
+
+    std::vector<double> resultCrs = SparseMatVecOmp(sparseMatrix, x);
+    for (int sigma : {1, 8, 16, 256}) {
+        SellMatrix sellMatrix = SparseToSell(sparseMatrix, sigma);
+        ASSERT_EQ(sellMatrix.chunkLength.size(), 5U);
+        std::vector<double> resultSell = SellMatVecOmp(sellMatrix, x);
+        for (size_t idx{0U}; idx < 37U; ++idx) {
+            ASSERT_NEAR(expected[idx], resultCrs[idx], 1e-6);
+            ASSERT_NEAR(expected[idx], resultSell[idx], 1e-6);
+        }
+    }
+}
+
+TEST(Sparse_Matrix, Test_Sell_Mat_Dense) {
+    Matrix matrix{ generateMatrix(45, 30, 4) };
+    Matrix x{ generateMatrix(30, 5, 50) };
+    SparseMatrix sparseMatrix{ matrix };
+    SparseMatrix expected{ MatMul(matrix, x) };
+
+    SparseMatrix resultCrs{ SparseMatDenseOmp(sparseMatrix, x) };
+    SparseMatrix resultSell{ SellMatDenseOmp(SparseToSell(sparseMatrix, 16), x) };
+
+    ASSERT_NEAR_SPARSE_MATRIX(expected, resultCrs, 1e-6);
+    ASSERT_NEAR_SPARSE_MATRIX(expected, resultSell, 1e-6);
+}
+
+TEST(Sparse_Matrix, Test_Sell_Wrong_Size) {
+    SparseMatrix sparseMatrix{ generateMatrix(10, 10, 2) };
+    std::vector<double> x(9, 1.0);
+
+    ASSERT_ANY_THROW(SparseMatVecOmp(sparseMatrix, x));
+    ASSERT_ANY_THROW(SellMatVecOmp(SparseToSell(sparseMatrix), x));
+    ASSERT_ANY_THROW(SparseToSell(sparseMatrix, 0));
+}
+
+TEST(Sparse_Matrix, Test_Choose_Spmv_Format) {
+    std::vector<double> value(800, 1.0);
+    std::vector<int> colIndex(800);
+    std::vector<int> rowIndex(101);
+    for (int idx{0}; idx < 800; ++idx) {
+        colIndex[idx] = idx % 8 * 10 + idx / 8 % 10;
+    }
+    for (int idx{0}; idx <= 100; ++idx) {
+        rowIndex[idx] = 8 * idx;
+    }
+    SparseMatrix uniform(100, 100, value, colIndex, rowIndex);
+
+    // One row of 100 elements among rows of one: its chunk is padded to 100
+    // elements per row, 4.5 times the nonzeros
+    std::vector<int> skewedRowIndex(101);
+    std::vector<int> skewedColIndex(199);
+    for (int idx{0}; idx < 100; ++idx) {
+        skewedColIndex[idx] = idx;
+    }
+    for (int idx{1}; idx <= 100; ++idx) {
+        skewedRowIndex[idx] = 99 + idx;
+        if (idx < 100) {
+            skewedColIndex[99 + idx] = idx;
+        }
+    }
+    SparseMatrix skewed(100, 100, std::vector<double>(199, 1.0), skewedColIndex, skewedRowIndex);
+
+    ASSERT_EQ(chooseSpmvFormat(uniform), SpmvFormat::Sell);
+    ASSERT_EQ(chooseSpmvFormat(skewed), SpmvFormat::Crs);
+
+    std::vector<double> x(100, 1.0);
+    std::vector<double> y = SpmvOperator(uniform).apply(x);
+    for (double elem : y) {
+        ASSERT_NEAR(elem, 8.0, 1e-6);
+    }
+}
+
+TEST(Sparse_Matrix, Test_Spmv_Operator_Wrong_Sigma) {
+    SparseMatrix sparseMatrix{ generateMatrix(20, 20, 0) };
+    ASSERT_THROW(chooseSpmvFormat(sparseMatrix, 0), std::invalid_argument);
+    ASSERT_THROW(SpmvOperator(sparseMatrix, 0), std::invalid_argument);
+    ASSERT_THROW(SpmvOperator(sparseMatrix, -4), std::invalid_argument);
+}
+
+TEST(Sparse_Matrix, DISABLED_Test_Spmv_Crs_Vs_Sell) {
+    constexpr size_t size{4000U};
+    constexpr int repeats{200};
+    SparseMatrix sparseMatrix{ generateMatrix(size, size, 0) };
+    SellMatrix sellMatrix = SparseToSell(sparseMatrix);
+    std::vector<double> x(size, 1.0);
+    std::vector<double> resultCrs;
+    std::vector<double> resultSell;
+
+    double t1 = omp_get_wtime();
+    for (int rep{0}; rep < repeats; ++rep) {
+        resultCrs = SparseMatVecOmp(sparseMatrix, x);
+    }
+    double t2 = omp_get_wtime();
+    for (int rep{0}; rep < repeats; ++rep) {
+        resultSell = SellMatVecOmp(sellMatrix, x);
+    }
+    double t3 = omp_get_wtime();
+    std::cout << "Padding: " << static_cast<double>(sellMatrix.value.size()) / sellMatrix.elemsCount
+              << ", chosen: " << (chooseSpmvFormat(sparseMatrix) == SpmvFormat::Sell ? "SELL" : "CRS") << std::endl;
+    std::cout << "CRS_Spmv: " << t2 - t1 << std::endl;
+    std::cout << "SELL_Spmv: " << t3 - t2 << std::endl;
+
+    for (size_t idx{0U}; idx < size; ++idx) {
+        ASSERT_NEAR(resultCrs[idx], resultSell[idx], 1e-6);
+    }
+}
+
+// A file in the gtest temporary directory with a name unique to the test
+// and the run; it is removed when the test leaves its scope
+class TempFile {
+ public:
+    explicit TempFile(const std::string& suffix) {
+        const ::testing::TestInfo* info{::testing::UnitTest::GetInstance()->current_test_info()};
+        std::random_device rd{};
+        path_ = ::testing::TempDir() + "sokolov_" + info->name() + "_" + std::to_string(rd()) + suffix;
+    }
+    TempFile(const TempFile&) = delete;
+    TempFile& operator=(const TempFile&) = delete;
+    ~TempFile() { std::remove(path_.c_str()); }
+
+    const std::string& path() const { return path_; }
+
+ private:
+    std::string path_;
+};
+
+TEST(Sparse_Matrix, Test_Matrix_Market_Round_Trip) {
+    SparseMatrix sparseMatrix{ generateMatrix(70, 40, 10) };
+    TempFile file(".mtx");
+    writeMatrixMarket(sparseMatrix, file.path());
+
+    LoadStats stats{};
+    SparseMatrix loaded{ readMatrixMarket(file.path(), &stats) };
+
+    ASSERT_EQ(loaded.rows, 70);
+    ASSERT_EQ(loaded.cols, 40);
+    ASSERT_GT(stats.bytes, 0U);
+    ASSERT_NEAR_SPARSE_MATRIX(sparseMatrix, loaded, 1e-12);
+}
+
+TEST(Sparse_Matrix, Test_Matrix_Market_Symmetric_Pattern) {
+    TempFile file(".mtx");
+    {
+        std::ofstream out(file.path());
+        out << "%%MatrixMarket matrix coordinate pattern symmetric\n"
+            << "% lower triangle only\n"
+            << "3 3 4\n"
+            << "1 1\n3 1\n\n2 2\n3 2";
+    }
+    SparseMatrix loaded{ readMatrixMarket(file.path()) };
+
+    Matrix expected{ {1.0, 0.0, 1.0},
+                     {0.0, 1.0, 1.0},
+                     {1.0, 1.0, 0.0} };
+    SparseMatrix sparseExpected{ expected };
+    ASSERT_NEAR_SPARSE_MATRIX(sparseExpected, loaded, 1e-12);
+}
+
+TEST(Sparse_Matrix, Test_Matrix_Market_Wrong_File) {
+    TempFile file(".mtx");
+    {
+        std::ofstream out(file.path());
+        out << "%%MatrixMarket matrix coordinate real general\n"
+            << "2 2 2\n"
+            << "1 1 1.0\n"
+            << "3 1 2.0\n";
+    }
+    ASSERT_ANY_THROW(readMatrixMarket(file.path()));
+    ASSERT_ANY_THROW(readBinaryCrs(file.path()));
+    TempFile missing(".mtx");
+    ASSERT_ANY_THROW(readMatrixMarket(missing.path()));
+}
+
+TEST(Sparse_Matrix, Test_Binary_Crs_Round_Trip) {
+    SparseMatrix sparseMatrix{ generatePowerLawMatrix(90, 35, 35) };
+    TempFile file(".crs");
+    writeBinaryCrs(sparseMatrix, file.path());
+
+    SparseMatrix loaded{ readBinaryCrs(file.path()) };
+    ASSERT_NEAR_SPARSE_MATRIX(sparseMatrix, loaded, 0.0);
+
+    std::vector<double> x(35, 2.0);
+    std::vector<double> expected = SparseMatVecOmp(sparseMatrix, x);
+    {
+        MappedCrs view(file.path());
+        ASSERT_EQ(view.elemsCount, sparseMatrix.value.size());
+        std::vector<double> result = SparseMatVecOmp(view, x);
+        for (size_t idx{0U}; idx < expected.size(); ++idx) {
+            ASSERT_EQ(expected[idx], result[idx]);
+        }
+    }
+}
+
+TEST(Sparse_Matrix, Test_Binary_Crs_Corrupt_Indices) {
+    // 3 x 3 with 4 elements
+    std::vector<double> value{ 1.0, 2.0, 3.0, 4.0 };
+    SparseMatrix wrongColumn(3, 3, value, { 0, 2, 3, 1 }, { 0, 1, 3, 4 });
+    SparseMatrix wrongRows(3, 3, value, { 0, 2, 1, 1 }, { 0, 3, 1, 4 });
+    SparseMatrix wrongCount(3, 3, value, { 0, 2, 1, 1 }, { 0, 1, 3, 3 });
+
+    TempFile file(".crs");
+    writeBinaryCrs(wrongColumn, file.path());
+    ASSERT_THROW(MappedCrs view(file.path()), std::runtime_error);
+    ASSERT_THROW(readBinaryCrs(file.path()), std::runtime_error);
+    writeBinaryCrs(wrongRows, file.path());
+    ASSERT_THROW(MappedCrs view(file.path()), std::runtime_error);
+    writeBinaryCrs(wrongCount, file.path());
+    ASSERT_THROW(MappedCrs view(file.path()), std::runtime_error);
+}
+
+TEST(Sparse_Matrix, DISABLED_Test_Load_Throughput) {
+    constexpr size_t size{5000U};
+    SparseMatrix sparseMatrix{ generateMatrix(size, size, 1) };
+    TempFile marketFile(".mtx");
+    TempFile binaryFile(".crs");
+    writeMatrixMarket(sparseMatrix, marketFile.path());
+    writeBinaryCrs(sparseMatrix, binaryFile.path());
+
+    LoadStats marketStats{};
+    LoadStats binaryStats{};
+    SparseMatrix fromMarket{ readMatrixMarket(marketFile.path(), &marketStats) };
+    SparseMatrix fromBinary{ readBinaryCrs(binaryFile.path(), &binaryStats) };
+
+    std::cout << "Matrix Market: " << marketStats.bytes << " bytes, " << marketStats.seconds << " s, "
+              << marketStats.throughput() << " MB/s" << std::endl;
+    std::cout << "Binary CRS: " << binaryStats.bytes << " bytes, " << binaryStats.seconds << " s, "
+              << binaryStats.throughput() << " MB/s" << std::endl;
+    ASSERT_NEAR_SPARSE_MATRIX(sparseMatrix, fromMarket, 1e-12);
+    ASSERT_NEAR_SPARSE_MATRIX(sparseMatrix, fromBinary, 0.0);
+}
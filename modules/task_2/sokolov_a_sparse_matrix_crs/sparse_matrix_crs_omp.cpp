@@ -1,5 +1,19 @@
 // Copyright 2020 Sokolov Andrey
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include <omp.h>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
 #include "./sparse_matrix_crs_omp.h"
 
 
@@ -89,7 +103,62 @@ Matrix SparseMatrix::SparseToMatrix() {
     return result;
 }
 
-SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB) {
+namespace {
+
+// Row idx of matrixA * matrixB. tmpResult is zero on entry and on return,
+// mark holds no value of idx
+void multiplyRow(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int idx, double denseFill,
+                 std::vector<double>* tmpResult, std::vector<int>* mark, std::vector<int>* touched,
+                 std::vector<int>* resultCols, std::vector<double>* resultValue) {
+    double* row{tmpResult->data()};
+    int64_t products{0};
+    for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+        int tmpCol{matrixA.colIndex[jdx]};
+        products += matrixB.rowIndex[tmpCol + 1] - matrixB.rowIndex[tmpCol];
+    }
+
+    if (products >= denseFill * matrixB.cols) {
+        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+            int tmpCol{matrixA.colIndex[jdx]};
+            for (int kdx{matrixB.rowIndex[tmpCol]}; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
+                row[matrixB.colIndex[kdx]] += matrixA.value[jdx] * matrixB.value[kdx];
+            }
+        }
+        for (int kdx{0}; kdx < matrixB.cols; ++kdx) {
+            if (row[kdx] != 0.0) {
+                resultValue->push_back(row[kdx]);
+                resultCols->push_back(kdx);
+                row[kdx] = 0.0;
+            }
+        }
+        return;
+    }
+
+    touched->clear();
+    for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+        int tmpCol{matrixA.colIndex[jdx]};
+        for (int kdx{matrixB.rowIndex[tmpCol]}; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
+            int col{matrixB.colIndex[kdx]};
+            if ((*mark)[col] != idx) {
+                (*mark)[col] = idx;
+                touched->push_back(col);
+            }
+            row[col] += matrixA.value[jdx] * matrixB.value[kdx];
+        }
+    }
+    std::sort(touched->begin(), touched->end());
+    for (int col : *touched) {
+        if (row[col] != 0.0) {
+            resultValue->push_back(row[col]);
+            resultCols->push_back(col);
+        }
+        row[col] = 0.0;
+    }
+}
+
+}  // namespace
+
+SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB, double denseFill) {
     SparseMatrix result{};
     result.rows = matrixA.rows;
     result.cols = matrixB.cols;
@@ -97,32 +166,40 @@ SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matri
     result.colIndex = {};
     result.value = {};
     result.rowIndex.reserve(result.rows + 1);
-    result.colIndex.reserve(result.rows * result.cols);
-    result.value.reserve(result.rows * result.cols);
     result.rowIndex.push_back(0);
-    std::vector<double> tmpResultRow(matrixA.rows, 0);
+    std::vector<double> tmpResultRow(matrixB.cols, 0);
+    std::vector<int> mark(matrixB.cols, -1);
+    std::vector<int> touched{};
 
     for (int idx{ 0 }; idx < matrixA.rows; ++idx) {
-        for (int jdx{ matrixA.rowIndex[idx] }; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
-            int tmpCol{ matrixA.colIndex[jdx] };
-
-            for (int kdx{ matrixB.rowIndex[tmpCol] }; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
-                tmpResultRow[matrixB.colIndex[kdx]] += matrixA.value[jdx] * matrixB.value[kdx];
-            }
-        }
-        for (int kdx{ 0 }; kdx < matrixA.rows; ++kdx) {
-            if (tmpResultRow[kdx] != 0) {
-                result.value.push_back(tmpResultRow[kdx]);
-                result.colIndex.push_back(kdx);
-                tmpResultRow[kdx] = 0;
-            }
-        }
+        multiplyRow(matrixA, matrixB, idx, denseFill, &tmpResultRow, &mark, &touched,
+                    &result.colIndex, &result.value);
         result.rowIndex.push_back(result.value.size());
     }
     return result;
 }
 
-SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB) {
+std::vector<int> partitionRowsByFlops(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int parts) {
+    std::vector<int64_t> cost(matrixA.rows + 1, 0);
+    for (int idx{0}; idx < matrixA.rows; ++idx) {
+        int64_t rowCost{matrixB.cols};
+        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+            int tmpCol{matrixA.colIndex[jdx]};
+            rowCost += matrixB.rowIndex[tmpCol + 1] - matrixB.rowIndex[tmpCol];
+        }
+        cost[idx + 1] = cost[idx] + rowCost;
+    }
+
+    std::vector<int> bounds(parts + 1, matrixA.rows);
+    bounds[0] = 0;
+    for (int part{1}; part < parts; ++part) {
+        int64_t target{cost[matrixA.rows] * part / parts};
+        bounds[part] = std::lower_bound(cost.begin(), cost.end(), target) - cost.begin();
+    }
+    return bounds;
+}
+
+SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB, double denseFill) {
     constexpr int numThreads{4};
     omp_set_num_threads(numThreads);
 
@@ -133,23 +210,19 @@ SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& ma
     std::vector<int> tmpResultRow(matrixA.rows + 1, 0);
     std::vector<int>* tmpResultCols = new std::vector<int>[matrixA.rows];
     std::vector<double>* tmpResultValue = new std::vector<double>[matrixA.rows];
-    int tmpCol {0};
 
-#pragma omp parallel for default(shared) private(tmpCol)
-    for (int idx = 0; idx < matrixA.rows; ++idx) {
-        std::vector<double> tmpResult(matrixA.rows + 1, 0);
-        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
-            tmpCol = matrixA.colIndex[jdx];
-            for (int kdx{matrixB.rowIndex[tmpCol]}; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
-                tmpResult[matrixB.colIndex[kdx]] += matrixA.value[jdx] * matrixB.value[kdx];
-            }
-        }
-        for (int kdx{0}; kdx < matrixA.rows; ++kdx) {
-            if (tmpResult[kdx] != 0.0) {
-                tmpResultValue[idx].push_back(tmpResult[kdx]);
-                tmpResultCols[idx].push_back(kdx);
-                tmpResultRow[idx]++;
-            }
+    // One part per thread; a row costs its multiply-adds plus the scan of its result row
+    std::vector<int> bounds = partitionRowsByFlops(matrixA, matrixB, numThreads);
+
+#pragma omp parallel for schedule(static, 1)
+    for (int part = 0; part < numThreads; ++part) {
+        std::vector<double> tmpResult(matrixB.cols, 0);
+        std::vector<int> mark(matrixB.cols, -1);
+        std::vector<int> touched{};
+        for (int idx{bounds[part]}; idx < bounds[part + 1]; ++idx) {
+            multiplyRow(matrixA, matrixB, idx, denseFill, &tmpResult, &mark, &touched,
+                        &tmpResultCols[idx], &tmpResultValue[idx]);
+            tmpResultRow[idx] = tmpResultCols[idx].size();
         }
     }
 
@@ -179,6 +252,185 @@ SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& ma
     return result;
 }
 
+SellMatrix SparseToSell(const SparseMatrix& matrix, int sigma) {
+    if (sigma < 1) {
+        throw std::invalid_argument("Sigma must be positive");
+    }
+    SellMatrix result{};
+    result.rows = matrix.rows;
+    result.cols = matrix.cols;
+    result.sigma = sigma;
+    result.elemsCount = matrix.value.size();
+
+    auto rowLength = [&matrix](int row) { return matrix.rowIndex[row + 1] - matrix.rowIndex[row]; };
+    result.rowOrder.resize(matrix.rows);
+    for (int idx{0}; idx < matrix.rows; ++idx) {
+        result.rowOrder[idx] = idx;
+    }
+    for (int begin{0}; begin < matrix.rows; begin += sigma) {
+        int end{std::min(matrix.rows, begin + sigma)};
+        std::stable_sort(result.rowOrder.begin() + begin, result.rowOrder.begin() + end,
+                         [&rowLength](int lhs, int rhs) { return rowLength(lhs) > rowLength(rhs); });
+    }
+
+    int chunks{(matrix.rows + kSellChunk - 1) / kSellChunk};
+    result.chunkIndex.assign(chunks + 1, 0);
+    result.chunkLength.assign(chunks, 0);
+    for (int chunk{0}; chunk < chunks; ++chunk) {
+        for (int idx{chunk * kSellChunk}; idx < std::min(matrix.rows, (chunk + 1) * kSellChunk); ++idx) {
+            result.chunkLength[chunk] = std::max(result.chunkLength[chunk], rowLength(result.rowOrder[idx]));
+        }
+        result.chunkIndex[chunk + 1] = result.chunkIndex[chunk] + result.chunkLength[chunk] * kSellChunk;
+    }
+
+    // Padding points to column 0 with a zero value
+    result.colIndex.assign(result.chunkIndex[chunks], 0);
+    result.value.assign(result.chunkIndex[chunks], 0.0);
+    for (int idx{0}; idx < matrix.rows; ++idx) {
+        int row{result.rowOrder[idx]};
+        int pos{result.chunkIndex[idx / kSellChunk] + idx % kSellChunk};
+        for (int jdx{matrix.rowIndex[row]}; jdx < matrix.rowIndex[row + 1]; ++jdx, pos += kSellChunk) {
+            result.colIndex[pos] = matrix.colIndex[jdx];
+            result.value[pos] = matrix.value[jdx];
+        }
+    }
+    return result;
+}
+
+SpmvFormat chooseSpmvFormat(const SparseMatrix& matrix, int sigma) {
+    if (sigma < 1) {
+        throw std::invalid_argument("Sigma must be positive");
+    }
+    if (matrix.value.empty()) {
+        return SpmvFormat::Crs;
+    }
+    std::vector<int> length(matrix.rows);
+    for (int idx{0}; idx < matrix.rows; ++idx) {
+        length[idx] = matrix.rowIndex[idx + 1] - matrix.rowIndex[idx];
+    }
+    size_t padded{0};
+    for (int begin{0}; begin < matrix.rows; begin += sigma) {
+        int end{std::min(matrix.rows, begin + sigma)};
+        std::sort(length.begin() + begin, length.begin() + end, std::greater<int>());
+    }
+    for (int begin{0}; begin < matrix.rows; begin += kSellChunk) {
+        int end{std::min(matrix.rows, begin + kSellChunk)};
+        padded += static_cast<size_t>(*std::max_element(length.begin() + begin, length.begin() + end)) * kSellChunk;
+    }
+    double padding{static_cast<double>(padded) / matrix.value.size()};
+    return padding <= 1.25 ? SpmvFormat::Sell : SpmvFormat::Crs;
+}
+
+static std::vector<double> crsMatVec(int rows, int cols, const int* rowIndex, const int* colIndex,
+                                     const double* value, const std::vector<double>& x) {
+    if (static_cast<int>(x.size()) != cols) {
+        throw std::invalid_argument("Vector size does not match the matrix");
+    }
+    std::vector<double> y(rows);
+#pragma omp parallel for schedule(static)
+    for (int idx = 0; idx < rows; ++idx) {
+        double sum{0.0};
+        for (int jdx{rowIndex[idx]}; jdx < rowIndex[idx + 1]; ++jdx) {
+            sum += value[jdx] * x[colIndex[jdx]];
+        }
+        y[idx] = sum;
+    }
+    return y;
+}
+
+std::vector<double> SparseMatVecOmp(const SparseMatrix& matrix, const std::vector<double>& x) {
+    return crsMatVec(matrix.rows, matrix.cols, matrix.rowIndex.data(), matrix.colIndex.data(), matrix.value.data(),
+                     x);
+}
+
+std::vector<double> SparseMatVecOmp(const MappedCrs& matrix, const std::vector<double>& x) {
+    return crsMatVec(matrix.rows, matrix.cols, matrix.rowIndex, matrix.colIndex, matrix.value, x);
+}
+
+std::vector<double> SellMatVecOmp(const SellMatrix& matrix, const std::vector<double>& x) {
+    if (static_cast<int>(x.size()) != matrix.cols) {
+        throw std::invalid_argument("Vector size does not match the matrix");
+    }
+    std::vector<double> y(matrix.rows);
+    const int chunks = static_cast<int>(matrix.chunkLength.size());
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        double sum[kSellChunk] = {};
+        const int* col{matrix.colIndex.data() + matrix.chunkIndex[chunk]};
+        const double* val{matrix.value.data() + matrix.chunkIndex[chunk]};
+        for (int jdx{0}; jdx < matrix.chunkLength[chunk]; ++jdx) {
+            for (int lane{0}; lane < kSellChunk; ++lane) {
+                sum[lane] += val[jdx * kSellChunk + lane] * x[col[jdx * kSellChunk + lane]];
+            }
+        }
+        for (int lane{0}; lane < kSellChunk && chunk * kSellChunk + lane < matrix.rows; ++lane) {
+            y[matrix.rowOrder[chunk * kSellChunk + lane]] = sum[lane];
+        }
+    }
+    return y;
+}
+
+Matrix SparseMatDenseOmp(const SparseMatrix& matrix, const Matrix& x) {
+    if (static_cast<int>(x.size()) != matrix.cols) {
+        throw std::invalid_argument("Multi-vector size does not match the matrix");
+    }
+    const size_t vectors{x.empty() ? 0U : x[0].size()};
+    Matrix y(matrix.rows, std::vector<double>(vectors, 0.0));
+#pragma omp parallel for schedule(static)
+    for (int idx = 0; idx < matrix.rows; ++idx) {
+        double* yRow{y[idx].data()};
+        for (int jdx{matrix.rowIndex[idx]}; jdx < matrix.rowIndex[idx + 1]; ++jdx) {
+            const double a{matrix.value[jdx]};
+            const double* xRow{x[matrix.colIndex[jdx]].data()};
+            for (size_t vec{0U}; vec < vectors; ++vec) {
+                yRow[vec] += a * xRow[vec];
+            }
+        }
+    }
+    return y;
+}
+
+Matrix SellMatDenseOmp(const SellMatrix& matrix, const Matrix& x) {
+    if (static_cast<int>(x.size()) != matrix.cols) {
+        throw std::invalid_argument("Multi-vector size does not match the matrix");
+    }
+    const size_t vectors{x.empty() ? 0U : x[0].size()};
+    Matrix y(matrix.rows, std::vector<double>(vectors, 0.0));
+    const int chunks = static_cast<int>(matrix.chunkLength.size());
+#pragma omp parallel for schedule(dynamic, 16)
+    for (int chunk = 0; chunk < chunks; ++chunk) {
+        const int* col{matrix.colIndex.data() + matrix.chunkIndex[chunk]};
+        const double* val{matrix.value.data() + matrix.chunkIndex[chunk]};
+        for (int lane{0}; lane < kSellChunk && chunk * kSellChunk + lane < matrix.rows; ++lane) {
+            double* yRow{y[matrix.rowOrder[chunk * kSellChunk + lane]].data()};
+            for (int jdx{0}; jdx < matrix.chunkLength[chunk]; ++jdx) {
+                const double a{val[jdx * kSellChunk + lane]};
+                const double* xRow{x[col[jdx * kSellChunk + lane]].data()};
+                for (size_t vec{0U}; vec < vectors; ++vec) {
+                    yRow[vec] += a * xRow[vec];
+                }
+            }
+        }
+    }
+    return y;
+}
+
+SpmvOperator::SpmvOperator(const SparseMatrix& matrix, int sigma) : format_(chooseSpmvFormat(matrix, sigma)) {
+    if (format_ == SpmvFormat::Sell) {
+        sell_ = SparseToSell(matrix, sigma);
+    } else {
+        crs_ = matrix;
+    }
+}
+
+std::vector<double> SpmvOperator::apply(const std::vector<double>& x) const {
+    return format_ == SpmvFormat::Sell ? SellMatVecOmp(sell_, x) : SparseMatVecOmp(crs_, x);
+}
+
+Matrix SpmvOperator::apply(const Matrix& x) const {
+    return format_ == SpmvFormat::Sell ? SellMatDenseOmp(sell_, x) : SparseMatDenseOmp(crs_, x);
+}
+
 Matrix MatMul(const Matrix& matrixA, const Matrix& matrixB) {
     size_t rowsA = matrixA.size();
     size_t colsA = matrixA[0].size();
@@ -219,6 +471,23 @@ Matrix generateMatrix(const size_t& rows, const size_t& cols, const size_t& coef
     return result;
 }
 
+Matrix generatePowerLawMatrix(const size_t& rows, const size_t& cols, const size_t& maxRowElems) {
+    Matrix result(rows, std::vector<double>(cols, 0.0));
+
+    std::random_device rd{};
+    std::mt19937 mt {rd()};
+    std::uniform_real_distribution<double> disValue{ 1.0, 10.0 };
+    std::uniform_int_distribution<size_t> disCol {0, cols - 1};
+
+    for (size_t idx{0U}; idx < rows; ++idx) {
+        size_t elems{std::min(cols, std::max<size_t>(1U, maxRowElems / (idx + 1)))};
+        for (size_t count{0U}; count < elems; ++count) {
+            result[idx][disCol(mt)] = disValue(mt);
+        }
+    }
+    return result;
+}
+
 void SparseMatrix::printDefault() {
     std::cout << "Value:" << std::endl;
     for (size_t idx{ 0 }; idx < value.size(); ++idx) {
@@ -265,3 +534,356 @@ void print(const Matrix& matrix) {
     }
     std::cout << std::endl;
 }
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0), file_(nullptr), mapping_(nullptr) {
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    LARGE_INTEGER fileSize;
+    GetFileSizeEx(file_, &fileSize);
+    size_ = static_cast<size_t>(fileSize.QuadPart);
+    if (size_ > 0U) {
+        mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr) {
+            data_ = static_cast<const char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (data_ == nullptr) {
+            if (mapping_ != nullptr) {
+                CloseHandle(mapping_);
+            }
+            CloseHandle(file_);
+            throw std::runtime_error("Cannot map " + path);
+        }
+    }
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+    }
+    CloseHandle(file_);
+}
+#else
+MappedFile::MappedFile(const std::string& path) : data_(nullptr), size_(0) {
+    int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open " + path);
+    }
+    struct stat info{};
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw std::runtime_error("Cannot stat " + path);
+    }
+    size_ = static_cast<size_t>(info.st_size);
+    if (size_ > 0U) {
+        void* ptr{mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0)};
+        if (ptr == MAP_FAILED) {
+            close(fd);
+            throw std::runtime_error("Cannot map " + path);
+        }
+        data_ = static_cast<const char*>(ptr);
+    }
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+#endif
+
+namespace {
+
+struct MarketEntry {
+    int row;
+    int col;
+    double value;
+};
+
+const char* nextLine(const char* pos, const char* end) {
+    const void* eol{std::memchr(pos, '\n', end - pos)};
+    return eol != nullptr ? static_cast<const char*>(eol) + 1 : end;
+}
+
+// First line starting at or after pos
+const char* lineStart(const char* pos, const char* begin, const char* end) {
+    return (pos == begin || pos[-1] == '\n') ? pos : nextLine(pos, end);
+}
+
+bool isBlankOrComment(const std::string& line) {
+    size_t first{line.find_first_not_of(" \t\r\n")};
+    return first == std::string::npos || line[first] == '%';
+}
+
+std::string lowered(std::string word) {
+    std::transform(word.begin(), word.end(), word.begin(), [](char sym) { return static_cast<char>(tolower(sym)); });
+    return word;
+}
+
+constexpr char kBinaryMagic[8] = {'S', 'P', 'C', 'R', 'S', '0', '1', '\0'};
+
+struct BinaryHeader {
+    char magic[8];
+    int32_t rows;
+    int32_t cols;
+    int64_t elemsCount;
+};
+
+// Offsets of the arrays in a binary CRS file; values are 8-byte aligned
+struct BinaryLayout {
+    size_t rowIndex;
+    size_t colIndex;
+    size_t value;
+    size_t size;
+};
+
+BinaryLayout binaryLayout(int64_t rows, int64_t elemsCount) {
+    BinaryLayout layout{};
+    layout.rowIndex = sizeof(BinaryHeader);
+    layout.colIndex = layout.rowIndex + sizeof(int) * (rows + 1);
+    layout.value = (layout.colIndex + sizeof(int) * elemsCount + 7) / 8 * 8;
+    layout.size = layout.value + sizeof(double) * elemsCount;
+    return layout;
+}
+
+}  // namespace
+
+SparseMatrix readMatrixMarket(const std::string& path, LoadStats* stats) {
+    double start{omp_get_wtime()};
+    MappedFile file{path};
+    const char* begin{file.data()};
+    const char* end{begin + file.size()};
+
+    const char* pos{nextLine(begin, end)};
+    std::istringstream banner{std::string(begin, pos)};
+    std::string tag, object, format, field, symmetry;
+    banner >> tag >> object >> format >> field >> symmetry;
+    field = lowered(field);
+    symmetry = lowered(symmetry);
+    if (tag != "%%MatrixMarket" || lowered(object) != "matrix" || lowered(format) != "coordinate") {
+        throw std::runtime_error("Not a Matrix Market coordinate file: " + path);
+    }
+    if (field != "real" && field != "integer" && field != "pattern") {
+        throw std::runtime_error("Unsupported Matrix Market field: " + field);
+    }
+    if (symmetry != "general" && symmetry != "symmetric") {
+        throw std::runtime_error("Unsupported Matrix Market symmetry: " + symmetry);
+    }
+    const bool pattern{field == "pattern"};
+    const bool symmetric{symmetry == "symmetric"};
+
+    std::string line;
+    do {
+        if (pos == end) {
+            throw std::runtime_error("No size line in " + path);
+        }
+        const char* eol{nextLine(pos, end)};
+        line.assign(pos, eol);
+        pos = eol;
+    } while (isBlankOrComment(line));
+    int64_t rows{0}, cols{0}, entries{0};
+    std::istringstream sizes{line};
+    if (!(sizes >> rows >> cols >> entries) || rows < 0 || cols < 0 || entries < 0) {
+        throw std::runtime_error("Wrong size line in " + path);
+    }
+
+    // Every thread parses the lines starting in its share of the bytes
+    const char* data{pos};
+    int threads{omp_get_max_threads()};
+    std::vector<std::vector<MarketEntry>> parts(threads);
+    std::vector<int64_t> parsed(threads, 0);
+    bool failed{false};
+#pragma omp parallel num_threads(threads)
+    {
+        int thread{omp_get_thread_num()};
+        size_t length{static_cast<size_t>(end - data)};
+        const char* cur{lineStart(data + length * thread / threads, data, end)};
+        const char* last{lineStart(data + length * (thread + 1) / threads, data, end)};
+        std::vector<MarketEntry>& part{parts[thread]};
+        part.reserve(static_cast<size_t>(entries / threads + 1) * (symmetric ? 2 : 1));
+        std::string text;
+        while (cur < last) {
+            const char* eol{nextLine(cur, end)};
+            text.assign(cur, eol);
+            cur = eol;
+            if (isBlankOrComment(text)) {
+                continue;
+            }
+            char* tail{nullptr};
+            int64_t row{std::strtoll(text.c_str(), &tail, 10)};
+            int64_t col{std::strtoll(tail, &tail, 10)};
+            double value{pattern ? 1.0 : std::strtod(tail, &tail)};
+            if (row < 1 || row > rows || col < 1 || col > cols) {
+#pragma omp atomic write
+                failed = true;
+                break;
+            }
+            ++parsed[thread];
+            part.push_back({static_cast<int>(row - 1), static_cast<int>(col - 1), value});
+            if (symmetric && row != col) {
+                part.push_back({static_cast<int>(col - 1), static_cast<int>(row - 1), value});
+            }
+        }
+    }
+    int64_t total{0};
+    for (int64_t count : parsed) {
+        total += count;
+    }
+    if (failed || total != entries) {
+        throw std::runtime_error("Wrong entries in " + path);
+    }
+
+    size_t elemsCount{0U};
+    for (const auto& part : parts) {
+        elemsCount += part.size();
+    }
+    SparseMatrix result(rows, cols, elemsCount);
+    std::fill(result.rowIndex.begin(), result.rowIndex.end(), 0);
+    for (const auto& part : parts) {
+        for (const MarketEntry& entry : part) {
+            ++result.rowIndex[entry.row + 1];
+        }
+    }
+    for (int64_t idx{0}; idx < rows; ++idx) {
+        result.rowIndex[idx + 1] += result.rowIndex[idx];
+    }
+
+    // Scatter in file order, then sort every row by columns
+    std::vector<int> fill(result.rowIndex.begin(), result.rowIndex.end() - 1);
+    for (const auto& part : parts) {
+        for (const MarketEntry& entry : part) {
+            int dst{fill[entry.row]++};
+            result.colIndex[dst] = entry.col;
+            result.value[dst] = entry.value;
+        }
+    }
+#pragma omp parallel
+    {
+        std::vector<std::pair<int, double>> row;
+#pragma omp for schedule(dynamic, 256)
+        for (int idx = 0; idx < static_cast<int>(rows); ++idx) {
+            row.clear();
+            for (int jdx{result.rowIndex[idx]}; jdx < result.rowIndex[idx + 1]; ++jdx) {
+                row.emplace_back(result.colIndex[jdx], result.value[jdx]);
+            }
+            std::sort(row.begin(), row.end(),
+                      [](const std::pair<int, double>& lhs, const std::pair<int, double>& rhs) {
+                          return lhs.first < rhs.first;
+                      });
+            for (size_t jdx{0U}; jdx < row.size(); ++jdx) {
+                result.colIndex[result.rowIndex[idx] + jdx] = row[jdx].first;
+                result.value[result.rowIndex[idx] + jdx] = row[jdx].second;
+            }
+        }
+    }
+
+    if (stats != nullptr) {
+        stats->bytes = file.size();
+        stats->seconds = omp_get_wtime() - start;
+    }
+    return result;
+}
+
+void writeMatrixMarket(const SparseMatrix& matrix, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        throw std::runtime_error("Cannot create " + path);
+    }
+    out << "%%MatrixMarket matrix coordinate real general\n";
+    out << matrix.rows << ' ' << matrix.cols << ' ' << matrix.value.size() << '\n';
+    out << std::setprecision(17);
+    for (int idx{0}; idx < matrix.rows; ++idx) {
+        for (int jdx{matrix.rowIndex[idx]}; jdx < matrix.rowIndex[idx + 1]; ++jdx) {
+            out << idx + 1 << ' ' << matrix.colIndex[jdx] + 1 << ' ' << matrix.value[jdx] << '\n';
+        }
+    }
+}
+
+void writeBinaryCrs(const SparseMatrix& matrix, const std::string& path) {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Cannot create " + path);
+    }
+    BinaryHeader header{};
+    std::memcpy(header.magic, kBinaryMagic, sizeof(kBinaryMagic));
+    header.rows = matrix.rows;
+    header.cols = matrix.cols;
+    header.elemsCount = static_cast<int64_t>(matrix.value.size());
+    BinaryLayout layout{binaryLayout(header.rows, header.elemsCount)};
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(matrix.rowIndex.data()), sizeof(int) * (matrix.rows + 1));
+    out.write(reinterpret_cast<const char*>(matrix.colIndex.data()), sizeof(int) * matrix.colIndex.size());
+    const char padding[8] = {};
+    out.write(padding, layout.value - layout.colIndex - sizeof(int) * matrix.colIndex.size());
+    out.write(reinterpret_cast<const char*>(matrix.value.data()), sizeof(double) * matrix.value.size());
+}
+
+MappedCrs::MappedCrs(const std::string& path) : file_(path) {
+    BinaryHeader header{};
+    if (file_.size() < sizeof(header)) {
+        throw std::runtime_error("Not a binary CRS file: " + path);
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (std::memcmp(header.magic, kBinaryMagic, sizeof(kBinaryMagic)) != 0 || header.rows < 0 || header.cols < 0 ||
+        header.elemsCount < 0) {
+        throw std::runtime_error("Not a binary CRS file: " + path);
+    }
+    BinaryLayout layout{binaryLayout(header.rows, header.elemsCount)};
+    if (file_.size() != layout.size) {
+        throw std::runtime_error("Truncated binary CRS file: " + path);
+    }
+    rows = header.rows;
+    cols = header.cols;
+    elemsCount = static_cast<size_t>(header.elemsCount);
+    rowIndex = reinterpret_cast<const int*>(file_.data() + layout.rowIndex);
+    colIndex = reinterpret_cast<const int*>(file_.data() + layout.colIndex);
+    value = reinterpret_cast<const double*>(file_.data() + layout.value);
+
+    // The products index x and the arrays by these, so a corrupt file is
+    // rejected here rather than read out of bounds later
+    if (rowIndex[0] != 0 || rowIndex[rows] != header.elemsCount) {
+        throw std::runtime_error("Corrupt binary CRS file: " + path);
+    }
+    int64_t wrong{0};
+#pragma omp parallel for schedule(static) reduction(+ : wrong)
+    for (int idx = 0; idx < rows; ++idx) {
+        wrong += rowIndex[idx] > rowIndex[idx + 1];
+    }
+    const int64_t elems{header.elemsCount};
+#pragma omp parallel for schedule(static) reduction(+ : wrong)
+    for (int64_t jdx = 0; jdx < elems; ++jdx) {
+        wrong += colIndex[jdx] < 0 || colIndex[jdx] >= cols;
+    }
+    if (wrong != 0) {
+        throw std::runtime_error("Corrupt binary CRS file: " + path);
+    }
+}
+
+SparseMatrix readBinaryCrs(const std::string& path, LoadStats* stats) {
+    double start{omp_get_wtime()};
+    MappedCrs view{path};
+    SparseMatrix result(view.rows, view.cols, view.elemsCount);
+    std::copy(view.rowIndex, view.rowIndex + view.rows + 1, result.rowIndex.begin());
+
+    // Page faults of the mapping are taken by all threads at once
+    const int64_t elems{static_cast<int64_t>(view.elemsCount)};
+    const int64_t block{1 << 16};
+#pragma omp parallel for schedule(static)
+    for (int64_t first = 0; first < elems; first += block) {
+        int64_t last{std::min(elems, first + block)};
+        std::copy(view.colIndex + first, view.colIndex + last, result.colIndex.begin() + first);
+        std::copy(view.value + first, view.value + last, result.value.begin() + first);
+    }
+
+    if (stats != nullptr) {
+        stats->bytes = binaryLayout(view.rows, elems).size;
+        stats->seconds = omp_get_wtime() - start;
+    }
+    return result;
+}
@@ -2,12 +2,16 @@
 #ifndef MODULES_TASK_2_SOKOLOV_A_SPARSE_MATRIX_CRS_SPARSE_MATRIX_CRS_OMP_H_
 #define MODULES_TASK_2_SOKOLOV_A_SPARSE_MATRIX_CRS_SPARSE_MATRIX_CRS_OMP_H_
 #include <memory.h>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
 #include <random>
 #include <utility>
 #include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 using Matrix = std::vector<std::vector<double>>;
@@ -35,16 +39,133 @@ class SparseMatrix {
      void printDefault();
      void printMatrix();
 
-     friend SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
-     friend SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
+     friend SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB, double denseFill);
+     friend SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB, double denseFill);
 };
 
-SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
-SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
+// SELL-C-sigma storage: rows are sorted by length inside windows of sigma
+// rows and cut into chunks of kSellChunk rows; a chunk is padded to its
+// longest row and stored column by column, so the kSellChunk rows of a
+// chunk are processed together in unit-stride, vectorizable loops
+constexpr int kSellChunk{8};
+
+struct SellMatrix {
+    int rows;
+    int cols;
+    int sigma;
+    std::vector<int> chunkIndex;  // Index of the beginning of each chunk
+    std::vector<int> chunkLength;  // Length of the longest row of each chunk
+    std::vector<int> rowOrder;  // Original row of each sorted row
+    std::vector<int> colIndex;
+    std::vector<double> value;
+    size_t elemsCount;  // Nonzeros without padding
+};
+
+SellMatrix SparseToSell(const SparseMatrix& matrix, int sigma = 256);
+
+enum class SpmvFormat { Crs, Sell };
+
+// SELL pays off when the sorted chunks need little padding; with very
+// irregular rows the padding would cost more than the vectorization saves
+SpmvFormat chooseSpmvFormat(const SparseMatrix& matrix, int sigma = 256);
+
+// y = A * x and Y = A * X for a dense multi-vector X (cols x k)
+std::vector<double> SparseMatVecOmp(const SparseMatrix& matrix, const std::vector<double>& x);
+std::vector<double> SellMatVecOmp(const SellMatrix& matrix, const std::vector<double>& x);
+Matrix SparseMatDenseOmp(const SparseMatrix& matrix, const Matrix& x);
+Matrix SellMatDenseOmp(const SellMatrix& matrix, const Matrix& x);
+
+// Converts the matrix once to the format chosen by chooseSpmvFormat and
+// reuses it for every product
+class SpmvOperator {
+ public:
+    explicit SpmvOperator(const SparseMatrix& matrix, int sigma = 256);
+    SpmvFormat format() const { return format_; }
+    std::vector<double> apply(const std::vector<double>& x) const;
+    Matrix apply(const Matrix& x) const;
+
+ private:
+    SpmvFormat format_;
+    SparseMatrix crs_;
+    SellMatrix sell_;
+};
+
+// A result row that gets at least denseFill * matrixB.cols products is
+// accumulated in a dense row that is scanned whole, sparser rows keep the
+// list of touched columns and sort it. Both add the same products in the
+// same order, so the results are bit-identical for any denseFill.
+// Measured by DISABLED_Test_Dense_Accumulator_Threshold
+constexpr double kDenseRowFill{0.06};
+
+SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB,
+                          double denseFill = kDenseRowFill);
+SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB,
+                             double denseFill = kDenseRowFill);
+// Splits the rows of matrixA into parts contiguous ranges of about the same
+// cost in matrixA * matrixB (multiply-adds plus the scan of the result row),
+// returns parts + 1 row bounds
+std::vector<int> partitionRowsByFlops(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int parts);
 Matrix MatMul(const Matrix& matrixA, const Matrix& matrixB);
 
 Matrix generateMatrix(const size_t& rows, const size_t& cols, const size_t& coeff);
+// Row idx has about maxRowElems / (idx + 1) elements, so the first rows are
+// much heavier than the rest
+Matrix generatePowerLawMatrix(const size_t& rows, const size_t& cols, const size_t& maxRowElems);
 
 void print(const Matrix& matrix);
 
+// Read-only memory mapping of a whole file
+class MappedFile {
+ public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    const char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+ private:
+    const char* data_;
+    size_t size_;
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#endif
+};
+
+struct LoadStats {
+    size_t bytes;
+    double seconds;
+    double throughput() const { return seconds > 0.0 ? bytes / seconds / 1e6 : 0.0; }  // MB/s
+};
+
+// Matrix Market coordinate files (real, integer or pattern; general or
+// symmetric). The file is mapped and its lines are parsed by all threads
+SparseMatrix readMatrixMarket(const std::string& path, LoadStats* stats = nullptr);
+void writeMatrixMarket(const SparseMatrix& matrix, const std::string& path);
+
+// Native binary CRS: a header of rows, cols and the number of elements,
+// then rowIndex, colIndex and value as they are laid out in memory
+void writeBinaryCrs(const SparseMatrix& matrix, const std::string& path);
+SparseMatrix readBinaryCrs(const std::string& path, LoadStats* stats = nullptr);
+
+// Zero-copy view of a binary CRS file; the arrays point into the mapping
+class MappedCrs {
+ public:
+    explicit MappedCrs(const std::string& path);
+
+    int rows;
+    int cols;
+    size_t elemsCount;
+    const int* rowIndex;
+    const int* colIndex;
+    const double* value;
+
+ private:
+    MappedFile file_;
+};
+
+std::vector<double> SparseMatVecOmp(const MappedCrs& matrix, const std::vector<double>& x);
+
 #endif  // MODULES_TASK_2_SOKOLOV_A_SPARSE_MATRIX_CRS_SPARSE_MATRIX_CRS_OMP_H_
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <utility>
 #include <cmath>
+#include <numeric>
+#include <cstdint>
 #include "../../../modules/task_2/vdovin_e_crs_mat_mult/crs_mat_mult.h"
 
 CRSMatrix::CRSMatrix(const int n_, const int nz_,
@@ -57,36 +59,92 @@ CRSMatrix CRSMatrix::operator*(const CRSMatrix &mtx) const {
 }
 
 CRSMatrix CRSMatrix::transpose() const {
-    CRSMatrix at(n, nz);
-
-    for (int i = 0; i < nz; ++i) {
-        at.rowindex[col[i] + 1]++;
-    }
+    CRSMatrix at;
+    transpose(&at);
+    return at;
+}
 
-    int s = 0;
-    for (int i = 1; i <= n; ++i) {
-        int tmp = at.rowindex[i];
-        at.rowindex[i] = s;
-        s = s + tmp;
-    }
+void CRSMatrix::transpose(CRSMatrix* at) const {
+    // Per-thread column counts, a prefix sum, then an in-order scatter of each thread's rows
+    static thread_local std::vector<int> counters;
+    at->n = n;
+    at->nz = nz;
+    at->value.resize(nz);
+    at->col.resize(nz);
+    at->rowindex.resize(n + 1);
+    counters.assign(omp_k * n, 0);
+    int* counts = counters.data();
+
+    #pragma omp parallel num_threads(omp_k)
+    {
+        int tid = omp_get_thread_num();
+        int threads = omp_get_num_threads();
+        int first = static_cast<int>(static_cast<int64_t>(n) * tid / threads);
+        int last = static_cast<int>(static_cast<int64_t>(n) * (tid + 1) / threads);
+        int* own = counts + tid * n;
+
+        for (int i = first; i < last; ++i) {
+            for (int j = rowindex[i]; j < rowindex[i + 1]; ++j) {
+                own[col[j]]++;
+            }
+        }
+        #pragma omp barrier
 
-    for (int i = 0; i < n; ++i) {
-        int j1 = rowindex[i], j2 = rowindex[i + 1];
-        int c = i;
+        #pragma omp for schedule(static)
+        for (int c = 0; c < n; ++c) {
+            int s = 0;
+            for (int t = 0; t < threads; ++t) {
+                s += counts[t * n + c];
+            }
+            at->rowindex[c + 1] = s;
+        }
 
-        for (int j = j1; j < j2; ++j) {
-            std::complex<double> v = value[j];
+        #pragma omp single
+        {
+            at->rowindex[0] = 0;
+            for (int c = 0; c < n; ++c) {
+                at->rowindex[c + 1] += at->rowindex[c];
+            }
+        }
 
-            int rindex = col[j];
-            int iindex = at.rowindex[rindex + 1];
+        #pragma omp for schedule(static)
+        for (int c = 0; c < n; ++c) {
+            int pos = at->rowindex[c];
+            for (int t = 0; t < threads; ++t) {
+                int tmp = counts[t * n + c];
+                counts[t * n + c] = pos;
+                pos += tmp;
+            }
+        }
 
-            at.value[iindex] = v;
-            at.col[iindex] = c;
-            at.rowindex[rindex + 1]++;
+        for (int i = first; i < last; ++i) {
+            for (int j = rowindex[i]; j < rowindex[i + 1]; ++j) {
+                int iindex = own[col[j]]++;
+                at->value[iindex] = value[j];
+                at->col[iindex] = i;
+            }
         }
     }
+}
 
-    return at;
+std::vector<int> CRSMatrix::partitionRowsByCost(const CRSMatrix &mtx, int parts) const {
+    // Every row clears its index map; a non-empty row then walks all the
+    // rows of mtx, so the work does not depend on its length much, but
+    // empty rows are almost free
+    std::vector<int64_t> cost(n + 1, 0);
+    int64_t mtxNz = mtx.rowindex[mtx.n];
+    for (int i = 0; i < n; ++i) {
+        int len = rowindex[i + 1] - rowindex[i];
+        cost[i + 1] = cost[i] + n + len + (len != 0 ? mtx.n + mtxNz : 0);
+    }
+
+    std::vector<int> bounds(parts + 1, n);
+    bounds[0] = 0;
+    for (int part = 1; part < parts; ++part) {
+        int64_t target = cost[n] * part / parts;
+        bounds[part] = std::lower_bound(cost.begin(), cost.end(), target) - cost.begin();
+    }
+    return bounds;
 }
 
 CRSMatrix CRSMatrix::multiplicate(const CRSMatrix &mtx) const {
@@ -95,58 +153,44 @@ CRSMatrix CRSMatrix::multiplicate(const CRSMatrix &mtx) const {
         std::vector<std::vector<int>> col_res(n);
         std::vector<int> rownz(n + 1);
 
+        // One part per thread; an empty row only resets tmp, any other row walks all of mtx
+        std::vector<int> bounds = partitionRowsByCost(mtx, omp_k);
+
         #pragma omp parallel num_threads(omp_k)
         {
             std::vector<int> tmp(n + 1);
-            int numThread = omp_get_thread_num();
-            int numThreads = omp_get_num_threads();
-            int delta, begin, end;
-
-            if (numThreads > n) {
-                delta = 1;
-            } else {
-                if (n / 2 < n % numThreads) {
-                    delta = n / numThreads + 1;
-                } else {
-                    delta = n / numThreads;
-                }
-            }
-
-            begin = numThread * delta;
 
-            if (numThread < numThreads - 1) {
-                end = (numThread + 1) * delta;
-            } else {
-                end = n;
-            }
-            for (int i = begin; i < end; ++i) {
-                std::fill(tmp.begin(), tmp.end(), -1);
+            #pragma omp for schedule(static, 1)
+            for (int part = 0; part < omp_k; ++part) {
+                for (int i = bounds[part]; i < bounds[part + 1]; ++i) {
+                    std::fill(tmp.begin(), tmp.end(), -1);
 
-                int ks = rowindex[i];
-                int kf = rowindex[i + 1];
+                    int ks = rowindex[i];
+                    int kf = rowindex[i + 1];
 
-                for (int m = ks; m < kf; ++m) {
-                    tmp[col[m]] = m;
-                }
+                    for (int m = ks; m < kf; ++m) {
+                        tmp[col[m]] = m;
+                    }
 
-                if (ks != kf) {
-                    for (int j = 0; j < n; ++j) {
-                        std::complex<double> sum(0.0, 0.0);
+                    if (ks != kf) {
+                        for (int j = 0; j < n; ++j) {
+                            std::complex<double> sum(0.0, 0.0);
 
-                        int ls = mtx.rowindex[j];
-                        int lf = mtx.rowindex[j + 1];
+                            int ls = mtx.rowindex[j];
+                            int lf = mtx.rowindex[j + 1];
 
-                        for (int k = ls; k < lf; ++k) {
-                            int ind = tmp[mtx.col[k]];
-                            if (ind != -1) {
-                                sum += value[ind] * mtx.value[k];
+                            for (int k = ls; k < lf; ++k) {
+                                int ind = tmp[mtx.col[k]];
+                                if (ind != -1) {
+                                    sum += value[ind] * mtx.value[k];
+                                }
                             }
-                        }
 
-                        if (sqrt(sum.real() * sum.real() + sum.imag() * sum.imag()) > 0.000000001) {
-                            col_res[i].push_back(j);
-                            value_res[i].push_back(sum);
-                            rownz[i]++;
+                            if (sqrt(sum.real() * sum.real() + sum.imag() * sum.imag()) > 0.000000001) {
+                                col_res[i].push_back(j);
+                                value_res[i].push_back(sum);
+                                rownz[i]++;
+                            }
                         }
                     }
                 }
@@ -183,6 +227,143 @@ CRSMatrix CRSMatrix::multiplicate(const CRSMatrix &mtx) const {
     }
 }
 
+std::vector<std::complex<double>> CRSMatrix::multiplyVector(const std::vector<std::complex<double>> &x) const {
+    return multiplyVectors(x, 1);
+}
+
+std::vector<std::complex<double>> CRSMatrix::multiplyVectors(const std::vector<std::complex<double>> &x,
+                                                             int k) const {
+    if (k < 1 || static_cast<int>(x.size()) != n * k) {
+        return std::vector<std::complex<double>>();
+    }
+    std::vector<std::complex<double>> y(n * k);
+
+    #pragma omp parallel for num_threads(omp_k) schedule(static)
+    for (int i = 0; i < n; ++i) {
+        std::complex<double>* yi = &y[i * k];
+        for (int m = rowindex[i]; m < rowindex[i + 1]; ++m) {
+            const std::complex<double> a = value[m];
+            const std::complex<double>* xj = &x[col[m] * k];
+            for (int v = 0; v < k; ++v) {
+                yi[v] += a * xj[v];
+            }
+        }
+    }
+    return y;
+}
+
+// Rows sorted by length inside windows of sigma rows
+static std::vector<int> sortedRows(const std::vector<int> &rowindex, int n, int sigma) {
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    for (int s = 0; s < n; s += sigma) {
+        std::stable_sort(perm.begin() + s, perm.begin() + std::min(n, s + sigma), [&rowindex](int a, int b) {
+            return rowindex[a + 1] - rowindex[a] > rowindex[b + 1] - rowindex[b];
+        });
+    }
+    return perm;
+}
+
+bool CRSMatrix::prefersSELL(int sigma) const {
+    int nnz = rowindex[n];
+    if (nnz == 0 || sigma < 1) {
+        return false;
+    }
+    std::vector<int> perm = sortedRows(rowindex, n, sigma);
+    int64_t padded = 0;
+    for (int c = 0; c * SELLMatrix::C < n; ++c) {
+        int len = 0;
+        for (int i = c * SELLMatrix::C; i < std::min(n, (c + 1) * SELLMatrix::C); ++i) {
+            len = std::max(len, rowindex[perm[i] + 1] - rowindex[perm[i]]);
+        }
+        padded += static_cast<int64_t>(len) * SELLMatrix::C;
+    }
+    return padded * 4 <= static_cast<int64_t>(nnz) * 5;
+}
+
+SELLMatrix::SELLMatrix(const CRSMatrix &mtx, int sigma) {
+    n = mtx.n;
+    omp_k = 1;
+    perm = sortedRows(mtx.rowindex, n, std::max(1, sigma));
+
+    int chunks = (n + C - 1) / C;
+    chunkptr.assign(chunks + 1, 0);
+    chunklen.assign(chunks, 0);
+    for (int c = 0; c < chunks; ++c) {
+        for (int i = c * C; i < std::min(n, (c + 1) * C); ++i) {
+            chunklen[c] = std::max(chunklen[c], mtx.rowindex[perm[i] + 1] - mtx.rowindex[perm[i]]);
+        }
+        chunkptr[c + 1] = chunkptr[c] + chunklen[c] * C;
+    }
+
+    // padding multiplies a zero by x[0]
+    value.assign(chunkptr[chunks], std::complex<double>(0.0, 0.0));
+    col.assign(chunkptr[chunks], 0);
+    for (int i = 0; i < n; ++i) {
+        int pos = chunkptr[i / C] + i % C;
+        for (int m = mtx.rowindex[perm[i]]; m < mtx.rowindex[perm[i] + 1]; ++m, pos += C) {
+            value[pos] = mtx.value[m];
+            col[pos] = mtx.col[m];
+        }
+    }
+}
+
+void SELLMatrix::getThreads(int numTreads) {
+    omp_k = numTreads;
+}
+
+std::vector<std::complex<double>> SELLMatrix::multiplyVector(const std::vector<std::complex<double>> &x) const {
+    if (static_cast<int>(x.size()) != n) {
+        return std::vector<std::complex<double>>();
+    }
+    std::vector<std::complex<double>> y(n);
+    int chunks = static_cast<int>(chunklen.size());
+
+    #pragma omp parallel for num_threads(omp_k) schedule(dynamic, 16)
+    for (int c = 0; c < chunks; ++c) {
+        // real and imaginary parts apart, so the lanes vectorize
+        double re[C] = {}, im[C] = {};
+        for (int j = 0; j < chunklen[c]; ++j) {
+            int base = chunkptr[c] + j * C;
+            for (int r = 0; r < C; ++r) {
+                const std::complex<double> a = value[base + r];
+                const std::complex<double> b = x[col[base + r]];
+                re[r] += a.real() * b.real() - a.imag() * b.imag();
+                im[r] += a.real() * b.imag() + a.imag() * b.real();
+            }
+        }
+        for (int r = 0; r < C && c * C + r < n; ++r) {
+            y[perm[c * C + r]] = std::complex<double>(re[r], im[r]);
+        }
+    }
+    return y;
+}
+
+std::vector<std::complex<double>> SELLMatrix::multiplyVectors(const std::vector<std::complex<double>> &x,
+                                                              int k) const {
+    if (k < 1 || static_cast<int>(x.size()) != n * k) {
+        return std::vector<std::complex<double>>();
+    }
+    std::vector<std::complex<double>> y(n * k);
+    int chunks = static_cast<int>(chunklen.size());
+
+    #pragma omp parallel for num_threads(omp_k) schedule(dynamic, 16)
+    for (int c = 0; c < chunks; ++c) {
+        for (int r = 0; r < C && c * C + r < n; ++r) {
+            std::complex<double>* yi = &y[perm[c * C + r] * k];
+            for (int j = 0; j < chunklen[c]; ++j) {
+                int pos = chunkptr[c] + j * C + r;
+                const std::complex<double> a = value[pos];
+                const std::complex<double>* xj = &x[col[pos] * k];
+                for (int v = 0; v < k; ++v) {
+                    yi[v] += a * xj[v];
+                }
+            }
+        }
+    }
+    return y;
+}
+
 bool CRSMatrix::findElemInVector(const std::vector<std::pair<int, std::complex<double>>>& vec, const int elem) {
     for (auto& elemVec : vec) {
         if (elem == elemVec.first) {
@@ -247,3 +428,62 @@ bool CRSMatrix::operator==(const CRSMatrix &mtx) const {
 bool CRSMatrix::operator!=(const CRSMatrix &mtx) const {
     return !(*this == mtx);
 }
+
+CRSSplitMatrix::CRSSplitMatrix(const CRSMatrix &mtx) : n(mtx.n), nz(mtx.nz), omp_k(mtx.omp_k),
+    re(mtx.value.size()), im(mtx.value.size()), col(mtx.col), rowindex(mtx.rowindex) {
+    for (size_t m = 0; m < mtx.value.size(); ++m) {
+        re[m] = mtx.value[m].real();
+        im[m] = mtx.value[m].imag();
+    }
+}
+
+CRSMatrix CRSSplitMatrix::toCRS() const {
+    std::vector<std::complex<double>> value(re.size());
+    for (size_t m = 0; m < re.size(); ++m) {
+        value[m] = std::complex<double>(re[m], im[m]);
+    }
+    return CRSMatrix(n, nz, value, col, rowindex);
+}
+
+void CRSSplitMatrix::getThreads(int numTreads) {
+    omp_k = numTreads;
+}
+
+std::vector<std::complex<double>> CRSSplitMatrix::multiplyVectors(const std::vector<std::complex<double>> &x,
+                                                                  int k) const {
+    if (k < 1 || static_cast<int>(x.size()) != n * k) {
+        return std::vector<std::complex<double>>();
+    }
+    std::vector<double> xre(n * k), xim(n * k);
+    std::vector<std::complex<double>> y(n * k);
+
+    #pragma omp parallel num_threads(omp_k)
+    {
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n * k; ++i) {
+            xre[i] = x[i].real();
+            xim[i] = x[i].imag();
+        }
+
+        std::vector<double> yre(k), yim(k);
+        #pragma omp for schedule(static)
+        for (int i = 0; i < n; ++i) {
+            std::fill(yre.begin(), yre.end(), 0.0);
+            std::fill(yim.begin(), yim.end(), 0.0);
+            for (int m = rowindex[i]; m < rowindex[i + 1]; ++m) {
+                const double are = re[m], aim = im[m];
+                const double* xjre = &xre[col[m] * k];
+                const double* xjim = &xim[col[m] * k];
+                #pragma omp simd
+                for (int v = 0; v < k; ++v) {
+                    yre[v] += are * xjre[v] - aim * xjim[v];
+                    yim[v] += are * xjim[v] + aim * xjre[v];
+                }
+            }
+            for (int v = 0; v < k; ++v) {
+                y[i * k + v] = std::complex<double>(yre[v], yim[v]);
+            }
+        }
+    }
+    return y;
+}
@@ -11,8 +11,15 @@
 #include <algorithm>
 #include <utility>
 #include <numeric>
+#include <cstdint>
+
+class SELLMatrix;
+class CRSSplitMatrix;
 
 class CRSMatrix {
+    friend class SELLMatrix;
+    friend class CRSSplitMatrix;
+
     int n;
     int nz;
     int omp_k;
@@ -36,11 +43,76 @@ class CRSMatrix {
     CRSMatrix operator*(const CRSMatrix &mtx) const;
     CRSMatrix& operator=(const CRSMatrix &mtx);
     CRSMatrix transpose() const;
+    // Parallel transpose on omp_k threads into at, reusing its memory
+    void transpose(CRSMatrix* at) const;
     void buildRandomCRSMatrix();
     void getThreads(int numTreads);
+    // Splits the rows into parts contiguous ranges of about the same cost in
+    // the product with the transposed matrix mtx, where empty rows are cheap
+    // and every other row costs a pass over mtx; returns parts + 1 row bounds
+    std::vector<int> partitionRowsByCost(const CRSMatrix &mtx, int parts) const;
+
+    // y = A * x, and Y = A * X for k vectors stored row by row (X is n x k);
+    // an empty result means the sizes do not match
+    std::vector<std::complex<double>> multiplyVector(const std::vector<std::complex<double>> &x) const;
+    std::vector<std::complex<double>> multiplyVectors(const std::vector<std::complex<double>> &x, int k) const;
+    // true if the rows are regular enough for SELLMatrix to beat the CRS
+    // kernels: the padding of its chunks stays within a quarter of nz
+    bool prefersSELL(int sigma = 256) const;
 
     bool operator==(const CRSMatrix &mtx) const;
     bool operator!=(const CRSMatrix &mtx) const;
 };
 
+// SELL-C-sigma copy of a CRSMatrix: rows are sorted by length within
+// windows of sigma rows, cut into chunks of C rows, and every chunk is
+// padded to its longest row and stored column by column, so the C rows of
+// a chunk are multiplied together in unit-stride loops
+class SELLMatrix {
+ public:
+    static const int C = 8;
+
+    explicit SELLMatrix(const CRSMatrix &mtx, int sigma = 256);
+
+    std::vector<std::complex<double>> multiplyVector(const std::vector<std::complex<double>> &x) const;
+    std::vector<std::complex<double>> multiplyVectors(const std::vector<std::complex<double>> &x, int k) const;
+    void getThreads(int numTreads);
+    // stored elements, padding included
+    int storedSize() const { return static_cast<int>(value.size()); }
+
+ private:
+    int n;
+    int omp_k;
+
+    std::vector<int> chunkptr;
+    std::vector<int> chunklen;
+    std::vector<int> perm;
+    std::vector<std::complex<double>> value;
+    std::vector<int> col;
+};
+
+// CRSMatrix with the real and imaginary parts of the values in two arrays.
+// multiplyVectors splits X the same way, so the loop over the k vectors is
+// plain double multiply-adds on unit-stride arrays, which vectorize, where
+// the std::complex product of CRSMatrix::multiplyVectors does not
+class CRSSplitMatrix {
+ public:
+    explicit CRSSplitMatrix(const CRSMatrix &mtx);
+
+    CRSMatrix toCRS() const;
+    // Same as CRSMatrix::multiplyVectors, x and the result are converted
+    std::vector<std::complex<double>> multiplyVectors(const std::vector<std::complex<double>> &x, int k) const;
+    void getThreads(int numTreads);
+
+ private:
+    int n;
+    int nz;
+    int omp_k;
+
+    std::vector<double> re;
+    std::vector<double> im;
+    std::vector<int> col;
+    std::vector<int> rowindex;
+};
+
 #endif  // MODULES_TASK_2_VDOVIN_E_CRS_MAT_MULT_CRS_MAT_MULT_H_
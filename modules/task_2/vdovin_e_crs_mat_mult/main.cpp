@@ -54,6 +54,21 @@ TEST(CRSMatrix, test_transpose) {
   EXPECT_EQ(at, a.transpose());
 }
 
+TEST(CRSMatrix, test_transpose_threads) {
+  CRSMatrix a(50, 300);
+  a.buildRandomCRSMatrix();
+  CRSMatrix at = a.transpose();
+
+  CRSMatrix att;
+  for (int threads : { 2, 3, 8 }) {
+    a.getThreads(threads);
+    a.transpose(&att);
+    EXPECT_EQ(at, att);
+    att.getThreads(threads);
+    EXPECT_EQ(a, att.transpose());
+  }
+}
+
 TEST(CRSMatrix, test_multiplicate) {
   std::vector<std::complex<double>> vm = { 1, 2, 32, 20, 35, 5, 64, 70, 42, 27, 28, 36 };
   std::vector<int> cm = { 0, 4, 3, 5, 1, 2, 3, 5, 1, 2, 3, 5 };
@@ -70,6 +85,133 @@ TEST(CRSMatrix, test_multiplicate) {
   EXPECT_EQ(ab, a * b);
 }
 
+// rows below n / 2 are empty, the others have a few elements
+CRSMatrix halfEmptyMatrix(int n) {
+  std::vector<std::complex<double>> v;
+  std::vector<int> c;
+  std::vector<int> r = { 0 };
+  for (int i = 0; i < n; ++i) {
+    if (i >= n / 2) {
+      for (int j = i % 3; j < n; j += 7) {
+        c.push_back(j);
+        v.push_back(std::complex<double>(i % 5 + 1, j % 3));
+      }
+    }
+    r.push_back(c.size());
+  }
+  return CRSMatrix(n, c.size(), v, c, r);
+}
+
+TEST(CRSMatrix, test_partition_rows_by_cost) {
+  CRSMatrix a = halfEmptyMatrix(40);
+  std::vector<int> bounds = a.partitionRowsByCost(a.transpose(), 4);
+
+  ASSERT_EQ(5u, bounds.size());
+  EXPECT_EQ(0, bounds[0]);
+  EXPECT_EQ(40, bounds[4]);
+  for (int part = 0; part < 4; ++part) {
+    EXPECT_LE(bounds[part], bounds[part + 1]);
+  }
+  // the empty half is almost free, so it goes to the first part
+  EXPECT_GE(bounds[1], 20);
+}
+
+TEST(CRSMatrix, test_multiplicate_threads) {
+  CRSMatrix a = halfEmptyMatrix(40);
+  CRSMatrix b(40, 200);
+  b.buildRandomCRSMatrix();
+
+  CRSMatrix seq = a * b;
+  a.getThreads(4);
+  b.getThreads(4);
+
+  EXPECT_EQ(seq, a * b);
+}
+
+TEST(CRSMatrix, test_multiply_vector) {
+  std::vector<std::complex<double>> v = { 1, 2, 3, 4, 8, 5, 7, 1, 6 };
+  std::vector<int> c = { 0, 4, 2, 3, 3, 5, 1, 2, 5 };
+  std::vector<int> r = { 0, 2, 4, 4, 6, 6, 9 };
+  std::vector<std::complex<double>> x = { 1, { 0, 1 }, 2, { 1, -1 }, 3, 1 };
+  std::vector<std::complex<double>> ax = { 7, { 10, -4 }, 0, { 13, -8 }, 0, { 8, 7 } };
+
+  CRSMatrix a(6, 9, v, c, r);
+  SELLMatrix sell(a, 4);
+
+  EXPECT_EQ(ax, a.multiplyVector(x));
+  EXPECT_EQ(ax, sell.multiplyVector(x));
+  EXPECT_TRUE(a.multiplyVector(std::vector<std::complex<double>>(5)).empty());
+  EXPECT_TRUE(sell.multiplyVector(std::vector<std::complex<double>>(5)).empty());
+}
+
+TEST(CRSMatrix, test_multiply_vectors) {
+  CRSMatrix a = halfEmptyMatrix(45);
+  std::vector<std::complex<double>> x(45 * 3);
+  for (int i = 0; i < 45 * 3; ++i) {
+    x[i] = std::complex<double>(i % 7, 1 - i % 4);
+  }
+  a.getThreads(4);
+  SELLMatrix sell(a, 16);
+  sell.getThreads(4);
+
+  std::vector<std::complex<double>> y = a.multiplyVectors(x, 3);
+  std::vector<std::complex<double>> ys = sell.multiplyVectors(x, 3);
+  ASSERT_EQ(45u * 3, y.size());
+  ASSERT_EQ(y, ys);
+  for (int j = 0; j < 3; ++j) {
+    std::vector<std::complex<double>> xj(45);
+    for (int i = 0; i < 45; ++i) {
+      xj[i] = x[i * 3 + j];
+    }
+    std::vector<std::complex<double>> yj = sell.multiplyVector(xj);
+    for (int i = 0; i < 45; ++i) {
+      EXPECT_NEAR(0.0, std::abs(yj[i] - y[i * 3 + j]), 1e-9);
+    }
+  }
+}
+
+TEST(CRSMatrix, test_split_multiply_vectors) {
+  CRSMatrix a = halfEmptyMatrix(45);
+  CRSSplitMatrix split(a);
+  EXPECT_EQ(a, split.toCRS());
+
+  std::vector<std::complex<double>> x(45 * 5);
+  for (int i = 0; i < 45 * 5; ++i) {
+    x[i] = std::complex<double>(i % 7, 1 - i % 4);
+  }
+  std::vector<std::complex<double>> y = a.multiplyVectors(x, 5);
+  split.getThreads(4);
+  std::vector<std::complex<double>> ys = split.multiplyVectors(x, 5);
+  ASSERT_EQ(y.size(), ys.size());
+  for (int i = 0; i < 45 * 5; ++i) {
+    EXPECT_NEAR(0.0, std::abs(y[i] - ys[i]), 1e-9);
+  }
+  EXPECT_TRUE(split.multiplyVectors(x, 4).empty());
+  EXPECT_TRUE(split.multiplyVectors(x, 0).empty());
+}
+
+TEST(CRSMatrix, test_prefers_sell) {
+  // the rows of halfEmptyMatrix have close lengths once sorted
+  CRSMatrix a = halfEmptyMatrix(80);
+  EXPECT_TRUE(a.prefersSELL());
+
+  // one full row and single elements: sorting cannot hide the long row
+  std::vector<std::complex<double>> v(80 + 79, 1);
+  std::vector<int> c;
+  std::vector<int> r = { 0 };
+  for (int j = 0; j < 80; ++j) {
+    c.push_back(j);
+  }
+  r.push_back(80);
+  for (int i = 1; i < 80; ++i) {
+    c.push_back(i);
+    r.push_back(80 + i);
+  }
+  CRSMatrix b(80, v.size(), v, c, r);
+  EXPECT_FALSE(b.prefersSELL());
+  EXPECT_EQ(8 * 80 + 9 * 8, SELLMatrix(b).storedSize());
+}
+
 /*TEST(CRSMatrix, test_build) {
     CRSMatrix a(20000, 100000);
     CRSMatrix b(20000, 100000);
@@ -3,6 +3,7 @@
 #include <gtest/gtest.h>
 #include <omp.h>
 
+#include <iostream>
 #include <vector>
 
 #include "./strassen_mult_openmp.h"
@@ -10,13 +11,15 @@
 void multSeq(unsigned int size, const double* a, const double* b,
              double* result);
 void strassen1(unsigned int size, const double* a1, const double* a2,
-               const double* b1, const double* b2, double* result);
+               const double* b1, const double* b2, double* result,
+               int taskDepth);
 void strassen2(unsigned int size, const double* a1, const double* a2,
-               const double* b, double* result);
+               const double* b, double* result, int taskDepth);
 void strassen3(unsigned int size, const double* a, const double* b1,
-               const double* b2, double* result);
+               const double* b2, double* result, int taskDepth);
 void strassen4(unsigned int size, const double* a1, const double* a2,
-               const double* b1, const double* b2, double* result);
+               const double* b1, const double* b2, double* result,
+               int taskDepth);
 unsigned int nextPowerOf2(unsigned int number);
 
 TEST(Helper_Functions, Next_power_of_2) {
@@ -58,7 +61,8 @@ TEST(Helper_Functions, Strassen1) {
     }
   }
 
-  strassen1(kSize, a1.data(), a2.data(), b1.data(), b2.data(), result.data());
+  strassen1(kSize, a1.data(), a2.data(), b1.data(), b2.data(), result.data(),
+            0);
 
   ASSERT_EQ(expected, result);
 }
@@ -86,7 +90,7 @@ TEST(Helper_Functions, Strassen2) {
     }
   }
 
-  strassen2(kSize, a1.data(), a2.data(), b.data(), result.data());
+  strassen2(kSize, a1.data(), a2.data(), b.data(), result.data(), 0);
 
   ASSERT_EQ(expected, result);
 }
@@ -114,7 +118,7 @@ TEST(Helper_Functions, Strassen3) {
     }
   }
 
-  strassen3(kSize, a.data(), b1.data(), b2.data(), result.data());
+  strassen3(kSize, a.data(), b1.data(), b2.data(), result.data(), 0);
 
   ASSERT_EQ(expected, result);
 }
@@ -144,7 +148,8 @@ TEST(Helper_Functions, Strassen4) {
     }
   }
 
-  strassen4(kSize, a1.data(), a2.data(), b1.data(), b2.data(), result.data());
+  strassen4(kSize, a1.data(), a2.data(), b1.data(), b2.data(), result.data(),
+            0);
 
   ASSERT_EQ(expected, result);
 }
@@ -257,6 +262,50 @@ TEST(Parallel, Matrix_256x256) {
   ASSERT_EQ(resultExpected, result);
 }
 
+TEST(Parallel, Same_Result_For_Any_Task_Depth) {
+  const unsigned int kSize = 256;
+  std::vector<double> a(kSize * kSize);
+  std::vector<double> b(kSize * kSize);
+  std::vector<double> result(kSize * kSize);
+  std::vector<double> resultExpected(kSize * kSize);
+
+  for (unsigned int i = 0; i < kSize * kSize; i++) {
+    a[i] = (i % 17) - 8.0;
+    b[i] = (i % 13) - 6.0;
+  }
+  multSeq(kSize, a.data(), b.data(), resultExpected.data());
+
+  for (int depth = 0; depth <= 3; depth++) {
+    strassenMultOmp(kSize, a.data(), b.data(), result.data(), depth);
+    ASSERT_EQ(resultExpected, result);
+  }
+}
+
+TEST(Parallel, Throws_On_Negative_Task_Depth) {
+  std::vector<double> a(4 * 4), b(4 * 4), result(4 * 4);
+
+  ASSERT_ANY_THROW(strassenMultOmp(4, a.data(), b.data(), result.data(), -1));
+}
+
+TEST(Parallel, DISABLED_Task_Depth_1024x1024) {
+  const unsigned int kSize = 1024;
+  std::vector<double> a(kSize * kSize);
+  std::vector<double> b(kSize * kSize);
+  std::vector<double> result(kSize * kSize);
+
+  for (unsigned int i = 0; i < kSize * kSize; i++) {
+    a[i] = i + 1;
+    b[i] = kSize * kSize - i;
+  }
+
+  for (int depth = 0; depth <= 3; depth++) {
+    double start = omp_get_wtime();
+    strassenMultOmp(kSize, a.data(), b.data(), result.data(), depth);
+    double end = omp_get_wtime();
+    std::cout << "Task depth " << depth << ": " << end - start << std::endl;
+  }
+}
+
 TEST(Parallel, DISABLED_Matrix_512x512) {
   const unsigned int kSize = 512;
   std::vector<double> a(kSize * kSize);
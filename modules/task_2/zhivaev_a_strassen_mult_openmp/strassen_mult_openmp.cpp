@@ -9,7 +9,7 @@
 #include <string>
 
 void strassenMultRecursive(unsigned int size, const double* a, const double* b,
-                           double* result);
+                           double* result, int taskDepth);
 
 void multSeq(unsigned int side, const double* a, const double* b,
              double* result) {
@@ -65,7 +65,8 @@ void assembleMatrix(unsigned int size, double* a, const double* a11,
 
 // (A1 + A2)(B1 + B2)
 void strassen1(unsigned int size, const double* a1, const double* a2,
-               const double* b1, const double* b2, double* result) {
+               const double* b1, const double* b2, double* result,
+               int taskDepth) {
   double* t1 = new double[size * size * 2];
   double* t2 = t1 + size * size;
   int i;
@@ -76,14 +77,14 @@ void strassen1(unsigned int size, const double* a1, const double* a2,
     t2[i] = b1[i] + b2[i];
   }
 
-  multSeq(size, t1, t2, result);
+  strassenMultRecursive(size, t1, t2, result, taskDepth);
 
   delete[] t1;
 }
 
 // (A1 + A2)B
 void strassen2(unsigned int size, const double* a1, const double* a2,
-               const double* b, double* result) {
+               const double* b, double* result, int taskDepth) {
   double* t = new double[size * size];
   int i;
   int length = size * size;
@@ -92,14 +93,14 @@ void strassen2(unsigned int size, const double* a1, const double* a2,
     t[i] = a1[i] + a2[i];
   }
 
-  multSeq(size, t, b, result);
+  strassenMultRecursive(size, t, b, result, taskDepth);
 
   delete[] t;
 }
 
 // A(B1 - B2)
 void strassen3(unsigned int size, const double* a, const double* b1,
-               const double* b2, double* result) {
+               const double* b2, double* result, int taskDepth) {
   double* t = new double[size * size];
   int i;
   int length = size * size;
@@ -108,14 +109,15 @@ void strassen3(unsigned int size, const double* a, const double* b1,
     t[i] = b1[i] - b2[i];
   }
 
-  multSeq(size, a, t, result);
+  strassenMultRecursive(size, a, t, result, taskDepth);
 
   delete[] t;
 }
 
 // (A1 - A2)(B1 + B2)
 void strassen4(unsigned int size, const double* a1, const double* a2,
-               const double* b1, const double* b2, double* result) {
+               const double* b1, const double* b2, double* result,
+               int taskDepth) {
   double* t1 = new double[size * size * 2];
   double* t2 = t1 + size * size;
   int i;
@@ -126,13 +128,13 @@ void strassen4(unsigned int size, const double* a1, const double* a2,
     t2[i] = b1[i] + b2[i];
   }
 
-  multSeq(size, t1, t2, result);
+  strassenMultRecursive(size, t1, t2, result, taskDepth);
 
   delete[] t1;
 }
 
 void strassenMultRecursive(unsigned int size, const double* a, const double* b,
-                           double* result) {
+                           double* result, int taskDepth) {
   if (size <= 32) {
     multSeq(size, a, b, result);
     return;
@@ -163,36 +165,37 @@ void strassenMultRecursive(unsigned int size, const double* a, const double* b,
   splitMatrix(size, a, a11, a12, a21, a22);
   splitMatrix(size, b, b11, b12, b21, b22);
 
-#pragma omp parallel sections shared(a11, a12, a21, a22, b11, b12, b21, b22)
-  {
-// M1 = (A11 + A22)(B11 + B22)
-#pragma omp section
-    { strassen1(size / 2, a11, a22, b11, b22, m1); }
+  // While taskDepth > 0 the seven products are deferred tasks that idle
+  // threads pick up; deeper down the if clause makes them run in place
+  // M1 = (A11 + A22)(B11 + B22)
+#pragma omp task if (taskDepth > 0)
+  strassen1(size / 2, a11, a22, b11, b22, m1, taskDepth - 1);
 
-// M2 = (A21 + A22)B11
-#pragma omp section
-    { strassen2(size / 2, a21, a22, b11, m2); }
+  // M2 = (A21 + A22)B11
+#pragma omp task if (taskDepth > 0)
+  strassen2(size / 2, a21, a22, b11, m2, taskDepth - 1);
 
-// M3 = A11(B12 - B22)
-#pragma omp section
-    { strassen3(size / 2, a11, b12, b22, m3); }
+  // M3 = A11(B12 - B22)
+#pragma omp task if (taskDepth > 0)
+  strassen3(size / 2, a11, b12, b22, m3, taskDepth - 1);
 
-// M4 = A22(B21 - B11)
-#pragma omp section
-    { strassen3(size / 2, a22, b21, b11, m4); }
+  // M4 = A22(B21 - B11)
+#pragma omp task if (taskDepth > 0)
+  strassen3(size / 2, a22, b21, b11, m4, taskDepth - 1);
 
-// M5 = (A11 + A12)B22
-#pragma omp section
-    { strassen2(size / 2, a11, a12, b22, m5); }
+  // M5 = (A11 + A12)B22
+#pragma omp task if (taskDepth > 0)
+  strassen2(size / 2, a11, a12, b22, m5, taskDepth - 1);
 
-// M6 = (A21 - A11)(B11 + B12)
-#pragma omp section
-    { strassen4(size / 2, a21, a11, b11, b12, m6); }
+  // M6 = (A21 - A11)(B11 + B12)
+#pragma omp task if (taskDepth > 0)
+  strassen4(size / 2, a21, a11, b11, b12, m6, taskDepth - 1);
 
-// M7 = (A12 - A22)(B21 + B22)
-#pragma omp section
-    { strassen4(size / 2, a12, a22, b21, b22, m7); }
-  }
+  // M7 = (A12 - A22)(B21 + B22)
+#pragma omp task if (taskDepth > 0)
+  strassen4(size / 2, a12, a22, b21, b22, m7, taskDepth - 1);
+
+#pragma omp taskwait
 
 // C11 = M1 + M4 - M5 + M7
   for (i = 0; i < qLength; i++) {
@@ -239,11 +242,16 @@ unsigned int nextPowerOf2(unsigned int number) {
 }
 
 void strassenMultOmp(unsigned int size, const double* a, const double* b,
-                     double* result) {
+                     double* result, int taskDepth) {
   if (powerOf2(size) < 0) {
     std::ostringstream stringStream;
     stringStream << "Size " << size << " is not power of 2";
     throw std::invalid_argument(stringStream.str());
   }
-  strassenMultRecursive(size, a, b, result);
+  if (taskDepth < 0) {
+    throw std::invalid_argument("Task depth must not be negative");
+  }
+#pragma omp parallel
+#pragma omp single
+  strassenMultRecursive(size, a, b, result, taskDepth);
 }
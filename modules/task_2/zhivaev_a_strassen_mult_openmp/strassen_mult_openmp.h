@@ -3,7 +3,9 @@
 #ifndef MODULES_TASK_2_ZHIVAEV_A_STRASSEN_MULT_OPENMP_STRASSEN_MULT_OPENMP_H_
 #define MODULES_TASK_2_ZHIVAEV_A_STRASSEN_MULT_OPENMP_STRASSEN_MULT_OPENMP_H_
 
+// The seven sub-products are spawned as OpenMP tasks for the first taskDepth
+// levels of the recursion and computed in place below that
 void strassenMultOmp(unsigned int size, const double* a, const double* b,
-                     double* result);
+                     double* result, int taskDepth = 2);
 
 #endif  // MODULES_TASK_2_ZHIVAEV_A_STRASSEN_MULT_OPENMP_STRASSEN_MULT_OPENMP_H_
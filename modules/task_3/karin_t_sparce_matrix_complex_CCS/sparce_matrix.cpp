@@ -8,6 +8,7 @@
 #include <iostream>
 #include <complex>
 #include <algorithm>
+#include <cstdint>
 #include "../../../modules/task_3/karin_t_sparce_matrix_complex_CCS/sparce_matrix.h"
 
 SparceMatrix::SparceMatrix(int _nCol, int _nRow) {
@@ -117,26 +118,70 @@ SparceMatrix::SparceMatrix(int _nCol, int _nRow, std::vector<std::complex<int>>
 
 SparceMatrix SparceMatrix::Transpose() const {
   SparceMatrix Tr(this->nRow, this->nCol);
-  std::vector<std::vector<int>> matr(nRow);
-  std::vector<int> cols;
-  int iter = 0;
-  for (unsigned i = 0; i < row_number.size(); i++) {
-    while ((static_cast<int>(i) >= point[iter]) && (iter != nCol-1))
-      iter++;
-    matr[row_number[i]].push_back(i);
-    cols.push_back(iter);
-  }
-  Tr.point[0] = matr[0].size();
-  for (int i = 1; i < nRow; i++)
-    Tr.point[i] = Tr.point[i-1] + matr[i].size();
-  for (int i = 0; i < nRow; i++)
-    for (unsigned j = 0; j < matr[i].size(); j++) {
-      Tr.val.push_back(val[matr[i][j]]);
-      Tr.row_number.push_back(cols[matr[i][j]]);
-    }
+  Transpose(&Tr);
   return Tr;
 }
 
+void SparceMatrix::Transpose(SparceMatrix* Tr) const {
+  // Per-part row counts, a prefix sum, then an in-order scatter of each part's columns
+  static thread_local std::vector<int> counters;
+  const int parts = std::max(1, std::min(nCol, tbb::task_scheduler_init::default_num_threads()));
+  const int not_null = val.size();
+  const int rows = nRow;
+  Tr->nCol = nRow;
+  Tr->nRow = nCol;
+  Tr->point.resize(nRow);
+  Tr->val.resize(not_null);
+  Tr->row_number.resize(not_null);
+  counters.assign(static_cast<size_t>(parts) * rows, 0);
+  int* count = counters.data();
+  int* tr_point = Tr->point.data();
+  auto part_first = [&](int part) { return static_cast<int>(static_cast<int64_t>(nCol) * part / parts); };
+  // the last column runs to the end of val, as in ScalarMult
+  auto col_start = [&](int j) { return (j == 0) ? 0 : point[j - 1]; };
+  auto col_stop = [&](int j) { return (j == nCol - 1) ? not_null : point[j]; };
+
+  tbb::parallel_for(tbb::blocked_range<int>(0, parts, 1), [&](const tbb::blocked_range<int>& r) {
+    for (int part = r.begin(); part < r.end(); part++) {
+      int* own = count + static_cast<size_t>(part) * rows;
+      for (int j = part_first(part); j < part_first(part + 1); j++)
+        for (int k = col_start(j); k < col_stop(j); k++)
+          own[row_number[k]]++;
+    }
+  });
+  tbb::parallel_for(tbb::blocked_range<int>(0, rows), [&](const tbb::blocked_range<int>& r) {
+    for (int i = r.begin(); i < r.end(); i++) {
+      int total = 0;
+      for (int part = 0; part < parts; part++)
+        total += count[static_cast<size_t>(part) * rows + i];
+      tr_point[i] = total;
+    }
+  });
+  for (int i = 0; i < rows - 1; i++)
+    tr_point[i + 1] += tr_point[i];
+  tbb::parallel_for(tbb::blocked_range<int>(0, rows), [&](const tbb::blocked_range<int>& r) {
+    for (int i = r.begin(); i < r.end(); i++) {
+      int pos = (i == 0) ? 0 : tr_point[i - 1];
+      for (int part = 0; part < parts; part++) {
+        int row_count = count[static_cast<size_t>(part) * rows + i];
+        count[static_cast<size_t>(part) * rows + i] = pos;
+        pos += row_count;
+      }
+    }
+  });
+  tbb::parallel_for(tbb::blocked_range<int>(0, parts, 1), [&](const tbb::blocked_range<int>& r) {
+    for (int part = r.begin(); part < r.end(); part++) {
+      int* own = count + static_cast<size_t>(part) * rows;
+      for (int j = part_first(part); j < part_first(part + 1); j++)
+        for (int k = col_start(j); k < col_stop(j); k++) {
+          int pos = own[row_number[k]]++;
+          Tr->val[pos] = val[k];
+          Tr->row_number[pos] = j;
+        }
+    }
+  });
+}
+
 SparceMatrix SparceMatrix::operator*(const SparceMatrix& B) {
   if (this->nRow != B.nCol)
     throw "wrong matrix size";
@@ -17,6 +17,8 @@ struct SparceMatrix {
   SparceMatrix(int _nCol, int _nRow, std::vector<std::complex<int>> _val,
     std::vector<int> _row_number, std::vector<int> _point);
   SparceMatrix Transpose() const;
+  // Writes the transpose into Tr, reusing the memory it already holds
+  void Transpose(SparceMatrix* Tr) const;
   SparceMatrix operator*(const SparceMatrix &MB);
   bool operator==(const SparceMatrix& SP) const;
   void Print();
@@ -1,8 +1,10 @@
 // Copyright 2020 Maximova Irina
 #include "../../../modules/task_3/maximova_i_dijkstra_algorithm/dijkstra_algorithm.h"
 #include <tbb/tbb.h>
+#include <atomic>
 #include <ctime>
 #include <iomanip>
+#include <memory>
 #include <random>
 #include <stdexcept>
 #include <utility>
@@ -50,36 +52,127 @@ void Graph::createRandGraph() {
   numEdges = numEdgesNow;
 }
 
+static bool atomicMin(std::atomic<int>* target, int value) {
+  int current = target->load(std::memory_order_relaxed);
+  while (value < current)
+    if (target->compare_exchange_weak(current, value, std::memory_order_relaxed))
+      return true;
+  return false;
+}
+
 std::vector<int> TBB_Dijkstra_Alg(const Graph& graph, int sourceVertex) {
   int count_vertex = graph.getNumVertex();
   int cur_vertex;
   int cur_dist;
-  tbb::mutex mutex;
-  std::vector<int> dist(count_vertex, INT8_MAX);
+  std::unique_ptr<std::atomic<int>[]> dist(new std::atomic<int>[count_vertex]);
   std::priority_queue<std::pair<int, int>> queue;
+  tbb::enumerable_thread_specific<std::vector<std::pair<int, int>>> candidates;
 
-  dist[sourceVertex] = 0;
+  for (int v = 0; v < count_vertex; ++v) dist[v].store(INT8_MAX);
+  dist[sourceVertex].store(0);
   queue.push(std::make_pair(0, sourceVertex));
   while (!queue.empty()) {
     cur_vertex = queue.top().second;
     cur_dist = (-1) * queue.top().first;
     queue.pop();
-    if (cur_dist > dist[cur_vertex]) continue;
+    if (cur_dist > dist[cur_vertex].load(std::memory_order_relaxed)) continue;
 
     tbb::parallel_for(
         tbb::blocked_range<int>(0, count_vertex),
         [&](const tbb::blocked_range<int>& r) {
+          std::vector<std::pair<int, int>>& local = candidates.local();
           for (int v = r.begin(); v != r.end(); ++v) {
             int dist_curV_V = graph[cur_vertex * count_vertex + v];
-            if (dist[cur_vertex] + dist_curV_V < dist[v]) {
-              dist[v] = dist[cur_vertex] + dist_curV_V;
-              std::pair<int, int> pair = std::make_pair((-1) * dist[v], v);
-              mutex.lock();
-              queue.push(pair);
-              mutex.unlock();
-            }
+            if (dist_curV_V == INT8_MAX) continue;
+            if (atomicMin(&dist[v], cur_dist + dist_curV_V))
+              local.push_back(std::make_pair((-1) * (cur_dist + dist_curV_V), v));
           }
         });
+
+    for (auto& local : candidates) {
+      for (const auto& candidate : local) queue.push(candidate);
+      local.clear();
+    }
+  }
+
+  std::vector<int> result(count_vertex);
+  for (int v = 0; v < count_vertex; ++v) result[v] = dist[v].load();
+  return result;
+}
+
+static void relaxRequests(const Graph& graph, const std::vector<int>& vertices,
+                          int delta, bool light, const std::vector<int>& dist,
+                          std::vector<std::pair<int, int>>* requests) {
+  int count_vertex = graph.getNumVertex();
+  tbb::enumerable_thread_specific<std::vector<std::pair<int, int>>> local;
+
+  tbb::parallel_for(
+      tbb::blocked_range<int>(0, static_cast<int>(vertices.size())),
+      [&](const tbb::blocked_range<int>& r) {
+        std::vector<std::pair<int, int>>& buffer = local.local();
+        for (int i = r.begin(); i != r.end(); ++i) {
+          int u = vertices[i];
+          int dist_u = dist[u];
+          for (int v = 0; v < count_vertex; ++v) {
+            int weight = graph[u * count_vertex + v];
+            if (v == u || weight == INT8_MAX || (weight <= delta) != light)
+              continue;
+            if (dist_u + weight < dist[v])
+              buffer.push_back(std::make_pair(v, dist_u + weight));
+          }
+        }
+      });
+
+  local.combine_each([&](const std::vector<std::pair<int, int>>& buffer) {
+    requests->insert(requests->end(), buffer.begin(), buffer.end());
+  });
+}
+
+std::vector<int> TBB_Delta_Stepping_Alg(const Graph& graph, int sourceVertex,
+                                        int delta) {
+  if (delta <= 0) throw std::runtime_error("Delta must be > 0");
+  int count_vertex = graph.getNumVertex();
+  if (sourceVertex < 0 || sourceVertex >= count_vertex)
+    throw std::runtime_error("Wrong source vertex");
+
+  std::vector<int> dist(count_vertex, INT8_MAX);
+  std::vector<std::vector<int>> buckets(INT8_MAX / delta + 1);
+  std::vector<int> bucket_mark(count_vertex, -1);
+  std::vector<std::pair<int, int>> requests;
+  dist[sourceVertex] = 0;
+  buckets[0].push_back(sourceVertex);
+
+  for (int i = 0; i < static_cast<int>(buckets.size()); ++i) {
+    std::vector<int> settled;
+    while (!buckets[i].empty()) {
+      std::vector<int> frontier;
+      std::vector<int> current;
+      frontier.swap(buckets[i]);
+      for (int v : frontier)
+        if (dist[v] / delta == i) {
+          current.push_back(v);
+          if (bucket_mark[v] != i) {
+            bucket_mark[v] = i;
+            settled.push_back(v);
+          }
+        }
+
+      requests.clear();
+      relaxRequests(graph, current, delta, true, dist, &requests);
+      for (const auto& request : requests)
+        if (request.second < dist[request.first]) {
+          dist[request.first] = request.second;
+          buckets[request.second / delta].push_back(request.first);
+        }
+    }
+
+    requests.clear();
+    relaxRequests(graph, settled, delta, false, dist, &requests);
+    for (const auto& request : requests)
+      if (request.second < dist[request.first]) {
+        dist[request.first] = request.second;
+        buckets[request.second / delta].push_back(request.first);
+      }
   }
 
   return dist;
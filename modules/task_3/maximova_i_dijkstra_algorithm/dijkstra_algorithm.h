@@ -21,5 +21,8 @@ class Graph {
 };
 
 std::vector<int> TBB_Dijkstra_Alg(const Graph& graph, int sourceVertex);
+// Bucketed (delta-stepping) SSSP, returns the same distances as TBB_Dijkstra_Alg
+std::vector<int> TBB_Delta_Stepping_Alg(const Graph& graph, int sourceVertex,
+                                        int delta = 25);
 
 #endif  // MODULES_TASK_3_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
@@ -1,5 +1,7 @@
 // Copyright 2020 Maximova Irina
 #include <gtest/gtest.h>
+#include <tbb/tbb.h>
+#include <iostream>
 #include <vector>
 #include "./dijkstra_algorithm.h"
 
@@ -94,6 +96,107 @@ TEST(Dijkstra_Algorithm_TBB, Test_Execute_Dijkstra_Alg_Unlinked_Graph) {
   ASSERT_EQ(algRes, currentRes);
 }
 
+TEST(Dijkstra_Algorithm_TBB, Test_Delta_Stepping_Linked_Graph) {
+  int numVertex = 5;
+  int numEdges = 5;
+  int sourceVertex = 1;
+
+  Graph graph(numVertex, numEdges);
+  graph.putEdge(0, 1, 3);
+  graph.putEdge(4, 1, 2);
+  graph.putEdge(4, 2, 1);
+  graph.putEdge(4, 3, 1);
+  graph.putEdge(3, 2, 4);
+  std::vector<int> algRes = TBB_Delta_Stepping_Alg(graph, sourceVertex, 2);
+  std::vector<int> currentRes = {3, 0, 3, 3, 2};
+
+  ASSERT_EQ(algRes, currentRes);
+}
+
+TEST(Dijkstra_Algorithm_TBB, Test_Delta_Stepping_Error_Wrong_Delta) {
+  Graph graph(5, 4);
+
+  ASSERT_ANY_THROW(TBB_Delta_Stepping_Alg(graph, 0, 0));
+}
+
+TEST(Dijkstra_Algorithm_TBB, Test_Delta_Stepping_Equals_Dijkstra) {
+  int numVertex = 150;
+  int numEdges = 600;
+  int sourceVertex = 3;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> dijkstraRes = TBB_Dijkstra_Alg(graph, sourceVertex);
+
+  for (int delta : {1, 7, 25, 100, 200})
+    ASSERT_EQ(dijkstraRes, TBB_Delta_Stepping_Alg(graph, sourceVertex, delta));
+}
+
+TEST(Dijkstra_Algorithm_TBB, DISABLED_Test_Delta_Stepping_Time) {
+  int numVertex = 3000;
+  int numEdges = 24000;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+
+  tbb::tick_count start = tbb::tick_count::now();
+  std::vector<int> dijkstraRes = TBB_Dijkstra_Alg(graph, sourceVertex);
+  double timeDijkstra = (tbb::tick_count::now() - start).seconds();
+
+  start = tbb::tick_count::now();
+  std::vector<int> deltaRes = TBB_Delta_Stepping_Alg(graph, sourceVertex);
+  double timeDelta = (tbb::tick_count::now() - start).seconds();
+
+  std::cout << "Dijkstra: " << timeDijkstra << std::endl
+            << "Delta-stepping: " << timeDelta << std::endl;
+
+  ASSERT_EQ(dijkstraRes, deltaRes);
+}
+
+TEST(Dijkstra_Algorithm_TBB, Test_Dijkstra_Alg_Does_Not_Depend_On_Threads) {
+  int numVertex = 150;
+  int numEdges = 600;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> oneThreadRes;
+  {
+    tbb::task_scheduler_init init(1);
+    oneThreadRes = TBB_Dijkstra_Alg(graph, sourceVertex);
+  }
+  tbb::task_scheduler_init init(4);
+
+  ASSERT_EQ(oneThreadRes, TBB_Dijkstra_Alg(graph, sourceVertex));
+}
+
+TEST(Dijkstra_Algorithm_TBB, DISABLED_Test_Dijkstra_Alg_Scaling) {
+  int numVertex = 3000;
+  int numEdges = 24000;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> oneThreadRes;
+  double oneThreadTime = 0;
+
+  for (int threads : {1, 2, 4, 8, 16}) {
+    tbb::task_scheduler_init init(threads);
+    tbb::tick_count start = tbb::tick_count::now();
+    std::vector<int> res = TBB_Dijkstra_Alg(graph, sourceVertex);
+    double time = (tbb::tick_count::now() - start).seconds();
+    if (threads == 1) {
+      oneThreadRes = res;
+      oneThreadTime = time;
+    }
+    std::cout << "Threads: " << threads << " time: " << time
+              << " speedup: " << oneThreadTime / time << std::endl;
+
+    ASSERT_EQ(oneThreadRes, res);
+  }
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
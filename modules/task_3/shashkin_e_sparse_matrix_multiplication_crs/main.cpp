@@ -35,6 +35,27 @@ TEST(SparseMatrixMultiplication, can_transpose) {
   ASSERT_TRUE(mat_trans == tmp);
 }
 
+TEST(SparseMatrixMultiplication, can_transpose_random_into_existing_matrix) {
+  std::vector<std::vector<std::complex<double>>> mat = randomMatrix(70, 45, 10);
+  std::vector<std::vector<std::complex<double>>> mat_trans(45, std::vector<std::complex<double>>(70));
+  for (int i = 0; i < 70; ++i)
+    for (int j = 0; j < 45; ++j)
+      mat_trans[j][i] = mat[i][j];
+  SparseComplexMatrix crsMat;
+  crsMat = crsMat.matrixToCRS(mat);
+  SparseComplexMatrix crsTrans;
+  crsTrans = crsTrans.matrixToCRS(mat_trans);
+
+  SparseComplexMatrix tmp = crsMat;
+  crsMat.transposeCRS(&tmp);
+  ASSERT_EQ(crsTrans.rows_num, tmp.rows_num);
+  ASSERT_EQ(crsTrans.cols_num, tmp.cols_num);
+  ASSERT_EQ(crsTrans.row_index, tmp.row_index);
+  ASSERT_EQ(crsTrans.col_index, tmp.col_index);
+  ASSERT_TRUE(crsTrans == tmp);
+  ASSERT_EQ(crsMat.col_index, tmp.transposeCRS().col_index);
+}
+
 TEST(SparseMatrixMultiplication, can_multimply_square_crs_matrices) {
   int size = 5;
   std::vector<std::vector<std::complex<double>>> mat1;
@@ -2,6 +2,7 @@
 #include "../../modules/task_3/shashkin_e_sparse_matrix_multiplication_crs/sparse_matrix_multiplication_crs.h"
 #include <omp.h>
 #include <vector>
+#include <algorithm>
 SparseComplexMatrix::SparseComplexMatrix() {
   rows_num = 0;
   cols_num = 0;
@@ -90,30 +91,67 @@ SparseComplexMatrix SparseComplexMatrix::matrixToCRS(std::vector<std::vector<std
 }
 
 SparseComplexMatrix SparseComplexMatrix::transposeCRS() {
-  SparseComplexMatrix result(cols_num, rows_num);
-  std::vector<int> rowT_count;
-  std::vector<int> row_count;
-  std::vector<int> row_idxs;
-  int k = 0;
-  result.row_index.push_back(0);
-  for (int i = 0; i < rows_num; ++i) {
-    row_count.push_back(row_index[i + 1] - row_index[i]);
-    for (int j = 0; j < row_count[i]; ++j)
-      row_idxs.push_back(i);
-  }
-  for (int i = 0; i < cols_num; ++i) {
-    for (unsigned j = 0; j < values.size(); ++j) {
-      if (col_index[j] == i) {
-        result.values.push_back(values[j]);
-        result.col_index.push_back(row_idxs[j]);
-        k++;
+  SparseComplexMatrix result;
+  transposeCRS(&result);
+  return result;
+}
+
+void SparseComplexMatrix::transposeCRS(SparseComplexMatrix* result) const& {
+  // Per-part column counts, a prefix sum, then an in-order scatter of each part's rows
+  static thread_local std::vector<int> counters;
+  const int parts = std::max(1, std::min(rows_num, tbb::task_scheduler_init::default_num_threads()));
+  const int nonzeros = values.size();
+  const int cols = cols_num;
+  result->rows_num = cols_num;
+  result->cols_num = rows_num;
+  result->values.resize(nonzeros);
+  result->col_index.resize(nonzeros);
+  result->row_index.resize(cols_num + 1);
+  counters.assign(static_cast<size_t>(parts) * cols, 0);
+  int* count = counters.data();
+  int* res_row = result->row_index.data();
+  auto part_first = [&](int part) { return static_cast<int>(static_cast<int64_t>(rows_num) * part / parts); };
+
+  tbb::parallel_for(tbb::blocked_range<int>(0, parts, 1), [&](const tbb::blocked_range<int>& r) {
+    for (int part = r.begin(); part < r.end(); ++part) {
+      int* own = count + static_cast<size_t>(part) * cols;
+      for (int i = part_first(part); i < part_first(part + 1); ++i)
+        for (int iter = row_index[i]; iter < row_index[i + 1]; ++iter)
+          ++own[col_index[iter]];
+    }
+  });
+  tbb::parallel_for(tbb::blocked_range<int>(0, cols), [&](const tbb::blocked_range<int>& r) {
+    for (int j = r.begin(); j < r.end(); ++j) {
+      int total = 0;
+      for (int part = 0; part < parts; ++part)
+        total += count[static_cast<size_t>(part) * cols + j];
+      res_row[j + 1] = total;
+    }
+  });
+  res_row[0] = 0;
+  for (int j = 0; j < cols; ++j)
+    res_row[j + 1] += res_row[j];
+  tbb::parallel_for(tbb::blocked_range<int>(0, cols), [&](const tbb::blocked_range<int>& r) {
+    for (int j = r.begin(); j < r.end(); ++j) {
+      int pos = res_row[j];
+      for (int part = 0; part < parts; ++part) {
+        int line_count = count[static_cast<size_t>(part) * cols + j];
+        count[static_cast<size_t>(part) * cols + j] = pos;
+        pos += line_count;
       }
     }
-    rowT_count.push_back(k);
-    k = 0;
-    result.row_index.push_back(result.row_index[i] + rowT_count[i]);
-  }
-  return result;
+  });
+  tbb::parallel_for(tbb::blocked_range<int>(0, parts, 1), [&](const tbb::blocked_range<int>& r) {
+    for (int part = r.begin(); part < r.end(); ++part) {
+      int* own = count + static_cast<size_t>(part) * cols;
+      for (int i = part_first(part); i < part_first(part + 1); ++i)
+        for (int iter = row_index[i]; iter < row_index[i + 1]; ++iter) {
+          int pos = own[col_index[iter]]++;
+          result->values[pos] = values[iter];
+          result->col_index[pos] = i;
+        }
+    }
+  });
 }
 
 bool SparseComplexMatrix::operator==(const SparseComplexMatrix& mat) const& {
@@ -132,8 +170,7 @@ bool SparseComplexMatrix::operator==(const SparseComplexMatrix& mat) const& {
 SparseComplexMatrix SparseComplexMatrix::operator*(const SparseComplexMatrix& mat) const& {
   SparseComplexMatrix result(rows_num, mat.cols_num);
   SparseComplexMatrix tmp;
-  tmp = mat;
-  tmp = tmp.transposeCRS();
+  mat.transposeCRS(&tmp);
   int not_zero_vals = 0;
   if (cols_num != tmp.cols_num)
     throw std::runtime_error("Error! Incorrect numbers of cols!\n");
@@ -196,8 +233,7 @@ void MatrixMultiplicator::operator()(const tbb::blocked_range<int>& r) const {
 SparseComplexMatrix SparseComplexMatrix::crsParallelMult(const SparseComplexMatrix& mat) const& {
   SparseComplexMatrix result(rows_num, mat.cols_num);
   SparseComplexMatrix tmp;
-  tmp = mat;
-  tmp = tmp.transposeCRS();
+  mat.transposeCRS(&tmp);
   tbb::atomic<int> not_zero_vals = 0;
   if (cols_num != tmp.cols_num)
     throw std::runtime_error("Error! Incorrect numbers of cols!\n");
@@ -30,6 +30,8 @@ class SparseComplexMatrix {
   SparseComplexMatrix crsParallelMult(const SparseComplexMatrix& mat) const&;
   SparseComplexMatrix matrixToCRS(std::vector<std::vector<std::complex<double>>> matrix);
   SparseComplexMatrix transposeCRS();
+  // Writes the transpose into result, reusing the memory it already holds
+  void transposeCRS(SparseComplexMatrix* result) const&;
   void printCRS();
 };
 
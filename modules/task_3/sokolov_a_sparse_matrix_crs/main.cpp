@@ -1,6 +1,7 @@
 // Copyright 2020 Sokolov Andrey
 #include <gtest/gtest.h>
 #include <omp.h>
+#include <algorithm>
 #include <vector>
 #include "./sparse_matrix_crs_tbb.h"
 
@@ -369,3 +370,66 @@ TEST(Sparse_Matrix, Test_Omp_Matrix_Miltiplication_With_Rand_Gen) {
     // std::cout << "Acseleration_Sparse_Mul " << (t2Seq - t1Seq).seconds() / (t2Tbb - t1Tbb).seconds() << std::endl;
     ASSERT_NEAR_SPARSE_MATRIX(resultSparse, resultSparseTbb, 1e-6);
 }
+
+int64_t partCost(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int begin, int end) {
+    int64_t cost{0};
+    for (int idx{begin}; idx < end; ++idx) {
+        cost += matrixB.cols;
+        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+            int tmpCol{matrixA.colIndex[jdx]};
+            cost += matrixB.rowIndex[tmpCol + 1] - matrixB.rowIndex[tmpCol];
+        }
+    }
+    return cost;
+}
+
+TEST(Sparse_Matrix, Test_Partition_Rows_By_Flops) {
+    SparseMatrix sparseMatrixA{ generatePowerLawMatrix(200, 200, 200) };
+    SparseMatrix sparseMatrixB{ generateMatrix(200, 200, 5) };
+    constexpr int parts{4};
+
+    std::vector<int> bounds = partitionRowsByFlops(sparseMatrixA, sparseMatrixB, parts);
+
+    ASSERT_EQ(bounds.size(), static_cast<size_t>(parts + 1));
+    ASSERT_EQ(bounds.front(), 0);
+    ASSERT_EQ(bounds.back(), 200);
+    int64_t total{partCost(sparseMatrixA, sparseMatrixB, 0, 200)};
+    int64_t maxRowCost{0};
+    for (int idx{0}; idx < 200; ++idx) {
+        maxRowCost = std::max(maxRowCost, partCost(sparseMatrixA, sparseMatrixB, idx, idx + 1));
+    }
+    for (int part{0}; part < parts; ++part) {
+        ASSERT_LE(bounds[part], bounds[part + 1]);
+        ASSERT_LE(partCost(sparseMatrixA, sparseMatrixB, bounds[part], bounds[part + 1]),
+                  total / parts + maxRowCost);
+    }
+}
+
+TEST(Sparse_Matrix, Test_Tbb_Matrix_Miltiplication_Power_Law) {
+    Matrix matrixA{ generatePowerLawMatrix(60, 40, 40) };
+    Matrix matrixB{ generateMatrix(40, 70, 10) };
+
+    SparseMatrix sparseMatrixA{ matrixA };
+    SparseMatrix sparseMatrixB{ matrixB };
+
+    SparseMatrix resultToSparse{ MatMul(matrixA, matrixB) };
+    SparseMatrix resultSparseTbb = SparseMatMulTbb(sparseMatrixA, sparseMatrixB);
+
+    ASSERT_NEAR_SPARSE_MATRIX(resultToSparse, resultSparseTbb, 1e-6);
+}
+
+TEST(Sparse_Matrix, DISABLED_Test_Tbb_Power_Law_Balance) {
+    constexpr size_t size{3000U};
+    SparseMatrix sparseMatrixA{ generatePowerLawMatrix(size, size, size) };
+    SparseMatrix sparseMatrixB{ generateMatrix(size, size, 10) };
+
+    tbb::tick_count t1 = tbb::tick_count::now();
+    SparseMatrix resultSparse = SparseMatMul(sparseMatrixA, sparseMatrixB);
+    tbb::tick_count t2 = tbb::tick_count::now();
+    SparseMatrix resultSparseTbb = SparseMatMulTbb(sparseMatrixA, sparseMatrixB);
+    tbb::tick_count t3 = tbb::tick_count::now();
+    std::cout << "Seq_Sparse_Mul: " << (t2 - t1).seconds() << std::endl;
+    std::cout << "TBB_Sparse_Mul: " << (t3 - t2).seconds() << std::endl;
+
+    ASSERT_NEAR_SPARSE_MATRIX(resultSparse, resultSparseTbb, 1e-6);
+}
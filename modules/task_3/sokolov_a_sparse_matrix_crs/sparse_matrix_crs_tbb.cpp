@@ -1,5 +1,6 @@
 // Copyright 2020 Sokolov Andrey
 #include <omp.h>
+#include <algorithm>
 #include <vector>
 #include "../../../modules/task_3/sokolov_a_sparse_matrix_crs/sparse_matrix_crs_tbb.h"
 
@@ -87,20 +88,22 @@ Matrix SparseMatrix::SparseToMatrix() {
 }
 
 void MatrixMultiplicator::operator()(const tbb::blocked_range<int>& r) const {
-    int tmpCol{ 0 };
-    for (int idx = r.begin(); idx < r.end(); ++idx) {
-        std::vector<double> tmpResult(matrixA.rows + 1, 0);
-        for (int jdx{ matrixA.rowIndex[idx] }; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
-            tmpCol = matrixA.colIndex[jdx];
-            for (int kdx{ matrixB.rowIndex[tmpCol] }; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
-                tmpResult[matrixB.colIndex[kdx]] += matrixA.value[jdx] * matrixB.value[kdx];
+    std::vector<double> tmpResult(matrixB.cols, 0);
+    for (int part = r.begin(); part < r.end(); ++part) {
+        for (int idx = bounds[part]; idx < bounds[part + 1]; ++idx) {
+            for (int jdx{ matrixA.rowIndex[idx] }; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+                int tmpCol{ matrixA.colIndex[jdx] };
+                for (int kdx{ matrixB.rowIndex[tmpCol] }; kdx < matrixB.rowIndex[tmpCol + 1]; ++kdx) {
+                    tmpResult[matrixB.colIndex[kdx]] += matrixA.value[jdx] * matrixB.value[kdx];
+                }
             }
-        }
-        for (int kdx{ 0 }; kdx < matrixA.rows; ++kdx) {
-            if (tmpResult[kdx] != 0.0) {
-                tmpResultValue[idx].push_back(tmpResult[kdx]);
-                tmpResultCols[idx].push_back(kdx);
-                tmpResultRow[idx]++;
+            for (int kdx{ 0 }; kdx < matrixB.cols; ++kdx) {
+                if (tmpResult[kdx] != 0.0) {
+                    tmpResultValue[idx].push_back(tmpResult[kdx]);
+                    tmpResultCols[idx].push_back(kdx);
+                    tmpResultRow[idx]++;
+                    tmpResult[kdx] = 0.0;
+                }
             }
         }
     }
@@ -139,14 +142,27 @@ SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matri
     return result;
 }
 
-SparseMatrix SparseMatMulTbb(const SparseMatrix& matrixA, const SparseMatrix& matrixB) {
-    int grainsize{0};
-    if (matrixA.rows > 4) {
-        grainsize = matrixA.rows / 4;
-    } else {
-        grainsize = 1;
+std::vector<int> partitionRowsByFlops(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int parts) {
+    std::vector<int64_t> cost(matrixA.rows + 1, 0);
+    for (int idx{0}; idx < matrixA.rows; ++idx) {
+        int64_t rowCost{matrixB.cols};
+        for (int jdx{matrixA.rowIndex[idx]}; jdx < matrixA.rowIndex[idx + 1]; ++jdx) {
+            int tmpCol{matrixA.colIndex[jdx]};
+            rowCost += matrixB.rowIndex[tmpCol + 1] - matrixB.rowIndex[tmpCol];
+        }
+        cost[idx + 1] = cost[idx] + rowCost;
     }
 
+    std::vector<int> bounds(parts + 1, matrixA.rows);
+    bounds[0] = 0;
+    for (int part{1}; part < parts; ++part) {
+        int64_t target{cost[matrixA.rows] * part / parts};
+        bounds[part] = std::lower_bound(cost.begin(), cost.end(), target) - cost.begin();
+    }
+    return bounds;
+}
+
+SparseMatrix SparseMatMulTbb(const SparseMatrix& matrixA, const SparseMatrix& matrixB) {
     SparseMatrix result{};
     result.rows = matrixA.rows;
     result.cols = matrixB.cols;
@@ -156,8 +172,13 @@ SparseMatrix SparseMatMulTbb(const SparseMatrix& matrixA, const SparseMatrix& ma
     std::vector<int>*    tmpResultCols = new std::vector<int>[result.rows];
     std::vector<double>* tmpResultValue = new std::vector<double>[result.rows];
 
-    tbb::parallel_for(tbb::blocked_range<int>(0, result.rows, grainsize),
-                      MatrixMultiplicator(matrixA, matrixB, tmpResultCols, tmpResultValue, tmpResultRow));
+    // A few parts per worker, all of about the same number of flops, so the
+    // heavy rows of a skewed matrix do not end up in one task
+    int parts{std::max(1, std::min(matrixA.rows, 4 * tbb::task_scheduler_init::default_num_threads()))};
+    std::vector<int> bounds = partitionRowsByFlops(matrixA, matrixB, parts);
+
+    tbb::parallel_for(tbb::blocked_range<int>(0, parts, 1),
+                      MatrixMultiplicator(matrixA, matrixB, bounds, tmpResultCols, tmpResultValue, tmpResultRow));
 
     int count{0};
     int tmpRows{0};
@@ -225,6 +246,23 @@ Matrix generateMatrix(const size_t& rows, const size_t& cols, const size_t& coef
     return result;
 }
 
+Matrix generatePowerLawMatrix(const size_t& rows, const size_t& cols, const size_t& maxRowElems) {
+    Matrix result(rows, std::vector<double>(cols, 0.0));
+
+    std::random_device rd{};
+    std::mt19937 mt {rd()};
+    std::uniform_real_distribution<double> disValue{ 1.0, 10.0 };
+    std::uniform_int_distribution<size_t> disCol {0, cols - 1};
+
+    for (size_t idx{0U}; idx < rows; ++idx) {
+        size_t elems{std::min(cols, std::max<size_t>(1U, maxRowElems / (idx + 1)))};
+        for (size_t count{0U}; count < elems; ++count) {
+            result[idx][disCol(mt)] = disValue(mt);
+        }
+    }
+    return result;
+}
+
 void SparseMatrix::printDefault() {
     std::cout << "Value:" << std::endl;
     for (size_t idx{ 0 }; idx < value.size(); ++idx) {
@@ -2,6 +2,7 @@
 #ifndef MODULES_TASK_3_SOKOLOV_A_SPARSE_MATRIX_CRS_SPARSE_MATRIX_CRS_TBB_H_
 #define MODULES_TASK_3_SOKOLOV_A_SPARSE_MATRIX_CRS_SPARSE_MATRIX_CRS_TBB_H_
 #include <tbb/tbb.h>
+#include <cstdint>
 #include <iostream>
 #include <iomanip>
 #include <cmath>
@@ -39,10 +40,13 @@ class SparseMatrix {
      friend SparseMatrix SparseMatMulOmp(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
 };
 
+// Multiplies the row parts given by bounds (see partitionRowsByFlops),
+// a range of the parallel_for is a range of parts
 class MatrixMultiplicator {
  private:
-    SparseMatrix matrixA;
-    SparseMatrix matrixB;
+    const SparseMatrix& matrixA;
+    const SparseMatrix& matrixB;
+    const std::vector<int>& bounds;
     std::vector<int>* tmpResultCols;
     std::vector<double>* tmpResultValue;
     std::vector<int>& tmpResultRow;
@@ -50,10 +54,12 @@ class MatrixMultiplicator {
  public:
     MatrixMultiplicator(const SparseMatrix& _matrixA,
                         const SparseMatrix& _matrixB,
+                        const std::vector<int>& _bounds,
                         std::vector<int>* _tmpResultCols,
                         std::vector<double>* _tmpResultValue,
                         std::vector<int>& _tmpResultRow) : matrixA(_matrixA),
                                                            matrixB(_matrixB),
+                                                           bounds(_bounds),
                                                            tmpResultCols(_tmpResultCols),
                                                            tmpResultValue(_tmpResultValue),
                                                            tmpResultRow(_tmpResultRow) {}
@@ -63,9 +69,16 @@ class MatrixMultiplicator {
 
 SparseMatrix SparseMatMul(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
 SparseMatrix SparseMatMulTbb(const SparseMatrix& matrixA, const SparseMatrix& matrixB);
+// Splits the rows of matrixA into parts contiguous ranges of about the same
+// cost in matrixA * matrixB (multiply-adds plus the scan of the result row),
+// returns parts + 1 row bounds
+std::vector<int> partitionRowsByFlops(const SparseMatrix& matrixA, const SparseMatrix& matrixB, int parts);
 Matrix MatMul(const Matrix& matrixA, const Matrix& matrixB);
 
 Matrix generateMatrix(const size_t& rows, const size_t& cols, const size_t& coeff);
+// Row idx has about maxRowElems / (idx + 1) elements, so the first rows are
+// much heavier than the rest
+Matrix generatePowerLawMatrix(const size_t& rows, const size_t& cols, const size_t& maxRowElems);
 
 void print(const Matrix& matrix);
 
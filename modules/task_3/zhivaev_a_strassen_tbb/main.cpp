@@ -91,6 +91,51 @@ TEST(Parallel, Matrix_128x128) {
   }
 }
 
+TEST(Parallel, Same_Result_For_Any_Task_Depth) {
+  const int size = 256;
+  std::vector<double> a(size * size);
+  std::vector<double> b(size * size);
+  std::vector<double> result(size * size);
+  std::vector<double> expected(size * size);
+
+  for (int i = 0; i < size * size; i++) {
+    a[i] = (i % 17) - 8;
+    b[i] = (i % 13) - 6;
+  }
+  multSeq(size, a.data(), b.data(), expected.data());
+
+  for (int depth = 0; depth <= 3; depth++) {
+    multStrassenTbb(size, a.data(), b.data(), result.data(), depth);
+    ASSERT_EQ(expected, result);
+  }
+}
+
+TEST(Parallel, Throws_On_Negative_Task_Depth) {
+  std::vector<double> a(4 * 4), b(4 * 4), result(4 * 4);
+
+  ASSERT_ANY_THROW(multStrassenTbb(4, a.data(), b.data(), result.data(), -1));
+}
+
+TEST(Parallel, DISABLED_Task_Depth_1024x1024) {
+  const int size = 1024;
+  std::vector<double> a(size * size);
+  std::vector<double> b(size * size);
+  std::vector<double> result(size * size);
+
+  for (int i = 0; i < size * size; i++) {
+    a[i] = i + 1;
+    b[i] = size * size - i;
+  }
+
+  for (int depth = 0; depth <= 3; depth++) {
+    auto start = tbb::tick_count::now();
+    multStrassenTbb(size, a.data(), b.data(), result.data(), depth);
+    auto end = tbb::tick_count::now();
+    std::cout << "Task depth " << depth << ": " << (end - start).seconds()
+              << std::endl;
+  }
+}
+
 TEST(Parallel, DISABLED_Matrix_256x256) {
   const int size = 256;
   std::vector<double> a(size * size);
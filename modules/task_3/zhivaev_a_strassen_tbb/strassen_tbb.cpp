@@ -6,6 +6,8 @@
 #include <tbb/tbb.h>
 
 #include <bitset>
+#include <functional>
+#include <stdexcept>
 
 void multSeq(int size, const double* a, const double* b, double* result);
 
@@ -16,23 +18,23 @@ void assembleMatrix(int size, double* a, const double* a11, const double* a12,
                     const double* a21, const double* a22);
 
 void multStrassenRecursive(int size, const double* a, const double* b,
-                           double* result);
+                           double* result, int taskDepth);
 
 // (A1 + A2)(B1 + B2)
 void strassen1(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result);
+               const double* b2, double* result, int taskDepth);
 
 // (A1 + A2)B
 void strassen2(int size, const double* a1, const double* a2, const double* b,
-               double* result);
+               double* result, int taskDepth);
 
 // A(B1 - B2)
 void strassen3(int size, const double* a, const double* b1, const double* b2,
-               double* result);
+               double* result, int taskDepth);
 
 // (A1 - A2)(B1 + B2)
 void strassen4(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result);
+               const double* b2, double* result, int taskDepth);
 
 int powerOf2(int number) {
   if (number <= 0) {
@@ -96,7 +98,7 @@ void assembleMatrix(int size, double* a, const double* a11, const double* a12,
 }
 
 void strassen1(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result) {
+               const double* b2, double* result, int taskDepth) {
   double* t1 = new double[size * size * 2];
   double* t2 = t1 + size * size;
   int i;
@@ -107,13 +109,13 @@ void strassen1(int size, const double* a1, const double* a2, const double* b1,
     t2[i] = b1[i] + b2[i];
   }
 
-  multStrassenRecursive(size, t1, t2, result);
+  multStrassenRecursive(size, t1, t2, result, taskDepth);
 
   delete[] t1;
 }
 
 void strassen2(int size, const double* a1, const double* a2, const double* b,
-               double* result) {
+               double* result, int taskDepth) {
   double* t = new double[size * size];
   int i;
   int length = size * size;
@@ -122,13 +124,13 @@ void strassen2(int size, const double* a1, const double* a2, const double* b,
     t[i] = a1[i] + a2[i];
   }
 
-  multStrassenRecursive(size, t, b, result);
+  multStrassenRecursive(size, t, b, result, taskDepth);
 
   delete[] t;
 }
 
 void strassen3(int size, const double* a, const double* b1, const double* b2,
-               double* result) {
+               double* result, int taskDepth) {
   double* t = new double[size * size];
   int i;
   int length = size * size;
@@ -137,13 +139,13 @@ void strassen3(int size, const double* a, const double* b1, const double* b2,
     t[i] = b1[i] - b2[i];
   }
 
-  multStrassenRecursive(size, a, t, result);
+  multStrassenRecursive(size, a, t, result, taskDepth);
 
   delete[] t;
 }
 
 void strassen4(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result) {
+               const double* b2, double* result, int taskDepth) {
   double* t1 = new double[size * size * 2];
   double* t2 = t1 + size * size;
   int i;
@@ -154,7 +156,7 @@ void strassen4(int size, const double* a1, const double* a2, const double* b1,
     t2[i] = b1[i] + b2[i];
   }
 
-  multStrassenRecursive(size, t1, t2, result);
+  multStrassenRecursive(size, t1, t2, result, taskDepth);
 
   delete[] t1;
 }
@@ -171,7 +173,7 @@ void multSeq(int size, const double* a, const double* b, double* result) {
 }
 
 void multStrassenRecursive(int size, const double* a, const double* b,
-                           double* result) {
+                           double* result, int taskDepth) {
   if (size <= 128) {
     multSeq(size, a, b, result);
     return;
@@ -201,30 +203,37 @@ void multStrassenRecursive(int size, const double* a, const double* b,
   splitMatrix(size, a, a11, a12, a21, a22);
   splitMatrix(size, b, b11, b12, b21, b22);
 
-  tbb::task_group tasks;
-
-  // M1 = (A11 + A22)(B11 + B22)
-  tasks.run([=] { strassen1(size / 2, a11, a22, b11, b22, m1); });
-
-  // M2 = (A21 + A22)B11
-  tasks.run([=] { strassen2(size / 2, a21, a22, b11, m2); });
-
-  // M3 = A11(B12 - B22)
-  tasks.run([=] { strassen3(size / 2, a11, b12, b22, m3); });
-
-  // M4 = A22(B21 - B11)
-  tasks.run([=] { strassen3(size / 2, a22, b21, b11, m4); });
-
-  // M5 = (A11 + A12)B22
-  tasks.run([=] { strassen2(size / 2, a11, a12, b22, m5); });
-
-  // M6 = (A21 - A11)(B11 + B12)
-  tasks.run([=] { strassen4(size / 2, a21, a11, b11, b12, m6); });
-
-  // M7 = (A12 - A22)(B21 + B22)
-  tasks.run([=] { strassen4(size / 2, a12, a22, b21, b22, m7); });
-
-  tasks.wait();
+  // The seven products are spawned into a task_group for the first taskDepth
+  // levels; below that they run one after another in the current task
+  const int half = size / 2;
+  const int next = taskDepth - 1;
+  std::function<void()> products[7] = {
+      // M1 = (A11 + A22)(B11 + B22)
+      [=] { strassen1(half, a11, a22, b11, b22, m1, next); },
+      // M2 = (A21 + A22)B11
+      [=] { strassen2(half, a21, a22, b11, m2, next); },
+      // M3 = A11(B12 - B22)
+      [=] { strassen3(half, a11, b12, b22, m3, next); },
+      // M4 = A22(B21 - B11)
+      [=] { strassen3(half, a22, b21, b11, m4, next); },
+      // M5 = (A11 + A12)B22
+      [=] { strassen2(half, a11, a12, b22, m5, next); },
+      // M6 = (A21 - A11)(B11 + B12)
+      [=] { strassen4(half, a21, a11, b11, b12, m6, next); },
+      // M7 = (A12 - A22)(B21 + B22)
+      [=] { strassen4(half, a12, a22, b21, b22, m7, next); }};
+
+  if (taskDepth > 0) {
+    tbb::task_group tasks;
+    for (auto& product : products) {
+      tasks.run(product);
+    }
+    tasks.wait();
+  } else {
+    for (auto& product : products) {
+      product();
+    }
+  }
 
   // C11 = M1 + M4 - M5 + M7
   for (i = 0; i < qLength; i++) {
@@ -255,12 +264,12 @@ void multStrassenRecursive(int size, const double* a, const double* b,
 }
 
 void multStrassenTbb(int size, const double* a, const double* b,
-                     double* result) {
-  if (powerOf2(size) == -1) {
+                     double* result, int taskDepth) {
+  if (powerOf2(size) == -1 || taskDepth < 0) {
     throw std::invalid_argument("");
   }
 
   tbb::task_scheduler_init init;
 
-  multStrassenRecursive(size, a, b, result);
+  multStrassenRecursive(size, a, b, result, taskDepth);
 }
@@ -3,6 +3,9 @@
 #ifndef MODULES_TASK_3_ZHIVAEV_A_STRASSEN_TBB_STRASSEN_TBB_H_
 #define MODULES_TASK_3_ZHIVAEV_A_STRASSEN_TBB_STRASSEN_TBB_H_
 
-void multStrassenTbb(int size, const double* a, const double* b, double* result);
+// The seven sub-products are run as tbb::task_group tasks for the first
+// taskDepth levels of the recursion and sequentially below that
+void multStrassenTbb(int size, const double* a, const double* b, double* result,
+                     int taskDepth = 2);
 
 #endif  // MODULES_TASK_3_ZHIVAEV_A_STRASSEN_TBB_STRASSEN_TBB_H_
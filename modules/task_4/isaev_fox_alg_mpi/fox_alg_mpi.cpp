@@ -0,0 +1,324 @@
+// Copyright 2020 Isaev Ilya
+#include "../../../modules/task_4/isaev_fox_alg_mpi/fox_alg_mpi.h"
+#include <mpi.h>
+#include <cmath>
+#include <vector>
+#include <random>
+#include <stdexcept>
+
+Matrix getRandomMatrix(const int& n) {
+    if (n <= 0) {
+        throw std::exception();
+    }
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_real_distribution<> dis(0, 100);
+
+    Matrix res(n, std::vector<double>(n));
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            res[i][j] = dis(gen);
+        }
+    }
+    return res;
+}
+
+Matrix naiveMultiplication(const Matrix& mat1, const Matrix& mat2) {
+    if (mat1[0].size() != mat2.size())
+        throw std::exception();
+
+    size_t n = mat1.size();
+    size_t m = mat2[0].size();
+    Matrix res(n, std::vector<double>(m));
+
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < m; ++j) {
+            res[i][j] = 0;
+            for (size_t k = 0; k < mat2.size(); ++k) {
+                res[i][j] += mat1[i][k]*mat2[k][j];
+            }
+        }
+    }
+    return res;
+}
+
+bool matrixComparison(const Matrix& mat1, const Matrix& mat2) {
+    if (mat1.size() != mat2.size())
+        return false;
+    for (size_t i = 0; i < mat1.size(); ++i) {
+        if (mat1[i].size() != mat2[i].size())
+            return false;
+        for (size_t j = 0; j < mat1[i].size(); ++j) {
+            if (!doubleComparison(mat1[i][j], mat2[i][j]))
+                return false;
+        }
+    }
+    return true;
+}
+
+namespace {
+
+// Position of a rank in a q x q x layers grid together with the
+// communicators along each of its directions
+struct Grid {
+    int q;
+    int layers;
+    int i, j, l;
+    bool active;
+    MPI_Comm layer;
+    MPI_Comm depth;
+    MPI_Comm row;
+    MPI_Comm col;
+};
+
+Grid makeGrid(MPI_Comm comm, int layers) {
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+
+    Grid grid;
+    grid.layers = layers;
+    grid.q = static_cast<int>(std::sqrt(static_cast<double>(size / layers)));
+    while ((grid.q + 1) * (grid.q + 1) * layers <= size)
+        ++grid.q;
+    while (grid.q > 0 && grid.q * grid.q * layers > size)
+        --grid.q;
+    if (grid.q == 0)
+        throw std::logic_error("Not enough processes for the grid");
+
+    int area = grid.q * grid.q;
+    grid.active = rank < area * layers;
+    grid.l = rank / area;
+    grid.i = rank % area / grid.q;
+    grid.j = rank % grid.q;
+
+    auto color = [&grid](int value) {
+        return grid.active ? value : MPI_UNDEFINED;
+    };
+    MPI_Comm_split(comm, color(grid.l), grid.i * grid.q + grid.j, &grid.layer);
+    MPI_Comm_split(comm, color(grid.i * grid.q + grid.j), grid.l, &grid.depth);
+    MPI_Comm_split(comm, color(grid.l * grid.q + grid.i), grid.j, &grid.row);
+    MPI_Comm_split(comm, color(grid.l * grid.q + grid.j), grid.i, &grid.col);
+    return grid;
+}
+
+void freeGrid(Grid* grid) {
+    if (!grid->active)
+        return;
+    MPI_Comm_free(&grid->layer);
+    MPI_Comm_free(&grid->depth);
+    MPI_Comm_free(&grid->row);
+    MPI_Comm_free(&grid->col);
+}
+
+// Broadcasts the matrix size from rank 0; every rank throws on bad input so
+// that nobody is left waiting in a collective
+int shareSize(const Matrix& mat1, const Matrix& mat2, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+    int n = 0;
+    if (rank == 0) {
+        bool valid = !mat1.empty() && mat1.size() == mat2.size();
+        for (size_t i = 0; valid && i < mat1.size(); ++i)
+            valid = mat1[i].size() == mat1.size() &&
+                    mat2[i].size() == mat1.size();
+        n = valid ? static_cast<int>(mat1.size()) : -1;
+    }
+    MPI_Bcast(&n, 1, MPI_INT, 0, comm);
+    if (n <= 0)
+        throw std::logic_error("Matrix should be squared");
+    return n;
+}
+
+// Lays the matrix out block after block in grid rank order, padding the
+// border blocks with zeros
+std::vector<double> packBlocks(const Matrix& mat, int q, int nb) {
+    int n = static_cast<int>(mat.size());
+    std::vector<double> buf(static_cast<size_t>(q) * q * nb * nb, 0.0);
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            size_t block = (i / nb) * q + j / nb;
+            buf[(block * nb + i % nb) * nb + j % nb] = mat[i][j];
+        }
+    }
+    return buf;
+}
+
+Matrix unpackBlocks(const std::vector<double>& buf, int n, int q, int nb) {
+    Matrix res(n, std::vector<double>(n));
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < n; ++j) {
+            size_t block = (i / nb) * q + j / nb;
+            res[i][j] = buf[(block * nb + i % nb) * nb + j % nb];
+        }
+    }
+    return res;
+}
+
+// Gives every rank of layer 0 its blocks of A and B
+void scatterBlocks(const Matrix& mat1, const Matrix& mat2, const Grid& grid,
+                   int nb, std::vector<double>* a, std::vector<double>* b) {
+    int count = nb * nb;
+    std::vector<double> buf1, buf2;
+    if (grid.i == 0 && grid.j == 0) {
+        buf1 = packBlocks(mat1, grid.q, nb);
+        buf2 = packBlocks(mat2, grid.q, nb);
+    }
+    MPI_Scatter(buf1.data(), count, MPI_DOUBLE, a->data(), count, MPI_DOUBLE,
+                0, grid.layer);
+    MPI_Scatter(buf2.data(), count, MPI_DOUBLE, b->data(), count, MPI_DOUBLE,
+                0, grid.layer);
+}
+
+Matrix gatherBlocks(const std::vector<double>& c, const Grid& grid, int n,
+                    int nb) {
+    int count = nb * nb;
+    std::vector<double> buf;
+    if (grid.i == 0 && grid.j == 0)
+        buf.resize(static_cast<size_t>(grid.q) * grid.q * count);
+    MPI_Gather(c.data(), count, MPI_DOUBLE, buf.data(), count, MPI_DOUBLE, 0,
+               grid.layer);
+    if (grid.i == 0 && grid.j == 0)
+        return unpackBlocks(buf, n, grid.q, nb);
+    return Matrix();
+}
+
+// Replaces the block at position pos of a ring of q ranks with the one held
+// offset positions further along the ring
+void shiftBlock(std::vector<double>* block, int pos, int q, int offset,
+                MPI_Comm ring) {
+    offset = (offset % q + q) % q;
+    if (offset == 0)
+        return;
+    MPI_Sendrecv_replace(block->data(), static_cast<int>(block->size()),
+                         MPI_DOUBLE, (pos - offset + q) % q, 0,
+                         (pos + offset) % q, 0, ring, MPI_STATUS_IGNORE);
+}
+
+// Nonblocking form of shiftBlock: the incoming block is received into next
+// while block itself is still being sent and read
+void startShift(std::vector<double>* block, std::vector<double>* next,
+                int pos, int q, int offset, MPI_Comm ring,
+                MPI_Request* requests) {
+    int count = static_cast<int>(block->size());
+    offset %= q;
+    MPI_Irecv(next->data(), count, MPI_DOUBLE, (pos + offset) % q, 0, ring,
+              &requests[0]);
+    MPI_Isend(block->data(), count, MPI_DOUBLE, (pos - offset + q) % q, 0,
+              ring, &requests[1]);
+}
+
+// c += a * b for nb x nb row-major blocks
+void multiplyBlocks(int nb, const double* a, const double* b, double* c) {
+    for (int i = 0; i < nb; ++i) {
+        for (int k = 0; k < nb; ++k) {
+            double aik = a[i * nb + k];
+            for (int j = 0; j < nb; ++j) {
+                c[i * nb + j] += aik * b[k * nb + j];
+            }
+        }
+    }
+}
+
+Matrix cannonLayers(const Matrix& mat1, const Matrix& mat2, int layers,
+                    MPI_Comm comm) {
+    if (layers < 1)
+        throw std::invalid_argument("Number of layers should be positive");
+    int n = shareSize(mat1, mat2, comm);
+    Grid grid = makeGrid(comm, layers);
+    if (!grid.active)
+        return Matrix();
+
+    int q = grid.q;
+    int nb = (n + q - 1) / q;
+    std::vector<double> a(nb * nb), b(nb * nb), c(nb * nb, 0.0);
+    if (grid.l == 0)
+        scatterBlocks(mat1, mat2, grid, nb, &a, &b);
+    MPI_Bcast(a.data(), nb * nb, MPI_DOUBLE, 0, grid.depth);
+    MPI_Bcast(b.data(), nb * nb, MPI_DOUBLE, 0, grid.depth);
+
+    // Layer l handles the steps s = l, l + layers, ..., so it starts with
+    // A(i, i + j + l) and B(i + j + l, j) and then shifts by `layers`
+    shiftBlock(&a, grid.j, q, grid.i + grid.l, grid.row);
+    shiftBlock(&b, grid.i, q, grid.j + grid.l, grid.col);
+    // The shift for the next step is posted before the current product and
+    // lands in a second pair of buffers, which are swapped in afterwards
+    int steps = grid.l < q ? (q - grid.l + layers - 1) / layers : 0;
+    std::vector<double> nextA(nb * nb), nextB(nb * nb);
+    for (int step = 0; step < steps; ++step) {
+        bool shift = step + 1 < steps;
+        MPI_Request requests[4];
+        if (shift) {
+            startShift(&a, &nextA, grid.j, q, layers, grid.row, requests);
+            startShift(&b, &nextB, grid.i, q, layers, grid.col,
+                       requests + 2);
+        }
+        multiplyBlocks(nb, a.data(), b.data(), c.data());
+        if (shift) {
+            MPI_Waitall(4, requests, MPI_STATUSES_IGNORE);
+            a.swap(nextA);
+            b.swap(nextB);
+        }
+    }
+
+    if (layers > 1) {
+        if (grid.l == 0)
+            MPI_Reduce(MPI_IN_PLACE, c.data(), nb * nb, MPI_DOUBLE, MPI_SUM, 0,
+                       grid.depth);
+        else
+            MPI_Reduce(c.data(), nullptr, nb * nb, MPI_DOUBLE, MPI_SUM, 0,
+                       grid.depth);
+    }
+
+    Matrix res;
+    if (grid.l == 0)
+        res = gatherBlocks(c, grid, n, nb);
+    freeGrid(&grid);
+    return res;
+}
+
+}  // namespace
+
+Matrix cannonAlgMPI(const Matrix& mat1, const Matrix& mat2, MPI_Comm comm) {
+    return cannonLayers(mat1, mat2, 1, comm);
+}
+
+Matrix cannon25DAlgMPI(const Matrix& mat1, const Matrix& mat2, int layers,
+                       MPI_Comm comm) {
+    return cannonLayers(mat1, mat2, layers, comm);
+}
+
+Matrix foxAlgMPI(const Matrix& mat1, const Matrix& mat2, MPI_Comm comm) {
+    int n = shareSize(mat1, mat2, comm);
+    Grid grid = makeGrid(comm, 1);
+    if (!grid.active)
+        return Matrix();
+
+    int q = grid.q;
+    int nb = (n + q - 1) / q;
+    std::vector<double> a(nb * nb), b(nb * nb), c(nb * nb, 0.0);
+    std::vector<double> pivot(nb * nb), nextB(nb * nb);
+    scatterBlocks(mat1, mat2, grid, nb, &a, &b);
+
+    // At step s the owner of A(i, i + s) broadcasts it along row i and every
+    // rank multiplies it by its current B block before B moves up by one
+    for (int step = 0; step < q; ++step) {
+        int root = (grid.i + step) % q;
+        if (grid.j == root)
+            pivot = a;
+        MPI_Bcast(pivot.data(), nb * nb, MPI_DOUBLE, root, grid.row);
+        bool shift = step + 1 < q;
+        MPI_Request requests[2];
+        if (shift)
+            startShift(&b, &nextB, grid.i, q, 1, grid.col, requests);
+        multiplyBlocks(nb, pivot.data(), b.data(), c.data());
+        if (shift) {
+            MPI_Waitall(2, requests, MPI_STATUSES_IGNORE);
+            b.swap(nextB);
+        }
+    }
+
+    Matrix res = gatherBlocks(c, grid, n, nb);
+    freeGrid(&grid);
+    return res;
+}
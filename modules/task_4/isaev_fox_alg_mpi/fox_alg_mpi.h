@@ -0,0 +1,35 @@
+// Copyright 2020 Isaev Ilya
+#ifndef MODULES_TASK_4_ISAEV_FOX_ALG_MPI_FOX_ALG_MPI_H_
+#define MODULES_TASK_4_ISAEV_FOX_ALG_MPI_FOX_ALG_MPI_H_
+
+#include <mpi.h>
+#include <cmath>
+#include <vector>
+
+using Matrix = std::vector<std::vector<double>>;
+
+inline bool doubleComparison(const double& a, const double& b) noexcept {
+    return std::abs(a-b) <= 0.001*std::abs(a+b);
+}
+
+Matrix getRandomMatrix(const int& n);
+Matrix naiveMultiplication(const Matrix& mat1, const Matrix& mat2);
+bool matrixComparison(const Matrix& mat1, const Matrix& mat2);
+
+// The functions below are collective over comm. The matrices are only read
+// on rank 0 and the product is returned there; other ranks get an empty
+// Matrix. The largest q x q grid (q x q x layers for 2.5D) that fits in comm
+// is used and the remaining ranks stay idle. Sizes that are not a multiple
+// of q are zero-padded.
+Matrix cannonAlgMPI(const Matrix& mat1, const Matrix& mat2,
+                    MPI_Comm comm = MPI_COMM_WORLD);
+Matrix foxAlgMPI(const Matrix& mat1, const Matrix& mat2,
+                 MPI_Comm comm = MPI_COMM_WORLD);
+
+// 2.5D Cannon: A and B are replicated over `layers` copies of the grid and
+// each layer does only its share of the q shift steps, after which the
+// partial products are summed onto layer 0
+Matrix cannon25DAlgMPI(const Matrix& mat1, const Matrix& mat2, int layers,
+                       MPI_Comm comm = MPI_COMM_WORLD);
+
+#endif  // MODULES_TASK_4_ISAEV_FOX_ALG_MPI_FOX_ALG_MPI_H_
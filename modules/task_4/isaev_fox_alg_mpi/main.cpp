@@ -0,0 +1,154 @@
+// Copyright 2020 Isaev Ilya
+#include <gtest-mpi-listener.hpp>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <vector>
+#include "../../../modules/task_4/isaev_fox_alg_mpi/fox_alg_mpi.h"
+
+TEST(MPI_Fox, Throws_On_NonEqual_Matrix) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Matrix a, b;
+    if (rank == 0) {
+        a = getRandomMatrix(5);
+        b = getRandomMatrix(6);
+    }
+
+    ASSERT_ANY_THROW(foxAlgMPI(a, b));
+    ASSERT_ANY_THROW(cannonAlgMPI(a, b));
+}
+
+TEST(MPI_Fox, Throws_On_Wrong_Number_Of_Layers) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Matrix a, b;
+    if (rank == 0) {
+        a = getRandomMatrix(4);
+        b = getRandomMatrix(4);
+    }
+
+    ASSERT_ANY_THROW(cannon25DAlgMPI(a, b, 0));
+}
+
+TEST(MPI_Fox, Fox_Is_Correct3x3) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Matrix mat1 = {{1.5, 1.5, 1.5},
+                   {2.7, 2.7, 2.7},
+                   {3.6, 3.6, 3.6}};
+    Matrix mat2 = {{3.5, 3.5, 3.5},
+                   {5.7, 5.7, 5.7},
+                   {9.6, 9.6, 9.6}};
+    Matrix answer = {{28.2, 28.2, 28.2},
+                    {50.76, 50.76, 50.76},
+                    {67.68, 67.68, 67.68}};
+
+    auto res = foxAlgMPI(mat1, mat2);
+
+    if (rank == 0) {
+        ASSERT_TRUE(matrixComparison(res, answer));
+    }
+}
+
+TEST(MPI_Fox, Fox_And_Naive_Have_The_Same_Answer37x37) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Matrix mat1, mat2;
+    if (rank == 0) {
+        mat1 = getRandomMatrix(37);
+        mat2 = getRandomMatrix(37);
+    }
+
+    auto res = foxAlgMPI(mat1, mat2);
+
+    if (rank == 0) {
+        ASSERT_TRUE(matrixComparison(res, naiveMultiplication(mat1, mat2)));
+    }
+}
+
+TEST(MPI_Cannon, Cannon_And_Naive_Have_The_Same_Answer37x37) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    Matrix mat1, mat2;
+    if (rank == 0) {
+        mat1 = getRandomMatrix(37);
+        mat2 = getRandomMatrix(37);
+    }
+
+    auto res = cannonAlgMPI(mat1, mat2);
+
+    if (rank == 0) {
+        ASSERT_TRUE(matrixComparison(res, naiveMultiplication(mat1, mat2)));
+    }
+}
+
+TEST(MPI_Cannon, Cannon25D_And_Naive_Have_The_Same_Answer) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    Matrix mat1, mat2;
+    if (rank == 0) {
+        mat1 = getRandomMatrix(40);
+        mat2 = getRandomMatrix(40);
+    }
+
+    for (int layers = 1; layers <= size; ++layers) {
+        auto res = cannon25DAlgMPI(mat1, mat2, layers);
+        if (rank == 0) {
+            ASSERT_TRUE(matrixComparison(res, naiveMultiplication(mat1, mat2)));
+        }
+    }
+}
+
+TEST(MPI_Cannon, DISABLED_Cannon_Vs_Cannon25D512x512) {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    Matrix mat1, mat2;
+    if (rank == 0) {
+        mat1 = getRandomMatrix(512);
+        mat2 = getRandomMatrix(512);
+    }
+
+    double start = MPI_Wtime();
+    auto res1 = foxAlgMPI(mat1, mat2);
+    double end = MPI_Wtime();
+    if (rank == 0)
+        std::cout << "Fox: " << end - start << std::endl;
+
+    start = MPI_Wtime();
+    auto res2 = cannonAlgMPI(mat1, mat2);
+    end = MPI_Wtime();
+    if (rank == 0)
+        std::cout << "Cannon: " << end - start << std::endl;
+
+    for (int layers = 2; layers * 4 <= size; ++layers) {
+        start = MPI_Wtime();
+        auto res3 = cannon25DAlgMPI(mat1, mat2, layers);
+        end = MPI_Wtime();
+        if (rank == 0) {
+            std::cout << "Cannon 2.5D, " << layers << " layers: "
+                      << end - start << std::endl;
+            ASSERT_TRUE(matrixComparison(res2, res3));
+        }
+    }
+
+    if (rank == 0) {
+        ASSERT_TRUE(matrixComparison(res1, res2));
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    MPI_Init(&argc, &argv);
+
+    ::testing::AddGlobalTestEnvironment(new GTestMPIListener::MPIEnvironment);
+    ::testing::TestEventListeners& listeners =
+        ::testing::UnitTest::GetInstance()->listeners();
+
+    listeners.Release(listeners.default_result_printer());
+    listeners.Release(listeners.default_xml_generator());
+
+    listeners.Append(new GTestMPIListener::MPIMinimalistPrinter);
+    return RUN_ALL_TESTS();
+}
@@ -1,6 +1,9 @@
 // Copyright 2020 Maximova Irina
 #include "../../../modules/task_4/maximova_i_dijkstra_algorithm/dijkstra_algorithm.h"
+#include <algorithm>
+#include <condition_variable>
 #include <ctime>
+#include <functional>
 #include <iomanip>
 #include <mutex>
 #include <queue>
@@ -54,7 +57,33 @@ void Graph::createRandGraph() {
   numEdges = numEdgesNow;
 }
 
-std::vector<int> STD_Dijkstra_Alg(const Graph& graph, int sourceVertex) {
+std::vector<int> Seq_Dijkstra_Alg(const Graph& graph, int sourceVertex) {
+  int count_vertex = graph.getNumVertex();
+  std::vector<int> dist(count_vertex, INT8_MAX);
+  std::vector<bool> mark(count_vertex, false);
+  dist[sourceVertex] = 0;
+
+  for (int i = 0; i < count_vertex - 1; ++i) {
+    int vertex = -1;
+    int min_dist = INT8_MAX;
+    for (int v = 0; v < count_vertex; ++v)
+      if (!mark[v] && dist[v] < min_dist) {
+        min_dist = dist[v];
+        vertex = v;
+      }
+    if (vertex == -1) break;
+    mark[vertex] = true;
+    for (int v = 0; v < count_vertex; ++v) {
+      int weight = graph[vertex * count_vertex + v];
+      if (!mark[v] && weight != INT8_MAX && dist[vertex] + weight < dist[v])
+        dist[v] = dist[vertex] + weight;
+    }
+  }
+
+  return dist;
+}
+
+std::vector<int> STD_Dijkstra_Alg_Spawn(const Graph& graph, int sourceVertex) {
   int count_vertex = graph.getNumVertex();
   int count_th = count_threads;
   int cur_vertex;
@@ -93,3 +122,185 @@ std::vector<int> STD_Dijkstra_Alg(const Graph& graph, int sourceVertex) {
 
   return dist;
 }
+
+DijkstraWorkerPool::DijkstraWorkerPool(const Graph& _graph,
+                                       std::vector<int>* _dist,
+                                       int _countThreads)
+    : graph(_graph), dist(*_dist), countThreads(_countThreads),
+      candidates(_countThreads), generation(0), pending(0), stop(false) {
+  if (countThreads <= 0)
+    throw std::runtime_error("The number of threads must be > 0");
+  for (int i = 1; i < countThreads; ++i)
+    workers.emplace_back(&DijkstraWorkerPool::work, this, i);
+}
+
+DijkstraWorkerPool::~DijkstraWorkerPool() {
+  {
+    std::lock_guard<std::mutex> locker(mtx);
+    stop = true;
+  }
+  cvStart.notify_all();
+  for (auto& worker : workers) worker.join();
+}
+
+void DijkstraWorkerPool::relaxRange(int numth, int vertex, int vertexDist) {
+  int count_vertex = graph.getNumVertex();
+  int dose = count_vertex / countThreads;
+  int begin = numth * dose;
+  int end = (numth == countThreads - 1) ? count_vertex : begin + dose;
+  const int* row = &graph[vertex * count_vertex];
+  std::vector<std::pair<int, int>>& local = candidates[numth];
+
+  for (int v = begin; v < end; ++v)
+    if (row[v] != INT8_MAX && vertexDist + row[v] < dist[v]) {
+      dist[v] = vertexDist + row[v];
+      local.push_back(std::make_pair((-1) * dist[v], v));
+    }
+}
+
+void DijkstraWorkerPool::work(int numth) {
+  int seen = 0;
+  std::unique_lock<std::mutex> locker(mtx);
+  for (;;) {
+    cvStart.wait(locker, [&] { return stop || generation != seen; });
+    if (stop) return;
+    seen = generation;
+    locker.unlock();
+
+    phase(numth);
+
+    locker.lock();
+    if (--pending == 0) cvDone.notify_one();
+  }
+}
+
+void DijkstraWorkerPool::run(const std::function<void(int)>& job) {
+  {
+    std::lock_guard<std::mutex> locker(mtx);
+    phase = job;
+    pending = countThreads - 1;
+    ++generation;
+  }
+  cvStart.notify_all();
+
+  job(0);
+
+  std::unique_lock<std::mutex> locker(mtx);
+  cvDone.wait(locker, [&] { return pending == 0; });
+}
+
+void DijkstraWorkerPool::relax(int vertex, int vertexDist,
+                               std::priority_queue<std::pair<int, int>>* queue) {
+  run([&](int numth) { relaxRange(numth, vertex, vertexDist); });
+
+  for (auto& local : candidates) {
+    for (const auto& candidate : local) queue->push(candidate);
+    local.clear();
+  }
+}
+
+std::vector<int> STD_Dijkstra_Alg(const Graph& graph, int sourceVertex) {
+  int count_vertex = graph.getNumVertex();
+  std::vector<int> dist(count_vertex, INT8_MAX);
+  std::priority_queue<std::pair<int, int>> queue;
+  DijkstraWorkerPool pool(graph, &dist,
+                          std::min(count_threads, count_vertex));
+
+  dist[sourceVertex] = 0;
+  queue.push(std::make_pair(0, sourceVertex));
+  while (!queue.empty()) {
+    int cur_vertex = queue.top().second;
+    int cur_dist = (-1) * queue.top().first;
+    queue.pop();
+    if (cur_dist > dist[cur_vertex]) continue;
+
+    pool.relax(cur_vertex, cur_dist, &queue);
+  }
+
+  return dist;
+}
+
+static void relaxRequests(const Graph& graph, const std::vector<int>& vertices,
+                          int delta, bool light, const std::vector<int>& dist,
+                          DijkstraWorkerPool* pool,
+                          std::vector<std::pair<int, int>>* requests) {
+  int count_vertex = graph.getNumVertex();
+  int count = vertices.size();
+  int count_th = pool->getCountThreads();
+  std::vector<std::vector<std::pair<int, int>>> local(count_th);
+
+  auto relaxSlice = [&](int numth) {
+    for (int i = numth; i < count; i += count_th) {
+      int u = vertices[i];
+      int dist_u = dist[u];
+      for (int v = 0; v < count_vertex; ++v) {
+        int weight = graph[u * count_vertex + v];
+        if (v == u || weight == INT8_MAX || (weight <= delta) != light)
+          continue;
+        if (dist_u + weight < dist[v])
+          local[numth].push_back(std::make_pair(v, dist_u + weight));
+      }
+    }
+  };
+
+  // a single vertex is not worth waking the pool
+  if (count <= 1)
+    relaxSlice(0);
+  else
+    pool->run(relaxSlice);
+
+  for (const auto& buffer : local)
+    requests->insert(requests->end(), buffer.begin(), buffer.end());
+}
+
+std::vector<int> STD_Delta_Stepping_Alg(const Graph& graph, int sourceVertex,
+                                        int delta) {
+  if (delta <= 0) throw std::runtime_error("Delta must be > 0");
+  int count_vertex = graph.getNumVertex();
+  if (sourceVertex < 0 || sourceVertex >= count_vertex)
+    throw std::runtime_error("Wrong source vertex");
+
+  std::vector<int> dist(count_vertex, INT8_MAX);
+  std::vector<std::vector<int>> buckets(INT8_MAX / delta + 1);
+  std::vector<int> bucket_mark(count_vertex, -1);
+  std::vector<std::pair<int, int>> requests;
+  DijkstraWorkerPool pool(graph, &dist,
+                          std::min(count_threads, count_vertex));
+  dist[sourceVertex] = 0;
+  buckets[0].push_back(sourceVertex);
+
+  for (int i = 0; i < static_cast<int>(buckets.size()); ++i) {
+    std::vector<int> settled;
+    while (!buckets[i].empty()) {
+      std::vector<int> frontier;
+      std::vector<int> current;
+      frontier.swap(buckets[i]);
+      for (int v : frontier)
+        if (dist[v] / delta == i) {
+          current.push_back(v);
+          if (bucket_mark[v] != i) {
+            bucket_mark[v] = i;
+            settled.push_back(v);
+          }
+        }
+
+      requests.clear();
+      relaxRequests(graph, current, delta, true, dist, &pool, &requests);
+      for (const auto& request : requests)
+        if (request.second < dist[request.first]) {
+          dist[request.first] = request.second;
+          buckets[request.second / delta].push_back(request.first);
+        }
+    }
+
+    requests.clear();
+    relaxRequests(graph, settled, delta, false, dist, &pool, &requests);
+    for (const auto& request : requests)
+      if (request.second < dist[request.first]) {
+        dist[request.first] = request.second;
+        buckets[request.second / delta].push_back(request.first);
+      }
+  }
+
+  return dist;
+}
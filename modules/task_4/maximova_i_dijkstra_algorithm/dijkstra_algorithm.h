@@ -2,6 +2,12 @@
 #ifndef MODULES_TASK_4_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
 #define MODULES_TASK_4_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
 
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
 #include <vector>
 
 class Graph {
@@ -19,6 +25,48 @@ class Graph {
   const int& operator[](const int index) const { return linkedList[index]; }
 };
 
+// Persistent pool that runs one phase at a time on all of its threads: the
+// row of one settled vertex for STD_Dijkstra_Alg, the light or heavy
+// requests of a bucket for STD_Delta_Stepping_Alg. Threads are started once
+// and synchronized with a start/done barrier, the calling thread is number 0.
+class DijkstraWorkerPool {
+ private:
+  const Graph& graph;
+  std::vector<int>& dist;
+  int countThreads;
+  std::vector<std::thread> workers;
+  std::vector<std::vector<std::pair<int, int>>> candidates;
+
+  std::mutex mtx;
+  std::condition_variable cvStart;
+  std::condition_variable cvDone;
+  std::function<void(int)> phase;
+  int generation;
+  int pending;
+  bool stop;
+
+  void work(int numth);
+  void relaxRange(int numth, int vertex, int vertexDist);
+
+ public:
+  DijkstraWorkerPool(const Graph& _graph, std::vector<int>* _dist,
+                     int _countThreads);
+  ~DijkstraWorkerPool();
+  DijkstraWorkerPool(const DijkstraWorkerPool&) = delete;
+  DijkstraWorkerPool& operator=(const DijkstraWorkerPool&) = delete;
+
+  int getCountThreads() const { return countThreads; }
+  // Calls job(numth) for every numth in [0, countThreads) and waits for all
+  void run(const std::function<void(int)>& job);
+  void relax(int vertex, int vertexDist,
+             std::priority_queue<std::pair<int, int>>* queue);
+};
+
+std::vector<int> Seq_Dijkstra_Alg(const Graph& graph, int sourceVertex);
+std::vector<int> STD_Dijkstra_Alg_Spawn(const Graph& graph, int sourceVertex);
 std::vector<int> STD_Dijkstra_Alg(const Graph& graph, int sourceVertex);
+// Bucketed (delta-stepping) SSSP, returns the same distances as STD_Dijkstra_Alg
+std::vector<int> STD_Delta_Stepping_Alg(const Graph& graph, int sourceVertex,
+                                        int delta = 25);
 
 #endif  // MODULES_TASK_4_MAXIMOVA_I_DIJKSTRA_ALGORITHM_DIJKSTRA_ALGORITHM_H_
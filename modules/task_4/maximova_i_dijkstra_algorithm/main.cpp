@@ -1,5 +1,7 @@
 // Copyright 2020 Maximova Irina
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
 #include <vector>
 #include "./dijkstra_algorithm.h"
 
@@ -94,6 +96,125 @@ TEST(Dijkstra_Algorithm_STD, Test_Execute_Dijkstra_Alg_Unlinked_Graph) {
   ASSERT_EQ(algRes, currentRes);
 }
 
+TEST(Dijkstra_Algorithm_STD, Test_Pool_Equals_Seq_On_Random_Graph) {
+  int numVertex = 200;
+  int numEdges = 1000;
+  int sourceVertex = 7;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+
+  ASSERT_EQ(Seq_Dijkstra_Alg(graph, sourceVertex),
+            STD_Dijkstra_Alg(graph, sourceVertex));
+}
+
+TEST(Dijkstra_Algorithm_STD, Test_Pool_Error_Zero_Threads) {
+  Graph graph(5, 4);
+  std::vector<int> dist(5, INT8_MAX);
+
+  ASSERT_ANY_THROW(DijkstraWorkerPool pool(graph, &dist, 0));
+}
+
+TEST(Dijkstra_Algorithm_STD, Test_Pool_Single_Vertex_Graph) {
+  Graph graph(1, 0);
+  std::vector<int> currentRes = {0};
+
+  ASSERT_EQ(STD_Dijkstra_Alg(graph, 0), currentRes);
+}
+
+TEST(Dijkstra_Algorithm_STD, DISABLED_Test_Pool_Throughput) {
+  int numVertex = 3000;
+  int numEdges = 24000;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<int> seqRes = Seq_Dijkstra_Alg(graph, sourceVertex);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsedSeq = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  STD_Dijkstra_Alg_Spawn(graph, sourceVertex);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsedSpawn = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  std::vector<int> poolRes = STD_Dijkstra_Alg(graph, sourceVertex);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsedPool = end - start;
+
+  std::cout << "Vertex: " << numVertex << " Edges: " << numEdges << std::endl
+            << "\tSequential: " << elapsedSeq.count() << std::endl
+            << "\tThread per vertex: " << elapsedSpawn.count() << std::endl
+            << "\tWorker pool: " << elapsedPool.count() << std::endl
+            << "\tx" << (elapsedSpawn.count() / elapsedPool.count())
+            << " faster than thread per vertex" << std::endl;
+
+  ASSERT_EQ(seqRes, poolRes);
+}
+
+TEST(Dijkstra_Algorithm_STD, Test_Delta_Stepping_Linked_Graph) {
+  int numVertex = 5;
+  int numEdges = 5;
+  int sourceVertex = 1;
+
+  Graph graph(numVertex, numEdges);
+  graph.putEdge(0, 1, 3);
+  graph.putEdge(4, 1, 2);
+  graph.putEdge(4, 2, 1);
+  graph.putEdge(4, 3, 1);
+  graph.putEdge(3, 2, 4);
+  std::vector<int> algRes = STD_Delta_Stepping_Alg(graph, sourceVertex, 2);
+  std::vector<int> currentRes = {3, 0, 3, 3, 2};
+
+  ASSERT_EQ(algRes, currentRes);
+}
+
+TEST(Dijkstra_Algorithm_STD, Test_Delta_Stepping_Error_Wrong_Delta) {
+  Graph graph(5, 4);
+
+  ASSERT_ANY_THROW(STD_Delta_Stepping_Alg(graph, 0, 0));
+}
+
+TEST(Dijkstra_Algorithm_STD, Test_Delta_Stepping_Equals_Dijkstra) {
+  int numVertex = 150;
+  int numEdges = 600;
+  int sourceVertex = 3;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+  std::vector<int> dijkstraRes = STD_Dijkstra_Alg(graph, sourceVertex);
+
+  for (int delta : {1, 7, 25, 100, 200})
+    ASSERT_EQ(dijkstraRes, STD_Delta_Stepping_Alg(graph, sourceVertex, delta));
+}
+
+TEST(Dijkstra_Algorithm_STD, DISABLED_Test_Delta_Stepping_Time) {
+  int numVertex = 3000;
+  int numEdges = 24000;
+  int sourceVertex = 0;
+
+  Graph graph(numVertex, numEdges);
+  graph.createRandGraph();
+
+  auto start = std::chrono::high_resolution_clock::now();
+  std::vector<int> dijkstraRes = STD_Dijkstra_Alg(graph, sourceVertex);
+  auto end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsedDijkstra = end - start;
+
+  start = std::chrono::high_resolution_clock::now();
+  std::vector<int> deltaRes = STD_Delta_Stepping_Alg(graph, sourceVertex);
+  end = std::chrono::high_resolution_clock::now();
+  std::chrono::duration<double> elapsedDelta = end - start;
+
+  std::cout << "Dijkstra: " << elapsedDijkstra.count() << std::endl
+            << "Delta-stepping: " << elapsedDelta.count() << std::endl;
+
+  ASSERT_EQ(dijkstraRes, deltaRes);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
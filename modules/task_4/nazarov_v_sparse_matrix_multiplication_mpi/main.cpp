@@ -0,0 +1,124 @@
+// Copyright 2020 Nazarov Vladislav
+#include <gtest-mpi-listener.hpp>
+#include <gtest/gtest.h>
+#include <vector>
+#include "../../../modules/task_4/nazarov_v_sparse_matrix_multiplication_mpi/sparse_matrix_multiplication_mpi.h"
+
+TEST(Sparse_Matrix_Multiplication_MPI, Throws_On_Different_Sizes) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        a = CRS_Matrix(getRandomSparseMatrix(4, 5, 0.3));
+        b = CRS_Matrix(getRandomSparseMatrix(4, 5, 0.3));
+    }
+    ASSERT_ANY_THROW(multiplyMPI(a, b));
+}
+
+TEST(Sparse_Matrix_Multiplication_MPI, Multiplication_4x4) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        a = CRS_Matrix({
+            { cpx(0, 9), cpx(0, 0), cpx(0, 0), cpx(3, 9) },
+            { cpx(10, 3), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+            { cpx(0, 0), cpx(21, 5), cpx(0, 0), cpx(0, 0) },
+            { cpx(0, 0), cpx(0, 0), cpx(33, 2), cpx(0, 0) },
+        });
+        b = CRS_Matrix({
+            { cpx(0, 0), cpx(0, 0), cpx(0, 0), cpx(0, 4) },
+            { cpx(4, 5), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+            { cpx(8, 1), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+            { cpx(0, 0), cpx(0, 0), cpx(12, 9), cpx(0, 0) },
+        });
+    }
+    CRS_Matrix res = multiplyMPI(a, b);
+    if (rank == 0) {
+        CRS_Matrix expected({
+            { cpx(0, 0), cpx(0, 0), cpx(-45, 135), cpx(-36, 0)},
+            { cpx(0, 0), cpx(0, 0), cpx(0, 0), cpx(-12, 40) },
+            { cpx(59, 125), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+            { cpx(262, 49), cpx(0, 0), cpx(0, 0), cpx(0, 0) },
+        });
+        EXPECT_EQ(res, expected);
+    }
+}
+
+TEST(Sparse_Matrix_Multiplication_MPI, Fewer_Rows_Than_Processes) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        a = CRS_Matrix({{ cpx(0, 0), cpx(3, 4), cpx(0, 0) }});
+        b = CRS_Matrix({
+            { cpx(1, 0), cpx(0, 0) },
+            { cpx(0, 0), cpx(2, 1) },
+            { cpx(5, 5), cpx(0, 0) },
+        });
+    }
+    CRS_Matrix res = multiplyMPI(a, b);
+    if (rank == 0) {
+        EXPECT_EQ(res, a * b.transpose());
+    }
+}
+
+TEST(Sparse_Matrix_Multiplication_MPI, Random_Rectangular) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        a = CRS_Matrix(getRandomSparseMatrix(40, 50, 0.05));
+        b = CRS_Matrix(getRandomSparseMatrix(60, 40, 0.05));
+    }
+    CRS_Matrix res = multiplyMPI(a, b);
+    if (rank == 0) {
+        EXPECT_EQ(res, a * b.transpose());
+    }
+}
+
+TEST(Sparse_Matrix_Multiplication_MPI, Random_Square) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        a = CRS_Matrix(getRandomSparseMatrix(200, 200, 0.02));
+        b = CRS_Matrix(getRandomSparseMatrix(200, 200, 0.02));
+    }
+    CRS_Matrix res = multiplyMPI(a, b);
+    if (rank == 0) {
+        EXPECT_EQ(res, a * b.transpose());
+    }
+}
+
+TEST(Sparse_Matrix_Multiplication_MPI, Random_Dense_Rows_And_Naive) {
+    int rank;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    std::vector<std::vector<cpx>> mat1, mat2;
+    CRS_Matrix a, b;
+    if (rank == 0) {
+        mat1 = getRandomSparseMatrix(30, 25, 0.6);
+        mat2 = getRandomSparseMatrix(35, 30, 0.6);
+        a = CRS_Matrix(mat1);
+        b = CRS_Matrix(mat2);
+    }
+    CRS_Matrix res = multiplyMPI(a, b);
+    if (rank == 0) {
+        EXPECT_EQ(res, CRS_Matrix(naiveMultiplication(mat1, mat2)));
+    }
+}
+
+int main(int argc, char** argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    MPI_Init(&argc, &argv);
+
+    ::testing::AddGlobalTestEnvironment(new GTestMPIListener::MPIEnvironment);
+    ::testing::TestEventListeners& listeners =
+        ::testing::UnitTest::GetInstance()->listeners();
+
+    listeners.Release(listeners.default_result_printer());
+    listeners.Release(listeners.default_xml_generator());
+
+    listeners.Append(new GTestMPIListener::MPIMinimalistPrinter);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,418 @@
+// Copyright 2020 Nazarov Vladislav
+
+#include <algorithm>
+#include <vector>
+#include <stdexcept>
+#include <random>
+#include <set>
+#include <utility>
+#include "../../../modules/task_4/nazarov_v_sparse_matrix_multiplication_mpi/sparse_matrix_multiplication_mpi.h"
+
+CRS_Matrix::CRS_Matrix(const std::vector<std::vector<cpx>>& matrix) {
+    row = matrix.size();
+    col = matrix[0].size();
+    for (const auto& elem : matrix)
+        if (elem.size() != col)
+            throw std::runtime_error("Different numbers of columns");
+    size_t NonZeroCounter = 0;
+    rowIndex.push_back(0);
+
+    for (size_t i = 0; i < row; ++i) {
+        for (size_t j = 0; j < col; ++j)
+            if ((std::abs(matrix[i][j].real()) > pow(10, -9)) || (std::abs(matrix[i][j].imag()) > pow(10, -9))) {
+                val.push_back(matrix[i][j]);
+                colIndex.push_back(j);
+                NonZeroCounter++;
+            }
+        rowIndex.push_back(NonZeroCounter);
+    }
+}
+
+bool CRS_Matrix::operator== (const CRS_Matrix& mat) const& {
+    if ((row != mat.row) || (col != mat.col) || (colIndex != mat.colIndex) ||
+       (rowIndex != mat.rowIndex) || (val.size() != mat.val.size()))
+        return false;
+    for (size_t i = 0; i < val.size(); ++i) {
+        if ((std::abs(val[i].real()-mat.val[i].real()) > pow(10, -9)) ||
+            (std::abs(val[i].imag()-mat.val[i].imag()) > pow(10, -9)) )
+            return false;
+    }
+    return true;
+}
+
+CRS_Matrix CRS_Matrix::operator* (const CRS_Matrix& mat) const& {
+    CRS_Matrix res;
+    res.rowIndex.push_back(0);
+    res.row = row;
+    res.col = mat.row;
+    size_t NonZeroCounter = 0;
+    if (col != mat.col)
+        throw std::runtime_error("Different numbers of cols");
+    for (size_t i = 1; i < rowIndex.size(); ++i) {
+        std::vector<cpx> tmpVec;
+        std::vector<size_t> tmpCol;
+        for (size_t j = 1; j < mat.rowIndex.size(); ++j) {
+            cpx sum = 0;
+            size_t lhsIter = rowIndex[i-1], rhsIter = mat.rowIndex[j-1];
+            while ((lhsIter < rowIndex[i]) && (rhsIter < mat.rowIndex[j])) {
+                if (colIndex[lhsIter] == mat.colIndex[rhsIter]) {
+                    sum += val[lhsIter++] * mat.val[rhsIter++];
+                } else {
+                    if (colIndex[lhsIter] < mat.colIndex[rhsIter])
+                        lhsIter++;
+                    else
+                        rhsIter++;
+                }
+            }
+            if (std::abs(sum.real()) > pow(10, -9) || std::abs(sum.imag()) > pow(10, -9)) {
+                tmpVec.push_back(sum);
+                tmpCol.push_back(j-1);
+                NonZeroCounter++;
+            }
+        }
+        for (const auto& elem : tmpVec)
+            res.val.push_back(elem);
+        for (const auto& elem : tmpCol)
+            res.colIndex.push_back(elem);
+        res.rowIndex.push_back(NonZeroCounter);
+    }
+    return res;
+}
+
+CRS_Matrix CRS_Matrix::transpose() {
+    std::vector<std::vector<size_t>> index(col);
+    std::vector<std::vector<cpx>> values(col);
+    for (size_t i = 1; i < rowIndex.size(); ++i)
+        for (size_t j = rowIndex[i-1]; j < rowIndex[i]; ++j) {
+            index[colIndex[j]].push_back(i-1);
+            values[colIndex[j]].push_back(val[j]);
+        }
+    CRS_Matrix res;
+    res.col = row;
+    res.row = col;
+    size_t size = 0;
+    res.rowIndex.push_back(0);
+    for (size_t i = 0; i < col; ++i) {
+        for (size_t j = 0; j < index[i].size(); ++j) {
+            res.val.push_back(values[i][j]);
+            res.colIndex.push_back(index[i][j]);
+        }
+        size += index[i].size();
+        res.rowIndex.push_back(size);
+    }
+    return res;
+}
+
+void CRS_Matrix::print() {
+    std::cout << "Value = [ ";
+    for (const auto& elem : val)
+        std::cout << elem << " ";
+    std::cout << "] " << std::endl << "Col_Index = [ ";
+    for (const auto& elem : colIndex)
+        std::cout << elem << " ";
+    std::cout << "] " << std::endl << "Row_Index = [ ";
+    for (const auto& elem : rowIndex)
+        std::cout << elem << " ";
+    std::cout << "] " << std::endl;
+}
+
+std::vector<std::vector<cpx>> naiveMultiplication(const std::vector<std::vector<cpx>>& matrix1,
+    const std::vector<std::vector<cpx>>& matrix2) {
+    if (matrix1[0].size() != matrix2.size())
+    throw std::runtime_error("Different numbers of cols");
+    std::vector<std::vector<cpx>> res(matrix1.size(), std::vector<cpx>(matrix2[0].size()));
+    for (size_t i = 0; i < matrix1.size(); ++i)
+        for (size_t j = 0; j < matrix2[0].size(); ++j) {
+            res[i][j] = 0;
+            for (size_t k = 0; k < matrix1[0].size(); ++k)
+                res[i][j] += matrix1[i][k] * matrix2[k][j];
+        }
+    return res;
+}
+
+std::vector<std::vector<cpx>> getRandomSparseMatrix(const size_t& col, const size_t& row, const double& percent) {
+    if ((percent > 1) || (percent < 0))
+        throw std::runtime_error("Invalid parameters");
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<> disComplex(0, 10);
+    std::uniform_int_distribution<> disRow(0, row-1);
+    std::uniform_int_distribution<> disCol(0, col-1);
+    std::set<std::pair<int, int>> index;
+    size_t num = static_cast<size_t>(col*row*percent);
+    if (num < 1)
+        num++;
+    while (index.size() < num)
+        index.insert(std::pair<int, int>(disRow(gen), disCol(gen)));
+    std::vector<std::vector<cpx>> res(row, std::vector<cpx>(col, cpx(0, 0)));
+    for (const std::pair<int, int>& elem : index)
+        res[elem.first][elem.second] = cpx(disComplex(gen), disComplex(gen));
+    return res;
+}
+
+namespace {
+
+// Rows [blockStart(n, size, r), blockStart(n, size, r + 1)) belong to rank r
+int blockStart(int n, int size, int r) {
+    return n / size * r + std::min(r, n % size);
+}
+
+int blockOwner(int n, int size, int k) {
+    int base = n / size, rem = n % size;
+    if (k < rem * (base + 1))
+        return k / (base + 1);
+    return rem + (k - rem * (base + 1)) / base;
+}
+
+// Rows of a matrix with local row numbers, the columns are global
+struct RowBlock {
+    std::vector<int> rowIndex;
+    std::vector<int> colIndex;
+    std::vector<cpx> val;
+};
+
+// Complex values travel as pairs of doubles
+double* doubles(std::vector<cpx>* vec) {
+    return reinterpret_cast<double*>(vec->data());
+}
+
+std::vector<int> doubled(const std::vector<int>& counts) {
+    std::vector<int> res(counts.size());
+    for (size_t i = 0; i < counts.size(); ++i)
+        res[i] = 2 * counts[i];
+    return res;
+}
+
+std::vector<int> prefixSum(const std::vector<int>& counts) {
+    std::vector<int> res(counts.size() + 1, 0);
+    for (size_t i = 0; i < counts.size(); ++i)
+        res[i + 1] = res[i] + counts[i];
+    return res;
+}
+
+// Sends every rank its block of rows of the matrix held by rank 0
+RowBlock scatterRows(const std::vector<size_t>& rowIndex, const std::vector<size_t>& colIndex,
+    const std::vector<cpx>& val, int rows, MPI_Comm comm) {
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+    std::vector<int> rowCounts(size), rowDispls(size), nnzCounts(size), nnzDispls(size);
+    for (int r = 0; r < size; ++r) {
+        rowDispls[r] = blockStart(rows, size, r);
+        rowCounts[r] = blockStart(rows, size, r + 1) - rowDispls[r];
+    }
+    std::vector<int> lengths, cols;
+    std::vector<cpx> vals;
+    if (rank == 0 && !rowIndex.empty()) {
+        for (int r = 0; r < size; ++r) {
+            nnzDispls[r] = static_cast<int>(rowIndex[rowDispls[r]]);
+            nnzCounts[r] = static_cast<int>(rowIndex[rowDispls[r] + rowCounts[r]]) - nnzDispls[r];
+        }
+        lengths.resize(rows);
+        for (int i = 0; i < rows; ++i)
+            lengths[i] = static_cast<int>(rowIndex[i + 1] - rowIndex[i]);
+        cols.assign(colIndex.begin(), colIndex.end());
+        vals = val;
+    }
+    int localNnz;
+    MPI_Scatter(nnzCounts.data(), 1, MPI_INT, &localNnz, 1, MPI_INT, 0, comm);
+
+    RowBlock block;
+    std::vector<int> localLengths(rowCounts[rank]);
+    MPI_Scatterv(lengths.data(), rowCounts.data(), rowDispls.data(), MPI_INT,
+        localLengths.data(), rowCounts[rank], MPI_INT, 0, comm);
+    block.rowIndex = prefixSum(localLengths);
+    block.colIndex.resize(localNnz);
+    MPI_Scatterv(cols.data(), nnzCounts.data(), nnzDispls.data(), MPI_INT,
+        block.colIndex.data(), localNnz, MPI_INT, 0, comm);
+    block.val.resize(localNnz);
+    std::vector<int> valCounts = doubled(nnzCounts), valDispls = doubled(nnzDispls);
+    MPI_Scatterv(doubles(&vals), valCounts.data(), valDispls.data(), MPI_DOUBLE,
+        doubles(&block.val), 2 * localNnz, MPI_DOUBLE, 0, comm);
+    return block;
+}
+
+// Collects the rows of a block of A and of the rows of B it refers to: on
+// return the columns of a are positions in the returned block of B rows,
+// which holds every referenced row once, in increasing order. Each rank is
+// asked only for the rows it owns, the local ones are copied.
+RowBlock fetchRows(RowBlock* a, const RowBlock& b, int rowsB, MPI_Comm comm) {
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+    int firstB = blockStart(rowsB, size, rank);
+
+    std::vector<int> needed(a->colIndex);
+    std::sort(needed.begin(), needed.end());
+    needed.erase(std::unique(needed.begin(), needed.end()), needed.end());
+    for (auto& c : a->colIndex)
+        c = static_cast<int>(std::lower_bound(needed.begin(), needed.end(), c) - needed.begin());
+
+    // needed is sorted and the blocks are contiguous, so the rows asked from
+    // a rank are a slice of it
+    std::vector<int> reqCounts(size, 0), reqDispls(size, 0), owner(needed.size());
+    for (size_t i = 0; i < needed.size(); ++i) {
+        owner[i] = blockOwner(rowsB, size, needed[i]);
+        if (reqCounts[owner[i]]++ == 0)
+            reqDispls[owner[i]] = static_cast<int>(i);
+    }
+    reqCounts[rank] = 0;
+
+    std::vector<int> inCounts(size);
+    MPI_Alltoall(reqCounts.data(), 1, MPI_INT, inCounts.data(), 1, MPI_INT, comm);
+    std::vector<int> inDispls = prefixSum(inCounts);
+    std::vector<int> inRows(inDispls[size]);
+    MPI_Alltoallv(needed.data(), reqCounts.data(), reqDispls.data(), MPI_INT,
+        inRows.data(), inCounts.data(), inDispls.data(), MPI_INT, comm);
+
+    // Lengths of the asked rows first, so the receivers can size the buffers
+    std::vector<int> outLengths(inRows.size());
+    std::vector<int> outNnz(size, 0);
+    for (int r = 0; r < size; ++r)
+        for (int i = inDispls[r]; i < inDispls[r + 1]; ++i) {
+            int k = inRows[i] - firstB;
+            outLengths[i] = b.rowIndex[k + 1] - b.rowIndex[k];
+            outNnz[r] += outLengths[i];
+        }
+    std::vector<int> recvLengths(needed.size(), 0);
+    MPI_Alltoallv(outLengths.data(), inCounts.data(), inDispls.data(), MPI_INT,
+        recvLengths.data(), reqCounts.data(), reqDispls.data(), MPI_INT, comm);
+
+    std::vector<int> outNnzDispls = prefixSum(outNnz);
+    std::vector<int> outCols(outNnzDispls[size]);
+    std::vector<cpx> outVals(outNnzDispls[size]);
+    int pos = 0;
+    for (size_t i = 0; i < inRows.size(); ++i) {
+        int k = inRows[i] - firstB;
+        for (int j = b.rowIndex[k]; j < b.rowIndex[k + 1]; ++j, ++pos) {
+            outCols[pos] = b.colIndex[j];
+            outVals[pos] = b.val[j];
+        }
+    }
+    std::vector<int> recvNnz(size, 0);
+    for (size_t i = 0; i < needed.size(); ++i)
+        if (owner[i] != rank)
+            recvNnz[owner[i]] += recvLengths[i];
+    std::vector<int> recvNnzDispls = prefixSum(recvNnz);
+    std::vector<int> recvCols(recvNnzDispls[size]);
+    std::vector<cpx> recvVals(recvNnzDispls[size]);
+    MPI_Alltoallv(outCols.data(), outNnz.data(), outNnzDispls.data(), MPI_INT,
+        recvCols.data(), recvNnz.data(), recvNnzDispls.data(), MPI_INT, comm);
+    std::vector<int> outValCounts = doubled(outNnz), outValDispls = doubled(outNnzDispls);
+    std::vector<int> recvValCounts = doubled(recvNnz), recvValDispls = doubled(recvNnzDispls);
+    MPI_Alltoallv(doubles(&outVals), outValCounts.data(), outValDispls.data(), MPI_DOUBLE,
+        doubles(&recvVals), recvValCounts.data(), recvValDispls.data(), MPI_DOUBLE, comm);
+
+    // The received rows come in the order of needed with the local ones left out
+    RowBlock res;
+    res.rowIndex.assign(1, 0);
+    pos = 0;
+    for (size_t i = 0; i < needed.size(); ++i) {
+        if (owner[i] == rank) {
+            int k = needed[i] - firstB;
+            res.colIndex.insert(res.colIndex.end(), b.colIndex.begin() + b.rowIndex[k],
+                b.colIndex.begin() + b.rowIndex[k + 1]);
+            res.val.insert(res.val.end(), b.val.begin() + b.rowIndex[k], b.val.begin() + b.rowIndex[k + 1]);
+        } else {
+            res.colIndex.insert(res.colIndex.end(), recvCols.begin() + pos, recvCols.begin() + pos + recvLengths[i]);
+            res.val.insert(res.val.end(), recvVals.begin() + pos, recvVals.begin() + pos + recvLengths[i]);
+            pos += recvLengths[i];
+        }
+        res.rowIndex.push_back(static_cast<int>(res.colIndex.size()));
+    }
+    return res;
+}
+
+// Row by row product with a dense accumulator. Every element of the result
+// sums its terms in the same order as operator*, and small elements are
+// dropped the same way.
+RowBlock multiplyRows(const RowBlock& a, const RowBlock& b, int colsB) {
+    RowBlock res;
+    res.rowIndex.assign(1, 0);
+    std::vector<cpx> acc(colsB, 0);
+    std::vector<int> mark(colsB, -1);
+    std::vector<int> touched;
+    int rows = static_cast<int>(a.rowIndex.size()) - 1;
+    for (int i = 0; i < rows; ++i) {
+        touched.clear();
+        for (int j = a.rowIndex[i]; j < a.rowIndex[i + 1]; ++j) {
+            int k = a.colIndex[j];
+            for (int t = b.rowIndex[k]; t < b.rowIndex[k + 1]; ++t) {
+                int c = b.colIndex[t];
+                if (mark[c] != i) {
+                    mark[c] = i;
+                    acc[c] = 0;
+                    touched.push_back(c);
+                }
+                acc[c] += a.val[j] * b.val[t];
+            }
+        }
+        std::sort(touched.begin(), touched.end());
+        for (int c : touched)
+            if (std::abs(acc[c].real()) > pow(10, -9) || std::abs(acc[c].imag()) > pow(10, -9)) {
+                res.colIndex.push_back(c);
+                res.val.push_back(acc[c]);
+            }
+        res.rowIndex.push_back(static_cast<int>(res.colIndex.size()));
+    }
+    return res;
+}
+
+}  // namespace
+
+CRS_Matrix multiplyMPI(const CRS_Matrix& matA, const CRS_Matrix& matB, MPI_Comm comm) {
+    int size, rank;
+    MPI_Comm_size(comm, &size);
+    MPI_Comm_rank(comm, &rank);
+    int dims[4] = {0, 0, 0, 0};
+    if (rank == 0) {
+        dims[0] = static_cast<int>(matA.row);
+        dims[1] = static_cast<int>(matA.col);
+        dims[2] = static_cast<int>(matB.row);
+        dims[3] = static_cast<int>(matB.col);
+    }
+    MPI_Bcast(dims, 4, MPI_INT, 0, comm);
+    if (dims[1] != dims[2])
+        throw std::runtime_error("Different numbers of cols");
+    int rowsA = dims[0], rowsB = dims[2], colsB = dims[3];
+
+    RowBlock a = scatterRows(matA.rowIndex, matA.colIndex, matA.val, rowsA, comm);
+    RowBlock b = scatterRows(matB.rowIndex, matB.colIndex, matB.val, rowsB, comm);
+    RowBlock halo = fetchRows(&a, b, rowsB, comm);
+    RowBlock c = multiplyRows(a, halo, colsB);
+
+    std::vector<int> rowCounts(size), rowDispls(size);
+    for (int r = 0; r < size; ++r) {
+        rowDispls[r] = blockStart(rowsA, size, r);
+        rowCounts[r] = blockStart(rowsA, size, r + 1) - rowDispls[r];
+    }
+    std::vector<int> localLengths(rowCounts[rank]);
+    for (int i = 0; i < rowCounts[rank]; ++i)
+        localLengths[i] = c.rowIndex[i + 1] - c.rowIndex[i];
+    int localNnz = c.rowIndex.back();
+
+    std::vector<int> lengths(rank == 0 ? rowsA : 0), nnzCounts(size);
+    MPI_Gatherv(localLengths.data(), rowCounts[rank], MPI_INT,
+        lengths.data(), rowCounts.data(), rowDispls.data(), MPI_INT, 0, comm);
+    MPI_Gather(&localNnz, 1, MPI_INT, nnzCounts.data(), 1, MPI_INT, 0, comm);
+    std::vector<int> nnzDispls = prefixSum(nnzCounts);
+    std::vector<int> cols(rank == 0 ? nnzDispls[size] : 0);
+    std::vector<cpx> vals(cols.size());
+    MPI_Gatherv(c.colIndex.data(), localNnz, MPI_INT,
+        cols.data(), nnzCounts.data(), nnzDispls.data(), MPI_INT, 0, comm);
+    std::vector<int> valCounts = doubled(nnzCounts), valDispls = doubled(nnzDispls);
+    MPI_Gatherv(doubles(&c.val), 2 * localNnz, MPI_DOUBLE,
+        doubles(&vals), valCounts.data(), valDispls.data(), MPI_DOUBLE, 0, comm);
+
+    if (rank != 0)
+        return CRS_Matrix();
+    CRS_Matrix res;
+    res.row = rowsA;
+    res.col = colsB;
+    res.val = vals;
+    res.colIndex.assign(cols.begin(), cols.end());
+    res.rowIndex.assign(1, 0);
+    for (int i = 0; i < rowsA; ++i)
+        res.rowIndex.push_back(res.rowIndex.back() + lengths[i]);
+    return res;
+}
@@ -113,6 +113,91 @@ TEST(Parallel, Matrix_128x128) {
   }
 }
 
+TEST(Parallel, Matrix_256x256_One_Recursion_Level) {
+  const int kSize = 256;
+  std::vector<double> a(kSize * kSize);
+  std::vector<double> b(kSize * kSize);
+  std::vector<double> result(kSize * kSize);
+  std::vector<double> expected(kSize * kSize);
+
+  for (int i = 0; i < kSize * kSize; i++) {
+    a[i] = (i % 17) - 8;
+    b[i] = (i % 13) - 6;
+  }
+  multSeq(kSize, a.data(), b.data(), expected.data());
+
+  strassenMultStdThread(kSize, a.data(), b.data(), result.data());
+
+  for (int i = 0; i < kSize * kSize; i++) {
+    ASSERT_NEAR(expected[i], result[i], 1e-9);
+  }
+}
+
+TEST(Parallel, Workspace_Size) {
+  ASSERT_EQ(strassenWorkspaceSize(128), 0u);
+  ASSERT_EQ(strassenWorkspaceSize(256), 7u * 3 * 128 * 128);
+  ASSERT_EQ(strassenWorkspaceSize(512, 1),
+            7u * (3 * 256 * 256 + 3 * 128 * 128));
+  ASSERT_EQ(strassenWorkspaceSize(512, 2),
+            7u * (3 * 256 * 256 + 7 * 3 * 128 * 128));
+}
+
+TEST(Parallel, Same_Result_For_Any_Task_Depth_And_Threads) {
+  const int kSize = 512;
+  std::vector<double> a(kSize * kSize);
+  std::vector<double> b(kSize * kSize);
+  std::vector<double> result(kSize * kSize);
+  std::vector<double> expected(kSize * kSize);
+
+  for (int i = 0; i < kSize * kSize; i++) {
+    a[i] = (i % 17) - 8;
+    b[i] = (i % 13) - 6;
+  }
+  multSeq(kSize, a.data(), b.data(), expected.data());
+
+  for (int depth = 0; depth <= 2; depth++) {
+    for (int threads = 1; threads <= 4; threads *= 2) {
+      strassenMultStdThread(kSize, a.data(), b.data(), result.data(), depth,
+                            threads);
+      ASSERT_EQ(expected, result);
+    }
+  }
+}
+
+TEST(Parallel, Throws_On_Negative_Task_Depth) {
+  std::vector<double> a(4 * 4), b(4 * 4), result(4 * 4);
+
+  ASSERT_ANY_THROW(
+      strassenMultStdThread(4, a.data(), b.data(), result.data(), -1));
+}
+
+TEST(Parallel, Throws_On_Not_Power_Of_2) {
+  std::vector<double> a(6 * 6), b(6 * 6), result(6 * 6);
+
+  ASSERT_ANY_THROW(strassenMultStdThread(6, a.data(), b.data(), result.data()));
+}
+
+TEST(Parallel, DISABLED_Task_Depth_1024x1024) {
+  const int kSize = 1024;
+  std::vector<double> a(kSize * kSize);
+  std::vector<double> b(kSize * kSize);
+  std::vector<double> result(kSize * kSize);
+
+  for (int i = 0; i < kSize * kSize; i++) {
+    a[i] = i + 1;
+    b[i] = kSize * kSize - i;
+  }
+
+  for (int depth = 0; depth <= 3; depth++) {
+    auto start = std::chrono::high_resolution_clock::now();
+    strassenMultStdThread(kSize, a.data(), b.data(), result.data(), depth);
+    auto end = std::chrono::high_resolution_clock::now();
+    std::chrono::duration<double> elapsed = end - start;
+    std::cout << "Task depth " << depth << ": " << elapsed.count()
+              << std::endl;
+  }
+}
+
 TEST(Parallel, DISABLED_Matrix_256x256) {
   const int kSize = 256;
   std::vector<double> a(kSize * kSize);
@@ -2,36 +2,338 @@
 
 #include "../../../modules/task_4/zhivaev_a_strassen/strassen_std_thread.h"
 
+#include <algorithm>
+#include <atomic>
 #include <bitset>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 
-void multSeq(int size, const double* a, const double* b, double* result);
+namespace {
+
+const int kBaseSize = 128;
+
+// Square block of a row-major matrix, element (i, j) is data[i * stride + j]
+struct View {
+  double* data;
+  int stride;
+
+  View quadrant(int half, int row, int col) const {
+    return {data + row * half * stride + col * half, stride};
+  }
+};
+
+struct ConstView {
+  const double* data;
+  int stride;
+
+  ConstView(const double* _data, int _stride) : data(_data), stride(_stride) {}
+  ConstView(const View& v) : data(v.data), stride(v.stride) {}  // NOLINT
+
+  ConstView quadrant(int half, int row, int col) const {
+    return {data + row * half * stride + col * half, stride};
+  }
+};
+
+// Stack allocator over a buffer that is sized once before the recursion
+class Workspace {
+ public:
+  Workspace(double* base, size_t capacity)
+      : base_(base), capacity_(capacity), top_(0) {}
+
+  View take(int size) {
+    size_t length = static_cast<size_t>(size) * size;
+    if (top_ + length > capacity_) {
+      throw std::logic_error("Strassen workspace is too small");
+    }
+    View v = {base_ + top_, size};
+    top_ += length;
+    return v;
+  }
+  size_t mark() const { return top_; }
+  void release(size_t mark) { top_ = mark; }
+
+ private:
+  double* base_;
+  size_t capacity_;
+  size_t top_;
+};
+
+void multBlock(int size, ConstView a, ConstView b, View c) {
+  for (int i = 0; i < size; i++) {
+    double* cRow = c.data + i * c.stride;
+    for (int j = 0; j < size; j++) {
+      cRow[j] = 0.0;
+    }
+    for (int k = 0; k < size; k++) {
+      const double aik = a.data[i * a.stride + k];
+      const double* bRow = b.data + k * b.stride;
+      for (int j = 0; j < size; j++) {
+        cRow[j] += aik * bRow[j];
+      }
+    }
+  }
+}
+
+// result = x + sign * y
+void addBlock(int size, ConstView x, ConstView y, double sign, View result) {
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      result.data[i * result.stride + j] =
+          x.data[i * x.stride + j] + sign * y.data[i * y.stride + j];
+    }
+  }
+}
+
+// result (+)= sign * x
+void accumulateBlock(int size, ConstView x, double sign, bool assign,
+                     View result) {
+  for (int i = 0; i < size; i++) {
+    for (int j = 0; j < size; j++) {
+      double& r = result.data[i * result.stride + j];
+      r = (assign ? 0.0 : r) + sign * x.data[i * x.stride + j];
+    }
+  }
+}
 
-void strassenRecursivePart(int size, const double* a, const double* b,
-                           double* result);
+// Describes M_k = (A[a1] + aSign * A[a2]) (B[b1] + bSign * B[b2]); a sign of 0
+// means the operand is a single quadrant and is used without copying.
+struct Product {
+  int a1, a2;
+  double aSign;
+  int b1, b2;
+  double bSign;
+};
+
+// Quadrants are numbered 0 = 11, 1 = 12, 2 = 21, 3 = 22
+const Product kProducts[7] = {
+    {0, 3, 1.0, 0, 3, 1.0},    // M1 = (A11 + A22)(B11 + B22)
+    {2, 3, 1.0, 0, 0, 0.0},    // M2 = (A21 + A22)B11
+    {0, 0, 0.0, 1, 3, -1.0},   // M3 = A11(B12 - B22)
+    {3, 3, 0.0, 2, 0, -1.0},   // M4 = A22(B21 - B11)
+    {0, 1, 1.0, 3, 3, 0.0},    // M5 = (A11 + A12)B22
+    {2, 0, -1.0, 0, 1, 1.0},   // M6 = (A21 - A11)(B11 + B12)
+    {1, 3, -1.0, 2, 3, 1.0}};  // M7 = (A12 - A22)(B21 + B22)
+
+// Sign of M_k in C11, C12, C21, C22
+const double kCombine[7][4] = {{1, 0, 0, 1},  {0, 0, 1, -1}, {0, 1, 0, 1},
+                               {1, 0, 1, 0},  {-1, 1, 0, 0}, {0, 0, 0, 1},
+                               {1, 0, 0, 0}};
+
+size_t sequentialWorkspace(int size) {
+  if (size <= kBaseSize) {
+    return 0;
+  }
+  size_t half = size / 2;
+  return 3 * half * half + sequentialWorkspace(size / 2);
+}
 
-void splitMatrix(int size, const double* a, double* a11, double* a12,
-                 double* a21, double* a22);
+void strassenSequential(int size, ConstView a, ConstView b, View c,
+                        Workspace* ws);
+
+// Points left/right at the operands of M_k, summing quadrants into t1/t2
+// when the product needs it
+void productOperands(int half, const Product& p, ConstView a, ConstView b,
+                     View t1, View t2, ConstView* left, ConstView* right) {
+  *left = a.quadrant(half, p.a1 / 2, p.a1 % 2);
+  if (p.aSign != 0.0) {
+    addBlock(half, *left, a.quadrant(half, p.a2 / 2, p.a2 % 2), p.aSign, t1);
+    *left = t1;
+  }
+  *right = b.quadrant(half, p.b1 / 2, p.b1 % 2);
+  if (p.bSign != 0.0) {
+    addBlock(half, *right, b.quadrant(half, p.b2 / 2, p.b2 % 2), p.bSign, t2);
+    *right = t2;
+  }
+}
 
-void assembleMatrix(int size, double* a, const double* a11, const double* a12,
-                    const double* a21, const double* a22);
+// Computes M_k of the (a, b) product into m, using t1/t2 for operand sums
+void computeProduct(int half, const Product& p, ConstView a, ConstView b,
+                    View t1, View t2, View m, Workspace* ws) {
+  ConstView left = a;
+  ConstView right = b;
+  productOperands(half, p, a, b, t1, t2, &left, &right);
+  strassenSequential(half, left, right, m, ws);
+}
 
-// (A1 + A2)(B1 + B2)
-void strassen1(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result);
+void strassenSequential(int size, ConstView a, ConstView b, View c,
+                        Workspace* ws) {
+  if (size <= kBaseSize) {
+    multBlock(size, a, b, c);
+    return;
+  }
+  int half = size / 2;
+  size_t mark = ws->mark();
+  View t1 = ws->take(half);
+  View t2 = ws->take(half);
+  View m = ws->take(half);
+  bool assigned[4] = {false, false, false, false};
+
+  for (int k = 0; k < 7; k++) {
+    computeProduct(half, kProducts[k], a, b, t1, t2, m, ws);
+    for (int q = 0; q < 4; q++) {
+      if (kCombine[k][q] != 0.0) {
+        accumulateBlock(half, m, kCombine[k][q], !assigned[q],
+                        c.quadrant(half, q / 2, q % 2));
+        assigned[q] = true;
+      }
+    }
+  }
 
-// (A1 + A2)B
-void strassen2(int size, const double* a1, const double* a2, const double* b,
-               double* result);
+  ws->release(mark);
+}
 
-// A(B1 - B2)
-void strassen3(int size, const double* a, const double* b1, const double* b2,
-               double* result);
+size_t parallelWorkspace(int size, int taskDepth) {
+  if (size <= kBaseSize) {
+    return 0;
+  }
+  if (taskDepth <= 0) {
+    return sequentialWorkspace(size);
+  }
+  // Every spawned product owns its operand buffers, its result and the
+  // workspace of its own subtree
+  size_t half = size / 2;
+  return 7 * (3 * half * half + parallelWorkspace(size / 2, taskDepth - 1));
+}
 
-// (A1 - A2)(B1 + B2)
-void strassen4(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result);
+// Index of the deque owned by the current thread; the thread that calls
+// strassenMultStdThread always owns deque 0
+thread_local int currentQueue = 0;
+
+// Work-stealing pool: each thread pushes and pops its own tasks at the back
+// of its deque and steals from the front of the others when it runs dry
+class TaskPool {
+ public:
+  explicit TaskPool(int threads) : stop_(false) {
+    for (int i = 0; i < threads; i++) {
+      queues_.emplace_back(new Queue);
+    }
+    for (int i = 1; i < threads; i++) {
+      workers_.emplace_back([this, i] {
+        currentQueue = i;
+        while (!stop_) {
+          if (!runOne()) {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+  }
+
+  ~TaskPool() {
+    stop_ = true;
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  void spawn(std::function<void()> task, std::atomic<int>* pending) {
+    pending->fetch_add(1);
+    Queue& own = *queues_[currentQueue];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    own.tasks.emplace_back([task, pending] {
+      task();
+      pending->fetch_sub(1);
+    });
+  }
+
+  // Runs queued tasks until every task counted in pending has finished
+  void wait(const std::atomic<int>& pending) {
+    while (pending > 0) {
+      if (!runOne()) {
+        std::this_thread::yield();
+      }
+    }
+  }
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  bool runOne() {
+    std::function<void()> task;
+    int count = static_cast<int>(queues_.size());
+    for (int i = 0; i < count && !task; i++) {
+      Queue& queue = *queues_[(currentQueue + i) % count];
+      std::lock_guard<std::mutex> lock(queue.mutex);
+      if (queue.tasks.empty()) {
+        continue;
+      }
+      if (i == 0) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+      } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+    }
+    if (!task) {
+      return false;
+    }
+    task();
+    return true;
+  }
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<bool> stop_;
+};
+
+// Spawns the seven products as pool tasks for taskDepth levels and switches
+// to strassenSequential below; arena holds parallelWorkspace(size, taskDepth)
+void strassenTask(int size, ConstView a, ConstView b, View c, int taskDepth,
+                  double* arena, TaskPool* pool) {
+  if (size <= kBaseSize) {
+    multBlock(size, a, b, c);
+    return;
+  }
+  if (taskDepth <= 0) {
+    Workspace ws(arena, sequentialWorkspace(size));
+    strassenSequential(size, a, b, c, &ws);
+    return;
+  }
+
+  int half = size / 2;
+  size_t branchSize = parallelWorkspace(size, taskDepth) / 7;
+  View products[7];
+  std::atomic<int> pending(0);
+
+  for (int k = 0; k < 7; k++) {
+    pool->spawn([=, &products] {
+      Workspace ws(arena + k * branchSize, branchSize);
+      View t1 = ws.take(half);
+      View t2 = ws.take(half);
+      products[k] = ws.take(half);
+      ConstView left = a;
+      ConstView right = b;
+      productOperands(half, kProducts[k], a, b, t1, t2, &left, &right);
+      strassenTask(half, left, right, products[k], taskDepth - 1,
+                   arena + k * branchSize + ws.mark(), pool);
+    }, &pending);
+  }
+  pool->wait(pending);
+
+  for (int q = 0; q < 4; q++) {
+    bool assigned = false;
+    for (int k = 0; k < 7; k++) {
+      if (kCombine[k][q] != 0.0) {
+        accumulateBlock(half, products[k], kCombine[k][q], !assigned,
+                        c.quadrant(half, q / 2, q % 2));
+        assigned = true;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+void multSeq(int size, const double* a, const double* b, double* result);
 
 int powerOf2(int number);
 
@@ -83,196 +385,21 @@ int nextPowerOf2(int number) {
   return -1;
 }
 
-void splitMatrix(int size, const double* a, double* a11, double* a12,
-                 double* a21, double* a22) {
-  int fSize = size / 2;
-  for (int i = 0; i < fSize; i++) {
-    for (int j = 0; j < fSize; j++) {
-      a11[i * fSize + j] = a[i * size + j];
-      a12[i * fSize + j] = a[i * size + fSize + j];
-      a21[i * fSize + j] = a[(fSize + i) * size + j];
-      a22[i * fSize + j] = a[(fSize + i) * size + fSize + j];
-    }
-  }
-}
-
-void assembleMatrix(int size, double* a, const double* a11, const double* a12,
-                    const double* a21, const double* a22) {
-  int fSize = size / 2;
-  for (int i = 0; i < fSize; i++) {
-    for (int j = 0; j < fSize; j++) {
-      a[i * size + j] = a11[i * fSize + j];
-      a[i * size + fSize + j] = a12[i * fSize + j];
-      a[(fSize + i) * size + j] = a21[i * fSize + j];
-      a[(fSize + i) * size + fSize + j] = a22[i * fSize + j];
-    }
-  }
-}
-
-void strassen1(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result) {
-  double* t1 = new double[size * size * 2];
-  double* t2 = t1 + size * size;
-  int i;
-  int length = size * size;
-
-  for (i = 0; i < length; i++) {
-    t1[i] = a1[i] + a2[i];
-    t2[i] = b1[i] + b2[i];
-  }
-
-  strassenRecursivePart(size, t1, t2, result);
-
-  delete[] t1;
-}
-
-void strassen2(int size, const double* a1, const double* a2, const double* b,
-               double* result) {
-  double* t = new double[size * size];
-  int i;
-  int length = size * size;
-
-  for (i = 0; i < length; i++) {
-    t[i] = a1[i] + a2[i];
-  }
-
-  strassenRecursivePart(size, t, b, result);
-
-  delete[] t;
-}
-
-void strassen3(int size, const double* a, const double* b1, const double* b2,
-               double* result) {
-  double* t = new double[size * size];
-  int i;
-  int length = size * size;
-
-  for (i = 0; i < length; i++) {
-    t[i] = b1[i] - b2[i];
-  }
-
-  strassenRecursivePart(size, a, t, result);
-
-  delete[] t;
-}
-
-void strassen4(int size, const double* a1, const double* a2, const double* b1,
-               const double* b2, double* result) {
-  double* t1 = new double[size * size * 2];
-  double* t2 = t1 + size * size;
-  int i;
-  int length = size * size;
-
-  for (i = 0; i < length; i++) {
-    t1[i] = a1[i] - a2[i];
-    t2[i] = b1[i] + b2[i];
-  }
-
-  strassenRecursivePart(size, t1, t2, result);
-
-  delete[] t1;
-}
-
-void strassenRecursivePart(int size, const double* a, const double* b,
-                           double* result) {
-  if (size <= 128) {
-    multSeq(size, a, b, result);
-    return;
-  }
-  int qLength = size * size / 4;
-  int i;
-  double* a11 = new double[size * size];
-  double* a12 = a11 + qLength;
-  double* a21 = a12 + qLength;
-  double* a22 = a21 + qLength;
-  double* b11 = new double[size * size];
-  double* b12 = b11 + qLength;
-  double* b21 = b12 + qLength;
-  double* b22 = b21 + qLength;
-  double* c11 = new double[size * size];
-  double* c12 = c11 + qLength;
-  double* c21 = c12 + qLength;
-  double* c22 = c21 + qLength;
-  double* m1 = new double[qLength * 7];
-  double* m2 = m1 + qLength;
-  double* m3 = m2 + qLength;
-  double* m4 = m3 + qLength;
-  double* m5 = m4 + qLength;
-  double* m6 = m5 + qLength;
-  double* m7 = m6 + qLength;
-
-  splitMatrix(size, a, a11, a12, a21, a22);
-  splitMatrix(size, b, b11, b12, b21, b22);
-
-  // M1 = (A11 + A22)(B11 + B22)
-  //std::thread thread1([=] { strassen1(size / 2, a11, a22, b11, b22, m1); });
-  std::thread thread1(strassen1, size / 2, a11, a22, b11, b22, m1);
-
-  // M2 = (A21 + A22)B11
-  //std::thread thread2([=] { strassen2(size / 2, a21, a22, b11, m2); });
-  std::thread thread2(strassen2, size / 2, a21, a22, b11, m2);
-
-  // M3 = A11(B12 - B22)
-  //std::thread thread3([=] { strassen3(size / 2, a11, b12, b22, m3); });
-  std::thread thread3(strassen3, size / 2, a11, b12, b22, m3);
-
-  // M4 = A22(B21 - B11)
-  //std::thread thread4([=] { strassen3(size / 2, a22, b21, b11, m4); });
-  std::thread thread4(strassen3, size / 2, a22, b21, b11, m4);
-
-  // M5 = (A11 + A12)B22
-  //std::thread thread5([=] { strassen2(size / 2, a11, a12, b22, m5); });
-  std::thread thread5(strassen2, size / 2, a11, a12, b22, m5);
-
-  // M6 = (A21 - A11)(B11 + B12)
-  //std::thread thread6([=] { strassen4(size / 2, a21, a11, b11, b12, m6); });
-  std::thread thread6(strassen4, size / 2, a21, a11, b11, b12, m6);
-
-  // M7 = (A12 - A22)(B21 + B22)
-  //std::thread thread7([=] { strassen4(size / 2, a12, a22, b21, b22, m7); });
-  std::thread thread7(strassen4, size / 2, a12, a22, b21, b22, m7);
-
-  thread1.join();
-  thread2.join();
-  thread3.join();
-  thread4.join();
-  thread5.join();
-  thread6.join();
-  thread7.join();
-
-  // C11 = M1 + M4 - M5 + M7
-  for (i = 0; i < qLength; i++) {
-    c11[i] = m1[i] + m4[i] - m5[i] + m7[i];
-  }
-
-  // C12 = M3 + M5
-  for (i = 0; i < qLength; i++) {
-    c12[i] = m3[i] + m5[i];
-  }
-
-  // C21 = M2 + M4
-  for (i = 0; i < qLength; i++) {
-    c21[i] = m2[i] + m4[i];
-  }
-
-  // C22 = M1 - M2 + M3 + M6
-  for (i = 0; i < qLength; i++) {
-    c22[i] = m1[i] - m2[i] + m3[i] + m6[i];
-  }
-
-  assembleMatrix(size, result, c11, c12, c21, c22);
-
-  delete[] a11;
-  delete[] b11;
-  delete[] c11;
-  delete[] m1;
+size_t strassenWorkspaceSize(int size, int taskDepth) {
+  return parallelWorkspace(size, taskDepth);
 }
 
 void strassenMultStdThread(int size, const double* a, const double* b,
-                           double* result) {
-  if (powerOf2(size) < 0) {
+                           double* result, int taskDepth, int threads) {
+  if (powerOf2(size) < 0 || taskDepth < 0 || threads < 0) {
     throw std::invalid_argument("");
   }
+  if (threads == 0) {
+    threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+  }
 
-  strassenRecursivePart(size, a, b, result);
+  std::vector<double> arena(strassenWorkspaceSize(size, taskDepth));
+  TaskPool pool(threads);
+  strassenTask(size, ConstView(a, size), ConstView(b, size), {result, size},
+               taskDepth, arena.data(), &pool);
 }
@@ -3,7 +3,15 @@
 #ifndef MODULES_TASK_4_ZHIVAEV_A_STRASSEN_STD_THREAD_STRASSEN_STD_THREAD_H_
 #define MODULES_TASK_4_ZHIVAEV_A_STRASSEN_STD_THREAD_STRASSEN_STD_THREAD_H_
 
+#include <cstddef>
+
+// Number of doubles the Strassen recursion needs for temporaries; it is
+// allocated once per call and carved into blocks as the recursion goes
+size_t strassenWorkspaceSize(int size, int taskDepth = 2);
+
+// The seven sub-products are spawned on a work-stealing pool of threads
+// (hardware concurrency when 0) for the first taskDepth recursion levels
 void strassenMultStdThread(int size, const double* a, const double* b,
-                           double* result);
+                           double* result, int taskDepth = 2, int threads = 0);
 
 #endif  // MODULES_TASK_4_ZHIVAEV_A_STRASSEN_STD_THREAD_STRASSEN_STD_THREAD_H_